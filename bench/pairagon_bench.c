@@ -0,0 +1,655 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/*****************************************************************************\
+ pairagon_bench.c
+ Benchmark of the pair Viterbi decoders on synthetic spliced alignments
+
+ Every case is a cDNA and its gene drawn from the HMM's own parameters: match
+ columns from the Match pair table, gaps at the Match->Genomic and Match->CDna
+ rates, introns from the DonorU2, IntronU2, BranchU2, BrAccU2 and AccU2 models
+ and flanks from RGenomic1 and RGenomic2. The grid below varies the cDNA
+ length, the intron count and length and the seed fragmentation (HSPs per
+ exon, none for an unseeded trellis). Each case is written to the work
+ directory as fasta and seed files, read back the way pairagon reads them and
+ decoded by zRunPairViterbiAndForward ("full", pairagon, with the generated
+ kernel of zPairKernel.h), by zRunPairViterbiAndForward without it ("generic",
+ pairagon --nokernel, checked against the "full" golden file), with every
+ splice and branch point cell filled ("dense", pairagon --nosplice_prune,
+ checked likewise), in tiles on BENCH_TILE_THREADS threads ("tiled", pairagon
+ --tile_threads, checked likewise), followed by zRunPairBackward ("posteriors", pairagon --posteriors,
+ the alignment with its posterior column) and by zRunPairPosteriorDecoding too
+ ("mea", pairagon --decoder=mea --posteriors) and by
+ zRunPairViterbi ("tbtree", pairagon -o), each in a child process of its own
+ so that the peak RSS is that decoder's. One row per decoder reports
+
+	cells      hmm states x the cells of the seed blocks, see zCountBenchCells
+	seconds    CPU time of trellis set up and decoding, all threads together
+	cells/s
+	rss_kb     peak resident set of the child
+	allocs     zMalloc, zCalloc, zRealloc and zSliceAlloc calls, see zGetMemoryCounts
+	frees      the same, clean up of the trellis included
+	alloc_mb   megabytes they asked for
+	golden     the alignment (pairagon -i) against golden/<case>.<decoder>.pair
+
+ pairagon_bench [options] <pairagon.zhmm>
+	-golden=DIR  golden alignments, bench/golden by default
+	-work=DIR    case files and decoded alignments, bench/work by default
+	-update      write the alignments as the golden ones
+	-cases=all   the whole grid, only the small cases by default
+	-case=NAME   one case of the grid
+
+ The exit status is 1 if an alignment differs from its golden file, or if the
+ peak RSS of "posteriors" or "mea" is more than that of "full" plus
+ BENCH_POSTERIOR_RSS times the forward values of its cells (status "RSS"): the
+ Viterbi cells are garbage collected as in "full", and the backward pass frees
+ what it is done with.
+
+\*****************************************************************************/
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "ZOE.h"
+#include "zHardCoding.h"
+
+#define BENCH_SEED         20090501 /* of the sequence generator, same cases every run */
+#define BENCH_MIN_HSP      10       /* shorter ungapped runs make no seed HSP */
+#define BENCH_LINE         60       /* fasta line length */
+#define BENCH_TILE_THREADS 4        /* of the "tiled" decoder */
+#define BENCH_POSTERIOR_RSS 1.5     /* forward values "posteriors" and "mea" may hold on top of "full" */
+#define BENCH_MEA_THRESHOLD 0.01    /* of the "mea" decoder, pairagon's default */
+
+struct zBenchCase {
+	const char *name;
+	coor_t      cdna;      /* cDNA length */
+	int         introns;
+	coor_t      intron;    /* length of each intron */
+	coor_t      flank;     /* genomic sequence before and after the gene */
+	int         fragments; /* seed HSPs per exon, 0 for no seed */
+	bool        small;     /* run by default */
+};
+typedef struct zBenchCase zBenchCase;
+
+static const zBenchCase BENCH_CASES[] = {
+	/* name         cdna introns intron flank frags small */
+	{"exon",         400,  0,     0,   100,  1, true},
+	{"intron2",      600,  2,   500,   100,  1, true},
+	{"intron4",     1000,  4,   800,   200,  1, true},
+	{"frag3",       1000,  4,   800,   200,  3, true},
+	{"noseed",       200,  1,   300,    50,  0, true},
+	{"cdna2k",      2000,  4,   800,   200,  1, false},
+	{"cdna4k",      4000,  4,   800,   200,  1, false},
+	{"intron4k",    1000,  4,  4000,   200,  1, false},
+	{"intron16k",   1000,  4, 16000,   200,  1, false},
+	{"introns16",   2000, 16,   800,   200,  1, false},
+	{"frag8",       1000,  4,   800,   200,  8, false},
+	{"noseed2",      400,  2,   400,   100,  0, false},
+};
+
+#define BENCH_CASE_COUNT ((int)(sizeof(BENCH_CASES)/sizeof(BENCH_CASES[0])))
+
+/* What the generator draws from, read before zNullifyHMM */
+struct zBenchModels {
+	zModel         *match;     /* PAIR table */
+	zModel         *flank5;
+	zModel         *flank3;
+	zModel         *donor;
+	zModel         *intron;
+	zModel         *branch;
+	zModel         *bracc;
+	zModel         *acceptor;
+	zModel         *genomic;       /* genomic gap bases */
+	zModel         *cdna;          /* cDNA gap bases */
+	zDurationGroup *bracc_duration;
+	double          genomic_gap;   /* Match->Genomic */
+	double          cdna_gap;      /* Match->CDna */
+};
+typedef struct zBenchModels zBenchModels;
+
+/* A synthetic alignment, gpos[c] is the genomic position of cDNA base c, -1 in a cDNA gap */
+struct zBenchAlignment {
+	char   *genomic;
+	coor_t  glength;
+	char   *cdna;
+	coor_t  clength;
+	long   *gpos;
+	coor_t *exon_start; /* cDNA range of each exon */
+	coor_t *exon_end;
+	int     exons;
+};
+typedef struct zBenchAlignment zBenchAlignment;
+
+static const char BENCH_BASES[] = "ACGT";
+
+/*****************************************************************************\
+ Sequence generator
+\*****************************************************************************/
+
+static unsigned long RANDOM_STATE = BENCH_SEED;
+
+/* xorshift32, the same numbers wherever long is wider than 32 bits */
+static double zBenchRandom (void) {
+	RANDOM_STATE ^= (RANDOM_STATE << 13) & 0xffffffffUL;
+	RANDOM_STATE ^= RANDOM_STATE >> 17;
+	RANDOM_STATE ^= (RANDOM_STATE << 5) & 0xffffffffUL;
+	return (double)RANDOM_STATE/4294967296.0;
+}
+
+/* One of A, C, G, T (0..3) by the scores of a model row, N never */
+static int zSampleBase (const score_t *row) {
+	double weight[4], total = 0, r;
+	int    s;
+
+	for (s = 0; s < 4; s++) {
+		weight[s] = (row[s] > MIN_SCORE) ? zScore2Float(row[s]) : 0;
+		total    += weight[s];
+	}
+	if (total <= 0) zDie("model row without an A, C, G or T");
+	r = zBenchRandom()*total;
+	for (s = 0; s < 3 && r >= weight[s]; s++) r -= weight[s];
+	return s;
+}
+
+/* A match column from the 5x5 pair table, genomic base in *g, cDNA base in *c */
+static void zSamplePair (zModel *match, int *g, int *c) {
+	score_t row[4];
+	int     i;
+
+	/* the genomic base by its row total, then the cDNA base from its row */
+	for (i = 0; i < 4; i++) {
+		row[i] = zFloat2Score(zScore2Float(match->data[i*match->symbols])
+		                    + zScore2Float(match->data[i*match->symbols + 1])
+		                    + zScore2Float(match->data[i*match->symbols + 2])
+		                    + zScore2Float(match->data[i*match->symbols + 3]));
+	}
+	*g = zSampleBase(row);
+	*c = zSampleBase(&match->data[*g*match->symbols]);
+}
+
+static zModel* zGetBenchModel (zHMM *hmm, const char *name) {
+	zModel *model = hmm->mmap[zChar2StrIdx(name)];
+
+	if (model == NULL) zDie("no %s model in the HMM", name);
+	return model;
+}
+
+static double zGetBenchTransition (zHMM *hmm, const char *from, const char *to) {
+	int f = zGetStateByName(hmm, from), t = zGetStateByName(hmm, to);
+
+	if (f < 0 || t < 0) zDie("no %s->%s transition in the HMM", from, to);
+	return zScore2Float(zGetTransitionScore(hmm, f, t, 0));
+}
+
+static void zInitBenchModels (zHMM *hmm, zBenchModels *m) {
+	int bracc = zGetStateByName(hmm, "BrAccU2");
+
+	if (bracc < 0) zDie("no BrAccU2 state in the HMM");
+	m->match          = zGetBenchModel(hmm, "Match");
+	m->flank5         = zGetBenchModel(hmm, "RGenomic1");
+	m->flank3         = zGetBenchModel(hmm, "RGenomic2");
+	m->donor          = zGetBenchModel(hmm, "DonorU2");
+	m->intron         = zGetBenchModel(hmm, "IntronU2");
+	m->branch         = zGetBenchModel(hmm, "BranchU2");
+	m->bracc          = zGetBenchModel(hmm, "BrAccU2");
+	m->acceptor       = zGetBenchModel(hmm, "AccU2");
+	m->genomic        = zGetBenchModel(hmm, "Genomic");
+	m->cdna           = zGetBenchModel(hmm, "CDna");
+	m->bracc_duration = hmm->dmap[hmm->state[bracc].duration];
+	m->genomic_gap    = zGetBenchTransition(hmm, "Match", "Genomic");
+	m->cdna_gap       = zGetBenchTransition(hmm, "Match", "CDna");
+	if (m->match->symbols != 5 || m->match->type != LUT) zDie("Match is not a 5x5 pair table");
+}
+
+static void zPushGenomic (zBenchAlignment *a, int s) {
+	a->genomic[a->glength++] = BENCH_BASES[s];
+}
+
+/* length bases from an order 0 LUT */
+static void zSampleLUT (zBenchAlignment *a, zModel *model, coor_t length) {
+	coor_t i;
+	for (i = 0; i < length; i++) zPushGenomic(a, zSampleBase(model->data));
+}
+
+/* One base from every row of a WMM */
+static void zSampleWMM (zBenchAlignment *a, zModel *model, coor_t rows) {
+	coor_t i;
+	for (i = 0; i < rows; i++) zPushGenomic(a, zSampleBase(&model->data[i*model->symbols]));
+}
+
+/* Length of the branch point to acceptor stretch, within the first (DEFINED) *
+ * distribution of its duration                                               */
+static coor_t zSampleBrAccLength (zDurationGroup *group) {
+	zDuration *d = &group->duration[0];
+	double     total = 0, r;
+	coor_t     length, max = d->distribution[0].end;
+
+	for (length = d->distribution[0].start; length <= max; length++) {
+		total += zScore2Float(zScoreDuration(d, length));
+	}
+	r = zBenchRandom()*total;
+	for (length = d->distribution[0].start; length < max; length++) {
+		r -= zScore2Float(zScoreDuration(d, length));
+		if (r < 0) break;
+	}
+	return length;
+}
+
+/* Donor, intron body, branch point, BrAcc stretch and acceptor, the last *
+ * ending in AG, which the AccU2 model leaves to the splice site scanner  */
+static void zSampleIntron (zBenchAlignment *a, zBenchModels *m, coor_t length) {
+	coor_t bracc = zSampleBrAccLength(m->bracc_duration);
+	coor_t fixed = m->donor->length + m->branch->length + bracc + m->acceptor->length;
+
+	if (length < fixed + 1) zDie("intron of %u bases is shorter than its splice signals", length);
+	zSampleWMM(a, m->donor, m->donor->length);
+	zSampleLUT(a, m->intron, length - fixed);
+	zSampleWMM(a, m->branch, m->branch->length);
+	zSampleLUT(a, m->bracc, bracc);
+	zSampleWMM(a, m->acceptor, m->acceptor->length - 2);
+	zPushGenomic(a, 0);
+	zPushGenomic(a, 2);
+}
+
+/* Match columns with single base gaps at the HMM's rates, never at the exon ends */
+static void zSampleExon (zBenchAlignment *a, zBenchModels *m, coor_t length) {
+	coor_t start = a->clength;
+	double r;
+	int    g, c;
+
+	while (a->clength < start + length) {
+		r = zBenchRandom();
+		if (a->clength > start && a->clength + 1 < start + length && r < m->genomic_gap) {
+			zPushGenomic(a, zSampleBase(m->genomic->data));
+		} else if (a->clength > start && a->clength + 1 < start + length && r < m->genomic_gap + m->cdna_gap) {
+			a->gpos[a->clength]   = -1;
+			a->cdna[a->clength++] = BENCH_BASES[zSampleBase(m->cdna->data)];
+		} else {
+			zSamplePair(m->match, &g, &c);
+			a->gpos[a->clength]   = a->glength;
+			a->cdna[a->clength++] = BENCH_BASES[c];
+			zPushGenomic(a, g);
+		}
+	}
+}
+
+static void zSampleBenchAlignment (const zBenchCase *bc, zBenchModels *m, zBenchAlignment *a) {
+	coor_t size = 2*bc->flank + bc->introns*bc->intron + 2*bc->cdna + 1;
+	coor_t exon;
+	int    e;
+
+	a->genomic    = zMalloc(size + 1, "zSampleBenchAlignment genomic");
+	a->cdna       = zMalloc(bc->cdna + 1, "zSampleBenchAlignment cdna");
+	a->gpos       = zMalloc(bc->cdna*sizeof(long), "zSampleBenchAlignment gpos");
+	a->exons      = bc->introns + 1;
+	a->exon_start = zMalloc(a->exons*sizeof(coor_t), "zSampleBenchAlignment exon_start");
+	a->exon_end   = zMalloc(a->exons*sizeof(coor_t), "zSampleBenchAlignment exon_end");
+	a->glength    = 0;
+	a->clength    = 0;
+
+	zSampleLUT(a, m->flank5, bc->flank);
+	for (e = 0; e < a->exons; e++) {
+		exon = (e < a->exons - 1) ? bc->cdna/a->exons : bc->cdna - e*(bc->cdna/a->exons);
+		if (e > 0) zSampleIntron(a, m, bc->intron);
+		a->exon_start[e] = a->clength;
+		zSampleExon(a, m, exon);
+		a->exon_end[e] = a->clength - 1;
+	}
+	zSampleLUT(a, m->flank3, bc->flank);
+	a->genomic[a->glength] = '\0';
+	a->cdna[a->clength]    = '\0';
+}
+
+static void zFreeBenchAlignment (zBenchAlignment *a) {
+	zFree(a->genomic);
+	zFree(a->cdna);
+	zFree(a->gpos);
+	zFree(a->exon_start);
+	zFree(a->exon_end);
+}
+
+/* The longest ungapped run of each of fragments pieces of every exon, 1 based */
+static void zMakeBenchSeed (const zBenchCase *bc, zBenchAlignment *a, zSeedAlignment *seed) {
+	coor_t from, to, c, run, best, best_end;
+	int    e, f;
+
+	seed->def      = zMalloc(strlen(bc->name) + 2, "zMakeBenchSeed def");
+	sprintf(seed->def, ">%s", bc->name);
+	seed->contig   = NULL;
+	seed->strand   = '+';
+	seed->gb_start = 1;
+	seed->gb_end   = a->glength;
+	seed->hsps     = 0;
+	seed->hsp      = zMalloc(a->exons*bc->fragments*sizeof(zHSP), "zMakeBenchSeed hsp");
+
+	for (e = 0; e < a->exons; e++) {
+		for (f = 0; f < bc->fragments; f++) {
+			from = a->exon_start[e] + f*(a->exon_end[e] - a->exon_start[e] + 1)/bc->fragments;
+			to   = a->exon_start[e] + (f+1)*(a->exon_end[e] - a->exon_start[e] + 1)/bc->fragments;
+			best = run = 0;
+			best_end = from;
+			for (c = from; c < to; c++) {
+				if (a->gpos[c] < 0) {
+					run = 0;
+				} else if (run > 0 && a->gpos[c] == a->gpos[c-1] + 1) {
+					run++;
+				} else {
+					run = 1;
+				}
+				if (run > best) {
+					best     = run;
+					best_end = c;
+				}
+			}
+			if (best < BENCH_MIN_HSP) continue;
+			seed->hsp[seed->hsps].c_start = best_end - best + 2;
+			seed->hsp[seed->hsps].c_end   = best_end + 1;
+			seed->hsp[seed->hsps].g_start = a->gpos[best_end] - best + 2;
+			seed->hsp[seed->hsps].g_end   = a->gpos[best_end] + 1;
+			seed->hsps++;
+		}
+	}
+}
+
+static void zWriteBenchFasta (const char *filename, const char *name, const char *seq, coor_t length) {
+	FILE   *stream;
+	coor_t  i;
+
+	if ((stream = fopen(filename, "w")) == NULL) zDie("can't write %s", filename);
+	fprintf(stream, ">%s\n", name);
+	for (i = 0; i < length; i += BENCH_LINE) {
+		fprintf(stream, "%.*s\n", (int)MIN(BENCH_LINE, length - i), seq + i);
+	}
+	if (fclose(stream) != 0) zDie("can't write %s", filename);
+}
+
+/* Case files <work>/<case>.genomic.fa, .cdna.fa and .seed, returns the genomic length */
+static coor_t zWriteBenchCase (const zBenchCase *bc, zBenchModels *m, const char *work) {
+	zBenchAlignment  a;
+	zSeedAlignment   seed;
+	char             filename[FILENAME_MAX], name[256];
+	FILE            *stream;
+	coor_t           length;
+
+	zSampleBenchAlignment(bc, m, &a);
+
+	sprintf(name, "%s_genomic", bc->name);
+	sprintf(filename, "%s/%s.genomic.fa", work, bc->name);
+	zWriteBenchFasta(filename, name, a.genomic, a.glength);
+	sprintf(filename, "%s/%s.cdna.fa", work, bc->name);
+	zWriteBenchFasta(filename, bc->name, a.cdna, a.clength);
+
+	if (bc->fragments > 0) {
+		zMakeBenchSeed(bc, &a, &seed);
+		sprintf(filename, "%s/%s.seed", work, bc->name);
+		if ((stream = fopen(filename, "w")) == NULL) zDie("can't write %s", filename);
+		zWriteSeedAlignment(stream, &seed);
+		if (fclose(stream) != 0) zDie("can't write %s", filename);
+		zFreeSeedAlignment(&seed);
+	}
+	length = a.glength;
+	zFreeBenchAlignment(&a);
+	return length;
+}
+
+/*****************************************************************************\
+ Decoding
+\*****************************************************************************/
+
+/* States x cells of the memory blocks, the "stepping stone" area both decoders cover */
+static double zCountBenchCells (zPairTrellis *trellis) {
+	coor_t  glast = trellis->genomic->length - trellis->padding - 1;
+	coor_t  clast = trellis->cdna->length - trellis->padding - 1;
+	double  area = 0;
+	int     i;
+
+	for (i = 0; i < trellis->mem_blocks->hsps; i++) {
+		zHSP *block = &trellis->mem_blocks->hsp[i];
+		area += (double)(MIN(block->g_end, glast) - MAX(block->g_start, trellis->blocks->gb_start) + 1)
+		      * (MIN(block->c_end, clast) - MAX(block->c_start, trellis->padding) + 1);
+	}
+	return area*trellis->hmm->states;
+}
+
+static double zBenchSeconds (void) {
+	struct rusage ru;
+
+	getrusage(RUSAGE_SELF, &ru);
+	return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec)/1e6;
+}
+
+/* Child side: decode one case with one decoder, write the alignment to  *
+ * <work>/<case>.<decoder>.pair and the numbers of its row to row         */
+static void zRunBenchDecoder (const zBenchCase *bc, zHMM *hmm, const char *decoder, const char *work, char *row) {
+	zDNA            genomic;
+	zVec            cdnas;
+	zSeedAlignment *seed = NULL;
+	zPairTrellis    trellis;
+	zAFVec         *afv, *mea;
+	zMemoryCounts   before, after;
+	struct rusage   ru;
+	char            filename[FILENAME_MAX];
+	FILE           *stream;
+	score_t         score;
+	double          start, seconds, cells;
+
+	sprintf(filename, "%s/%s.genomic.fa", work, bc->name);
+	zInitDNA(&genomic);
+	zLoadDNAFromFasta(&genomic, filename, NULL);
+	zSetDNAPadding(&genomic, PADDING);
+	sprintf(filename, "%s/%s.cdna.fa", work, bc->name);
+	zInitVec(&cdnas, 1);
+	if (zLoadMultiDNAFromMultiFasta(&cdnas, filename, NULL) != 1) zDie("%s is not one cDNA", filename);
+	if (bc->fragments > 0) {
+		sprintf(filename, "%s/%s.seed", work, bc->name);
+		if ((stream = fopen(filename, "r")) == NULL) zDie("seed alignment file error (%s)", filename);
+		seed = zMalloc(sizeof(zSeedAlignment), "zRunBenchDecoder seed");
+		if (zReadSeedAlignment(stream, seed) == -1) zDie("no seed alignment in %s", filename);
+		fclose(stream);
+	}
+	zSetHMMStrand(hmm, '+');
+
+	zGetMemoryCounts(&before);
+	start = zBenchSeconds();
+	zInitPairTrellis(&trellis, seed, &genomic, (zDNA*)cdnas.elem[0], hmm);
+	if (strcmp(decoder, "generic") == 0) trellis.specialize = false;
+	if (strcmp(decoder, "dense") == 0) trellis.splice_prune = false;
+	if (strcmp(decoder, "tiled") == 0) trellis.tile_threads = BENCH_TILE_THREADS;
+	cells = zCountBenchCells(&trellis);
+	if (strcmp(decoder, "posteriors") == 0) trellis.posteriors = true;
+	if (strcmp(decoder, "mea") == 0) {
+		trellis.posteriors    = true;
+		trellis.mea_threshold = BENCH_MEA_THRESHOLD;
+	}
+	if (strcmp(decoder, "tbtree") == 0) {
+		afv = zRunPairViterbi(&trellis, &score);
+	} else {
+		afv = zRunPairViterbiAndForward(&trellis, &score);
+	}
+	if (trellis.posteriors) zRunPairBackward(&trellis, afv);
+	if (trellis.mea_threshold > 0 && (mea = zRunPairPosteriorDecoding(&trellis, &score)) != NULL) {
+		zFreeAFVec(afv);
+		zFree(afv);
+		afv = mea;
+		zComputePosteriorProbability(&trellis, afv);
+	}
+	seconds = zBenchSeconds() - start;
+	getrusage(RUSAGE_SELF, &ru);
+
+	/* while the trellis still owns the sequences the features point into */
+	sprintf(filename, "%s/%s.%s.pair", work, bc->name, decoder);
+	if ((stream = fopen(filename, "w")) == NULL) zDie("can't write %s", filename);
+	zWriteAFVec(stream, afv, 0, 0);
+	if (fclose(stream) != 0) zDie("can't write %s", filename);
+	zFreeAFVec(afv);
+	zFree(afv);
+	zFreePairTrellis(&trellis);
+	zGetMemoryCounts(&after);
+
+	sprintf(row, "%.0f\t%.3f\t%.3g\t%ld\t%lu\t%lu\t%.1f", cells, seconds, (seconds > 0) ? cells/seconds : 0,
+			ru.ru_maxrss,
+			(after.mallocs + after.callocs + after.reallocs + after.slices) - (before.mallocs + before.callocs + before.reallocs + before.slices),
+			after.frees - before.frees, (after.bytes - before.bytes)/1048576.0);
+}
+
+/* The row of one decoder, from a child of its own. False if the child failed */
+static bool zForkBenchDecoder (const zBenchCase *bc, zHMM *hmm, const char *decoder, const char *work, char *row, int size) {
+	int      fd[2], status;
+	pid_t    pid;
+	ssize_t  n;
+	int      length = 0;
+	bool     ok;
+
+	if (pipe(fd) != 0) zDie("zForkBenchDecoder: pipe failed");
+	fflush(stdout);
+	fflush(stderr);
+	if ((pid = fork()) < 0) zDie("zForkBenchDecoder: fork failed");
+	if (pid == 0) {
+		close(fd[0]);
+		zRunBenchDecoder(bc, hmm, decoder, work, row);
+		if (write(fd[1], row, strlen(row)) != (ssize_t)strlen(row)) _exit(1);
+		_exit(0);
+	}
+	close(fd[1]);
+	while (length < size - 1 && (n = read(fd[0], row + length, size - 1 - length)) > 0) length += n;
+	close(fd[0]);
+	row[length] = '\0';
+	ok = (length > 0);
+	if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = false;
+	return ok;
+}
+
+/*****************************************************************************\
+ Golden alignments
+\*****************************************************************************/
+
+/* True if the two files hold the same bytes, a missing file matches nothing */
+static bool zSameBenchFiles (const char *a, const char *b) {
+	FILE *fa, *fb;
+	int   ca, cb;
+
+	if ((fa = fopen(a, "r")) == NULL) return false;
+	if ((fb = fopen(b, "r")) == NULL) {
+		fclose(fa);
+		return false;
+	}
+	do {
+		ca = fgetc(fa);
+		cb = fgetc(fb);
+	} while (ca == cb && ca != EOF);
+	fclose(fa);
+	fclose(fb);
+	return ca == cb;
+}
+
+static void zCopyBenchFile (const char *from, const char *to) {
+	FILE   *in, *out;
+	char    buffer[4096];
+	size_t  n;
+
+	if ((in = fopen(from, "r")) == NULL) zDie("can't read %s", from);
+	if ((out = fopen(to, "w")) == NULL) zDie("can't write %s", to);
+	while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) fwrite(buffer, 1, n, out);
+	fclose(in);
+	if (fclose(out) != 0) zDie("can't write %s", to);
+}
+
+/*****************************************************************************\
+ Main
+\*****************************************************************************/
+
+static void usage (void) {
+	fprintf(stderr, "usage: %s [options] <pairagon.zhmm>\n", zGetProgramName());
+	fprintf(stderr, "\t-golden=DIR  golden alignments (bench/golden)\n");
+	fprintf(stderr, "\t-work=DIR    case files and decoded alignments (bench/work)\n");
+	fprintf(stderr, "\t-update      write the alignments as the golden ones\n");
+	fprintf(stderr, "\t-cases=all   the whole grid, not only the small cases\n");
+	fprintf(stderr, "\t-case=NAME   one case of the grid\n");
+	exit(1);
+}
+
+int main (int argc, char *argv[]) {
+	static const char *decoders[] = {"full", "generic", "dense", "tiled", "posteriors", "mea", "tbtree"};
+	static const char *goldens[]  = {"full", "full", "full", "full", "posteriors", "mea", "tbtree"};
+	zHMM           hmm;
+	zBenchModels   models;
+	FILE          *stream;
+	const char    *golden, *work;
+	char           row[1024], output[FILENAME_MAX], expected[FILENAME_MAX];
+	const char    *status;
+	coor_t         glength[BENCH_CASE_COUNT];
+	bool           all, update;
+	double         cells, limit = 0;
+	long           rss;
+	int            i, d, failures = 0, runs = 0;
+
+	zSetProgramName(argv[0]);
+	zParseOptions(&argc, argv);
+	zRegisterPairKernels();
+	if (argc != 2 || zOption("h") || zOption("-help")) usage();
+
+	golden = (zOption("golden") != NULL) ? zOption("golden") : "bench/golden";
+	work   = (zOption("work")   != NULL) ? zOption("work")   : "bench/work";
+	update = (zOption("update") != NULL);
+	all    = (zOption("cases")  != NULL && strcmp(zOption("cases"), "all") == 0);
+	if (zOption("cases") != NULL && !all && strcmp(zOption("cases"), "small") != 0) {
+		zDie("-cases is small or all (%s)", zOption("cases"));
+	}
+	if (mkdir(work, 0777) != 0 && errno != EEXIST) zDie("can't make the work directory %s", work);
+	if (update && mkdir(golden, 0777) != 0 && errno != EEXIST) zDie("can't make the golden directory %s", golden);
+
+	if ((stream = fopen(argv[1], "r")) == NULL) zDie("hmm file error (%s)", argv[1]);
+	if (!zReadHMM(stream, &hmm, GPAIRHMM)) zDie("error reading hmm");
+	fclose(stream);
+
+	/* the cases come from the HMM as written, the decoders get the NULL model as in pairagon */
+	zInitBenchModels(&hmm, &models);
+	for (i = 0; i < BENCH_CASE_COUNT; i++) {
+		glength[i] = zWriteBenchCase(&BENCH_CASES[i], &models, work);
+	}
+	if (!zNullifyHMM(&hmm)) zDie("Cannot process NULL model");
+
+	printf("# case\tgenomic\tcdna\tintrons\tfrags\tdecoder\tcells\tseconds\tcells/s\trss_kb\tallocs\tfrees\talloc_mb\tgolden\n");
+	for (i = 0; i < BENCH_CASE_COUNT; i++) {
+		const zBenchCase *bc = &BENCH_CASES[i];
+
+		if (zOption("case") != NULL ? strcmp(zOption("case"), bc->name) != 0 : !(all || bc->small)) continue;
+		limit = 0;
+		for (d = 0; d < 7; d++) {
+			runs++;
+			sprintf(output, "%s/%s.%s.pair", work, bc->name, decoders[d]);
+			sprintf(expected, "%s/%s.%s.pair", golden, bc->name, goldens[d]);
+			if (!zForkBenchDecoder(bc, &hmm, decoders[d], work, row, sizeof(row))) {
+				strcpy(row, "-\t-\t-\t-\t-\t-\t-");
+				status = "FAILED";
+				failures++;
+			} else if (update && strcmp(decoders[d], goldens[d]) == 0) {
+				zCopyBenchFile(output, expected);
+				status = "updated";
+			} else if (zSameBenchFiles(output, expected)) {
+				status = "ok";
+			} else {
+				status = "DIFFERS";
+				failures++;
+			}
+			if (sscanf(row, "%lf %*s %*s %ld", &cells, &rss) != 2) cells = rss = 0;
+			if (strcmp(decoders[d], "full") == 0) limit = rss + BENCH_POSTERIOR_RSS*cells*sizeof(score_t)/1024;
+			if ((strcmp(decoders[d], "posteriors") == 0 || strcmp(decoders[d], "mea") == 0) && limit > 0 && rss > limit) {
+				if (strcmp(status, "ok") == 0 || strcmp(status, "updated") == 0) failures++;
+				status = "RSS";
+			}
+			printf("%s\t%u\t%u\t%d\t%d\t%s\t%s\t%s\n", bc->name, glength[i], bc->cdna, bc->introns, bc->fragments, decoders[d], row, status);
+			fflush(stdout);
+		}
+	}
+	if (runs == 0) zDie("no case %s", zOption("case"));
+	if (failures > 0) fprintf(stderr, "%d of %d alignments failed, differ from %s or took too much memory\n", failures, runs, golden);
+
+	zFreeHMM(&hmm);
+	zFreeOptions();
+	zStringPoolFree();
+	return (failures > 0) ? 1 : 0;
+}
@@ -33,7 +33,7 @@ if(!$targetfn || !$queryfn || !$outputdir || $help){
     print 
 	"Usage: $0 {-t target_file} {-q query_file} \n".
 	"          {-o output_dir} [-p prefix] \n".
-	"          [-a (GMap | seed_alignment)]\n".
+	"          [-a (auto | GMap | seed_alignment)]\n".
 	"          [-cross] [-vulgar] [-gtf] [-gff]\n".
 	"          [-psl] [-alignment]\n".
 	"          [output params]\n\n".
@@ -41,6 +41,7 @@ if(!$targetfn || !$queryfn || !$outputdir || $help){
 	"    -q         Query/cDNA fasta filename\n".
 	"    -o         Output directory\n".
 	"    -p         Prefix for output files. Default is query filename.\n".
+	"    -a auto    Let pairagon find the seed alignment itself\n".
 	"    -a GMap    Use GMap to generate seed alignment\n".
 	"    -a aln     Use the alignment with filename aln for a seed.\n".
 	"    -cross     Use cross species parameter\n".
@@ -64,7 +65,9 @@ my $seedfile = "$outputdir/$prefix.seed";
 my $pairfile = "$outputdir/$prefix.pair";
 my $seedflag = "";
 
-if($seed){
+if($seed && $seed eq "auto"){
+    $seedflag = "--seed=auto";
+}elsif($seed){
     my $seedCmd;
     $_ = $seed;
     if(/GMap/i){
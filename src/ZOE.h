@@ -19,16 +19,22 @@ individual header files for documentation and the test programs for examples.
 #include "zDNA.h"
 #include "zFastaFile.h"  
 #include "zFeatureFactory.h"
+#include "zGenomeIndex.h"
 #include "zGTF.h"
 #include "zHMM.h"
 #include "zHMM_State.h"
 #include "zMath.h"  
 #include "zModel.h"  
+#include "zPairKernel.h"
+#include "zPairSplice.h"
+#include "zPairTile.h"
 #include "zPairTransition.h"
 #include "zPairTrellis.h"
+#include "zPairWavefront.h"
 #include "zPhasePref.h"
 #include "zProtein.h"  
 #include "zScanner.h" 
+#include "zSeedSearch.h"
 #include "zSfeature.h"
 #include "zTBTree.h"
 #include "zTools.h"
@@ -12,15 +12,99 @@
 #include <libgen.h>
 #include <time.h>
 #include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <poll.h>
 #include "ZOE.h"
 #include "zHardCoding.h"
 
 /* Auxiliary functions and structures, used only inside this file */
+
+/* One (cDNA entry, alignment_mode, splice_mode) combination to align */
+struct zPairagonJob {
+	int       entry;
+	int       amode;
+	int       smode;
+	int       twin;    /* the reverse job decoded in this one's sweep, -1 if none */
+	bool      riding;  /* decoded in the sweep of a forward twin, never run by itself */
+	score_t   score;
+	double    time;    /* CPU seconds spent on this job */
+	char     *text;    /* the alignment, rendered the way it goes to stdout */
+	size_t    length;
+	bool      done;
+};
+typedef struct zPairagonJob zPairagonJob;
+
+struct zPairagonEntry {
+	int       first_job;
+	int       jobs;
+	strand_t  strand;  /* seed strand, UNDEFINED_STRAND without a seed */
+	bool      empty;   /* empty seed alignment, nothing to align */
+	zDNA     *genomic; /* the contig its seed names */
+};
+typedef struct zPairagonEntry zPairagonEntry;
+
+/* The genomic sequences by name. A contig is loaded the first time a seed *
+ * names it and kept for the cDNAs after it. A genome index has the names  *
+ * of all its contigs up front; a fasta file is read up to the one asked   *
+ * for, so a large multi-fasta genome is better given as a genome index.   */
+struct zPairagonContig {
+	int    number;  /* in the genome index, -1 for a fasta record */
+	zDNA  *dna;     /* NULL until a seed names it */
+};
+typedef struct zPairagonContig zPairagonContig;
+
+struct zPairagonGenome {
+	char           *filename;
+	zGenomeIndex   *index;    /* NULL for a fasta file */
+	zDNAIterator   *fasta;    /* fasta records after the last one read */
+	zVec            contigs;  /* zPairagonContig*, in file order */
+	zHash           names;    /* seqname -> zPairagonContig*, the first of that name */
+};
+typedef struct zPairagonGenome zPairagonGenome;
+
+/* Everything the jobs share. Workers only ever read it, so after fork() the *
+ * genomic sequence and the HMM stay shared with the parent page for page     */
+struct zPairagonRun {
+	zHMM           *hmm;
+	zPairagonGenome *genome;
+	zKmerIndex     *kmers;      /* first contig, for --prune_modes */
+	zPairScannerCache scanners; /* genomic scanners the jobs of a locus share */
+	zDNA          **multi_cdna;
+	zVec           *multi_seed_vec;
+	bool            optimized_mode;
+	int             entries;
+	zPairagonEntry *entry;
+	int             jobs;
+	zPairagonJob   *job;
+	int             next_entry; /* first entry not written to stdout yet */
+};
+typedef struct zPairagonRun zPairagonRun;
+
+void    zOpenPairagonGenome(zPairagonGenome *genome, char *filename);
+zDNA*   zGetPairagonContig(zPairagonGenome *genome, const char *name);
+void    zClosePairagonGenome(zPairagonGenome *genome);
 void    zWriteGlobalHeaders(FILE* outfile, char* full_command_line,char* parameter_file_name, char* time_string);
 void    zWriteLocalHeaders(FILE* stream, zDNA* genomic, zDNA* cdna, int amode, int smode, double time, score_t score);
+void    zPlanPairagonRun(zPairagonRun *run, int cdna_entries, int *alignment_mode);
+void    zPairSweepJobs(zPairagonRun *run, zPairagonEntry *entry);
+void    zAlignPairagonEntries(zPairagonRun *run, int cdna_entries, int *alignment_mode, int threads);
+zSeedAlignment* zGetNextSeedAlignment(FILE *stream, zKmerIndex *index, zDNA *cdna);
+void    zFreePairagonRun(zPairagonRun *run);
+void    zRunPairagonJob(zPairagonRun *run, zPairagonJob *job);
+void    zDecodePairagonJob(zPairagonRun *run, zPairagonJob *job, zPairTrellis *trellis, zSeedAlignment *seed, zDNA *cdna);
+void    zWritePairagonEntries(zPairagonRun *run);
+void    zRunWorkerPool(zPairagonRun *run, int workers);
+void    zSetTrellisOptions(zPairTrellis *trellis);
+void    zVerifyCompactCells(zPairagonRun *run, zPairagonJob *job, zSeedAlignment *seed, zDNA *cdna, zAFVec *afv);
 
 #define zGetAlignmentModeString(a) ((a==FORWARD)?"forward":"reversed")
 #define zGetSpliceModeString(a)    ((a==FORWARD)?"forward":"REVERSED")
+#define zIsMEADecoder()            (zOption("-decoder") != NULL && strcmp(zOption("-decoder"), "mea") == 0)
+
+#define STREAM_BATCH 4 /* cDNA entries read per worker at a time with --stream */
+#define MEA_THRESHOLD 0.01 /* default --mea_threshold */
+#define PRUNE_MODES_RATIO 4 /* --prune_modes skips an orientation with 4 times less k-mer chain coverage */
 
 extern int optind;                 /* from <unistd.h> */
 extern int FORWARD, REVERSE, BOTH; /* 01, 10, 11 from zAlnFeature.c */
@@ -43,28 +127,47 @@ void print_help() {
 
 	puts("");
 	puts("Usage:");
-	puts("    pairagon [--alignment_mode={forward|reverse|both}] [--splice_mode={forward|reverse|both|cdna}] [--seed=file] [-i] [--nonull] hmm_file cdna_file genomic_file");
+	puts("    pairagon [--alignment_mode={forward|reverse|both}] [--splice_mode={forward|reverse|both|cdna}] [--seed={file|auto}] [-i] [-o] [--nonull] [--noarena] [--nowavefront] [--nokernel] [--nosplice_prune] [--band=W] [--checkpoint] [--verify_compact] [--threads=N] [--tile_threads=N] [--stream] [--prune_modes] [--shared_sweep] [--posteriors] [--decoder={viterbi|mea}] [--mea_threshold=P] [--beam=X] [--beam_retry] hmm_file cdna_file genomic_file");
 	puts("");
 	printf("Arguments:\n%s\n%s\n%s\n",
 		"    hmm_file          - file containing the pairHMM model specification",
 		"    cdna_file         - input cDNA sequence in Fasta format",
-		"    genomic_file      - input genomic sequence in Fasta format");
+		"    genomic_file      - input genomic sequence(s) in Fasta format, or their index from pairagon-index");
 
 	/* Options */
 	puts("");
-	printf("Options:\n%s\n%s\n%s\n%s\n%s\n",
+	printf("Options:\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n",
 		"	--alignment_mode - direction of the cDNA sequence to consider (default:both)",
 		"	--splice_mode    - direction of sense in the genomic sequence (default:cdna)",
 		"	 -i              - output the state sequence rather than the est_genome style output (default:false)",
 		"	--nonull         - do not use the null model, if present in the parameter file (default:false)",
-	        "	--seed=<file>    - use the seed alignments defined in <file> for Stepping Stone algorithm");
+	        "	--seed=<file>    - use the seed alignments defined in <file> for Stepping Stone algorithm",
+		"	--seed=auto      - find the seed alignments with a k-mer search of the (first) genomic sequence instead",
+		"	 -o              - use the memory optimized Treeterbi decoding (default:false)",
+		"	--noarena        - allocate trellis cells one at a time instead of one arena per block (default:false)",
+		"	--nowavefront    - run the scalar Viterbi sweep instead of the anti-diagonal kernel (default:false)",
+		"	--nokernel       - use the generic Viterbi sweep even if a kernel was generated for the HMM, see zPairKernel.h (default:false)",
+		"	--nosplice_prune - fill the splice and branch point cells that splice sites rule out as well, see zPairSplice.h (default:false)",
+		"	--band=W         - with --seed and without -o, only fill W diagonals either side of each seed HSP, widening as needed (default:off)",
+		"	--checkpoint     - without --seed, -o, --posteriors and --decoder=mea, hold only checkpoint rows of the trellis and recompute the rest for the traceback (default:false)",
+		"	--verify_compact - without -o, align again with float cell scores as a COMPACT_CELL build would and report path differences on stderr (default:false)",
+		"	--threads=N      - align cDNA entries and modes in N worker processes, output stays in input order (default:1)",
+		"	--tile_threads=N - without -o, fill each block of a trellis in tiles on N threads, for one long alignment, see zPairTile.h (default:1)",
+		"	--stream         - read the cDNA entries and seed alignments a few at a time instead of all up front (default:false)",
+		"	--prune_modes    - with alignment_mode both, skip the cDNA orientation that k-mer chains on the genomic hardly support (default:false)",
+		"	--shared_sweep   - without --seed, decode both cDNA orientations of a splice_mode on one trellis, sharing its genomic scanners (default:false)",
+		"	--posteriors     - with -i and without -o, add the posterior probability of each feature from forward and backward sums (default:false)",
+		"	--decoder=mea    - without -o, output the maximum expected accuracy alignment over the cells of high posterior instead of the Viterbi one (default:viterbi)",
+		"	--mea_threshold=P - posterior a cell needs to be on the --decoder=mea alignment (default:0.01)",
+		"	--beam=X         - with -o, drop the cells more than X below the best one of their genomic position and report how many (default:off)",
+		"	--beam_retry     - with --beam, decode again without it when the alignment changes state at a cell less than X/2 above the ones dropped (default:false)");
 	/* Pin file format */
 	puts("");
 	printf("%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n",
 		"Format of a seed alignment file: ", 
 		"",
 		">cdna_seq_description", 
-		"genomic_boundary_start=<start_position> genomic_boundary_end=<end_position> strand={+|-}",
+		"genomic_boundary_start=<start_position> genomic_boundary_end=<end_position> strand={+|-} [contig=<genomic sequence name, default: the first>]",
 		"count=<number of seed HSPs>",
 		"(hsp1_genomic_start, hsp1_cdna_start) (hsp1_genomic_end, hsp1_cdna_end)",
 		"(hsp2_genomic_start, hsp2_cdna_start) (hsp2_genomic_end, hsp2_cdna_end)",
@@ -110,10 +213,11 @@ int main (int argc, char *argv[]) {
 	/* HMM and Trellis */
 
 	zHMM            hmm;        /* HMM model from the parameter file */
-	zPairTrellis    trellis;    /* Trellis to store all the information for decoding */
+	zPairagonRun    run;        /* cDNA entries and the alignment jobs they expand to */
 
 	/* Program Modes */
 	bool            optimized_mode;
+	int             threads = 1;           /* Worker processes for --threads */
 
 	/* Alignment specific modes */
 	int             alignment_mode = BOTH; /* Strand of cDNA to align against + strand of genomic */
@@ -121,27 +225,28 @@ int main (int argc, char *argv[]) {
 	/* Input Files */
 	char*           parameter_file_name;   /* Input zHMM parameter file */
 	char*           cdna_file;             /* Input cDNA fasta file, can be multiple sequences */
-	char*           genomic_file;          /* Input genomic fasta file, MUST BE SINGLE SEQUENCE */
+	char*           genomic_file;          /* Input genomic fasta file, or its genome index */
 
 	/* Sequences */
-	zDNA*           cdna;      /* cDNA sequence */
-	zDNA*           genomic;   /* Genomic sequence */
+	zPairagonGenome genome;    /* Genomic sequences, by the contig names in the seeds */
+	zDNA*           genomic;   /* First genomic sequence */
 
 	/* Helper Objects to store Sequence Information */
 	int             cdna_entries;          /* No. of cDNA entries in the input cDNA file */
 	zVec*           multi_cdna_vec;        /* zVec that stores all the entries in the input cDNA file. Used when reading in from file only */
 	zDNA**          multi_cdna;            /* Array to store the cDNA entries in the zVec above */
 	zVec*           multi_seed_vec = NULL; /* Seed alignment for each cDNA entry in the cDNA fasta file */
-	zSeedAlignment *seed = NULL;           /* The working Seed alignment. Do not free here, will be freed by zInitPairTrellis */
+	zKmerIndex*     kmer_index = NULL;     /* Genomic k-mers, for --seed=auto and --prune_modes */
+	bool            auto_seed;             /* --seed=auto */
+	zDNAIterator*   cdna_iterator;         /* cDNA entries one at a time, for --stream */
+	FILE*           seed_stream = NULL;    /* Seed alignments one at a time, for --stream */
+	int             batch;                 /* cDNA entries held at a time with --stream */
 
 	/* Output Helper Objects */
 	int             size;
 	char*           full_command_line;     /* To print the first line of output */
 	int             lib_verbosity = 0;
-	score_t         score;                 /* To print the "Score: yadda yadda" */
 	time_t          stop_time;             /* To print the "Date: yadda yadda" */
-	struct rusage   ru;                    /* System resource usage - time */
-	double          previous_usage, current_usage;
 
 	/* General Iterator */
 	int             i;
@@ -165,6 +270,7 @@ int main (int argc, char *argv[]) {
 	/* set the program name */
 	zSetProgramName(argv[0]);
 	zParseOptions(&argc, argv);
+	zRegisterPairKernels();
 	
 	if (zOption("h") || zOption("-help")) {
 		usage(NULL);
@@ -182,6 +288,45 @@ int main (int argc, char *argv[]) {
 		optimized_mode = false;
 	}
 
+	/* Set the number of worker processes */
+
+	if (zOption("-threads") != NULL) {
+		threads = atoi(zOption("-threads"));
+		if (threads < 1) zDie("--threads needs a positive number (%s)", zOption("-threads"));
+	}
+	if (zOption("-tile_threads") != NULL && atoi(zOption("-tile_threads")) < 1) {
+		zDie("--tile_threads needs a positive number (%s)", zOption("-tile_threads"));
+	}
+#ifdef COMPACT_CELL
+	if (zOption("-verify_compact") != NULL) {
+		zDie("--verify_compact compares against double precision cells, build without COMPACT_CELL");
+	}
+#endif
+	if (zOption("-posteriors") != NULL && (optimized_mode || zOption("i") == NULL)) {
+		zDie("--posteriors adds a column to the -i output and needs the full trellis: use it with -i and without -o");
+	}
+	if (zOption("-decoder") != NULL && strcmp(zOption("-decoder"), "mea") != 0 && strcmp(zOption("-decoder"), "viterbi") != 0) {
+		zDie("--decoder is viterbi or mea (%s)", zOption("-decoder"));
+	}
+	if (zIsMEADecoder() && optimized_mode) {
+		zDie("--decoder=mea needs the full trellis: use it without -o");
+	}
+	if (zOption("-mea_threshold") != NULL && (atof(zOption("-mea_threshold")) <= 0 || atof(zOption("-mea_threshold")) > 1)) {
+		zDie("--mea_threshold needs a probability above 0 and at most 1 (%s)", zOption("-mea_threshold"));
+	}
+	if (zOption("-beam") != NULL && (!optimized_mode || atof(zOption("-beam")) <= 0)) {
+		zDie("--beam needs -o and a positive score (%s)", zOption("-beam"));
+	}
+	if (zOption("-beam_retry") != NULL && zOption("-beam") == NULL) {
+		zDie("--beam_retry needs --beam");
+	}
+	if (zOption("-band") != NULL && atoi(zOption("-band")) < 1) {
+		zDie("--band needs a positive number (%s)", zOption("-band"));
+	}
+	if (zOption("-checkpoint") != NULL && (zOption("-seed") != NULL || optimized_mode || zOption("-posteriors") != NULL || zIsMEADecoder())) {
+		zDie("--checkpoint needs a trellis of one block without forward values: use it without --seed, -o, --posteriors and --decoder=mea");
+	}
+
 	/* Set alignment mode */
 
 	if (zOption("-alignment_mode") != NULL && strcmp(zOption("-alignment_mode"), "forward") == 0) {
@@ -227,199 +372,134 @@ int main (int argc, char *argv[]) {
 	}
 	fclose(stream);
 
-	cdna    = zMalloc(sizeof(zDNA), "main: cdna");
-	genomic = zMalloc(sizeof(zDNA), "main: genomic");
-	zInitDNA(cdna);
-	zInitDNA(genomic);
-
-	zLoadDNAFromFasta(genomic,genomic_file,NULL);
+	zOpenPairagonGenome(&genome, genomic_file);
+	genomic = zGetPairagonContig(&genome, NULL);
 
-	/* Read in a cDNA fasta file with multiple sequences */
-	multi_cdna_vec = (zVec*) zMalloc(sizeof(zVec), "main: multi_cdna_vec");
-	zInitVec(multi_cdna_vec, 2);
-	cdna_entries = zLoadMultiDNAFromMultiFasta(multi_cdna_vec, cdna_file, NULL);
-
-	multi_cdna = (zDNA**) zMalloc(cdna_entries*sizeof(zDNA*), "main: multi_cdna");
-	for (i = 0; i < cdna_entries; i++) {
-		multi_cdna[i] = (zDNA*) multi_cdna_vec->elem[i];
+	/* Seeds from a k-mer index of the genomic, for --seed=auto, and strand support for --prune_modes */
+	auto_seed = (zOption("-seed") != NULL && strcmp(zOption("-seed"), "auto") == 0);
+	if (auto_seed || zOption("-prune_modes") != NULL) {
+		kmer_index = zMalloc(sizeof(zKmerIndex), "main: kmer_index");
+		zInitKmerIndex(kmer_index, genomic);
 	}
 
-	/* Read the seed alignments */
+	run.hmm            = &hmm;
+	run.genome         = &genome;
+	run.kmers          = (zOption("-prune_modes") != NULL) ? kmer_index : NULL;
+	run.optimized_mode = optimized_mode;
+	zInitPairScannerCache(&run.scanners);
 
-	if (zOption("-seed") != NULL) {
-		if ((stream = fopen(zOption("-seed"), "r")) == NULL) {
+	if (zOption("-stream") != NULL) {
+		/* Read the cDNAs and their seeds a batch at a time and free them once written */
+		batch = STREAM_BATCH*threads;
+		if (zOption("-seed") != NULL && !auto_seed && (seed_stream = fopen(zOption("-seed"), "r")) == NULL) {
 			zDie("seed alignment file error (%s)", zOption("-seed"));
 		}
-		multi_seed_vec = (zVec*) zMalloc(sizeof(zVec), "main: multi_cdna_vec");
-		zInitVec(multi_seed_vec, 2);
-		if (zReadMultipleSeedAlignments(stream, multi_seed_vec) != cdna_entries) {
-			zDie("Incorrect number of seed alignments");
-		}
-		fclose(stream);
-	}
-
-	/*******************************************************************
-	 *  Run the alignment algorithm
-	 *******************************************************************/
-
-	/* Align each cDNA file */
-
-	time(&stop_time);
-	zWriteGlobalHeaders(stdout,full_command_line,parameter_file_name,ctime(&stop_time));
-	getrusage(RUSAGE_SELF,&ru);
-	previous_usage = ru.ru_utime.tv_sec + ru.ru_stime.tv_sec;
-	for (i = 0; i < cdna_entries; i++) {
-		score_t best_score          = MIN_SCORE;
-		int     best_alignment_mode = -1;
-		int     best_splice_mode    = -1;
-		int     smode, amode;
-		int j, k;
-		zIVec  *avec         = zMalloc(sizeof(zIVec), "main: avec");
-		zIVec  *svec         = zMalloc(sizeof(zIVec), "main: svec");
-		zAFVec *best_afv     = zMalloc(sizeof(zAFVec), "main: best_afv");
-		zDNA   *best_genomic = zMalloc(sizeof(zDNA), "main: best_genomic");
-		zDNA   *best_cdna    = zMalloc(sizeof(zDNA), "main: best_cdna");
+		time(&stop_time);
+		zWriteGlobalHeaders(stdout,full_command_line,parameter_file_name,ctime(&stop_time));
+		cdna_iterator = zGetDNAIterator(cdna_file, NULL);
+		multi_cdna = (zDNA**) zMalloc(batch*sizeof(zDNA*), "main: multi_cdna");
+		do {
+			if (zOption("-seed") != NULL) {
+				multi_seed_vec = (zVec*) zMalloc(sizeof(zVec), "main: multi_seed_vec");
+				zInitVec(multi_seed_vec, batch);
+			}
+			for (cdna_entries = 0; cdna_entries < batch; cdna_entries++) {
+				if ((multi_cdna[cdna_entries] = zGetNextDNA(cdna_iterator)) == NULL) break;
+				if (multi_seed_vec != NULL) {
+					zPushVec(multi_seed_vec, zGetNextSeedAlignment(seed_stream, auto_seed ? kmer_index : NULL, multi_cdna[cdna_entries]));
+				}
+			}
+			run.multi_cdna     = multi_cdna;
+			run.multi_seed_vec = multi_seed_vec;
+			if (cdna_entries > 0) zAlignPairagonEntries(&run, cdna_entries, &alignment_mode, threads);
 
-		if (multi_seed_vec != NULL) {
-			seed = (zSeedAlignment*) multi_seed_vec->elem[i];
-			if (seed->strand != UNDEFINED_STRAND) {
-				/* Once you are here, you have seed alignments, so you dont need the original value of alignment_mode */
-				alignment_mode = (seed->strand == '-')?REVERSE:FORWARD;
-				fprintf(stdout, "# Seed alignment found in %c strand of cDNA. %s alignment_mode enforced\n", seed->strand, (seed->strand=='-')?"reverse":"forward");
+			for (i = 0; i < cdna_entries; i++) {
+				zFreeDNA(multi_cdna[i]);
+				zFree(multi_cdna[i]);
 			}
-			if (seed->gb_end == 0) {
-				zWarn("# Empty seed alignment found. Skipping this cDNA");
-				zWriteLocalHeaders(stdout, genomic, multi_cdna[i], FORWARD, FORWARD, 0, (score_t)0);
-				zFree(best_afv); zFree(best_genomic); zFree(best_cdna);
-				continue;
+			if (multi_seed_vec != NULL) {
+				for (i = 0; i < multi_seed_vec->size; i++) {
+					zFreeSeedAlignment((zSeedAlignment*) multi_seed_vec->elem[i]);
+					zFree(multi_seed_vec->elem[i]);
+				}
+				zFreeVec(multi_seed_vec);
+				zFree(multi_seed_vec);
+				multi_seed_vec = NULL;
 			}
-		} else {
-			seed = NULL;
+		} while (cdna_entries == batch);
+		zFreeDNAIterator(cdna_iterator);
+		zFree(multi_cdna);
+		if (seed_stream != NULL) {
+			zSeedAlignment extra;
+			if (zReadSeedAlignment(seed_stream, &extra) != -1) zDie("Incorrect number of seed alignments");
+			fclose(seed_stream);
 		}
+	} else {
+		/* Read in a cDNA fasta file with multiple sequences */
+		multi_cdna_vec = (zVec*) zMalloc(sizeof(zVec), "main: multi_cdna_vec");
+		zInitVec(multi_cdna_vec, 2);
+		cdna_entries = zLoadMultiDNAFromMultiFasta(multi_cdna_vec, cdna_file, NULL);
 
-		zInitIVec(avec, 1);
-		if (alignment_mode == FORWARD) {
-			zPushIVec(avec, FORWARD);
-		} else if (alignment_mode == REVERSE) {
-			zPushIVec(avec, REVERSE);
-		} else {
-			zPushIVec(avec, FORWARD);
-			zPushIVec(avec, REVERSE);
+		multi_cdna = (zDNA**) zMalloc(cdna_entries*sizeof(zDNA*), "main: multi_cdna");
+		for (i = 0; i < cdna_entries; i++) {
+			multi_cdna[i] = (zDNA*) multi_cdna_vec->elem[i];
 		}
 
-		zInitAFVec(best_afv, 2);
-		zInitDNA(best_genomic);
-		zInitDNA(best_cdna);
+		/* Read the seed alignments */
 
-		for (j = 0; j < avec->size; j++) { /* Over all alignment modes */
-			amode = avec->elem[j];
-			zInitIVec(svec, 1);
-			if (zOption("-splice_mode") != NULL) {
-				       if (strcmp(zOption("-splice_mode"), "forward") == 0) {
-					zPushIVec(svec, FORWARD);
-				} else if (strcmp(zOption("-splice_mode"), "reverse") == 0) {
-					zPushIVec(svec, REVERSE);
-				} else if (strcmp(zOption("-splice_mode"), "both") == 0) {
-					zPushIVec(svec, FORWARD);
-					zPushIVec(svec, REVERSE);
-				} else if (strcmp(zOption("-splice_mode"), "cdna") == 0) {
-					zPushIVec(svec, amode);
-				}
-			} else { /* This is default */
-				zPushIVec(svec, amode);
+		if (auto_seed) {
+			multi_seed_vec = (zVec*) zMalloc(sizeof(zVec), "main: multi_seed_vec");
+			zInitVec(multi_seed_vec, 2);
+			for (i = 0; i < cdna_entries; i++) {
+				zPushVec(multi_seed_vec, zGetNextSeedAlignment(NULL, kmer_index, multi_cdna[i]));
 			}
-			for (k = 0; k < svec->size; k++) { /* Over all splice modes */
-				smode = svec->elem[k];
-
-				fprintf(stderr, "# Running alignment_mode=%s, splice_mode=%s\n", zGetAlignmentModeString(amode), zGetSpliceModeString(smode));
-				zCopyDNA(multi_cdna[i], cdna);
-				if (smode == REVERSE) { /* splice_mode = reverse */
-					zSetHMMStrand(&hmm, '-');
-				} else {
-					zSetHMMStrand(&hmm, '+');
-				}
-				if (amode == REVERSE) { /* alignment_mode = reverse */
-					zAntiDNA(cdna);
-				}
-				/* Run Pairagon using the options */
-				{
-					zAFVec    *afv;
-					zInitPairTrellis(&trellis, seed, genomic, cdna, &hmm);
-
-					if(optimized_mode){
-						afv = zRunPairViterbi(&trellis,&score);
-					}
-					else
-					{
-						afv = zRunPairViterbiAndForward(&trellis,&score);
-					}
-					
-					if (score > best_score) {
-						int m;
-						best_score = score;
-						best_splice_mode = smode;
-						best_alignment_mode = amode;
-						zFreeDNA(best_genomic);
-						zInitDNA(best_genomic);
-						zCopyDNA(trellis.genomic, best_genomic);
-						zFreeDNA(best_cdna);
-						zInitDNA(best_cdna);
-						zCopyDNA(trellis.cdna, best_cdna);
-						zFreeAFVec(best_afv);
-						zInitAFVec(best_afv, 2);
-						zCopyAFVec(afv, best_afv);
-						for (m = 0; m < best_afv->size; m++) {
-							best_afv->elem[m].genomic = best_genomic;
-							best_afv->elem[m].cdna = best_cdna;
-						}
-					}
-					zFreeAFVec(afv);
-					zFree(afv);
-
-					zFreePairTrellis(&trellis);
-					zFreeDNA(cdna);
-				}
+			if (run.kmers == NULL) {
+				zFreeKmerIndex(kmer_index);
+				zFree(kmer_index);
+				kmer_index = NULL;
+			}
+		} else if (zOption("-seed") != NULL) {
+			if ((stream = fopen(zOption("-seed"), "r")) == NULL) {
+				zDie("seed alignment file error (%s)", zOption("-seed"));
 			}
-			zFreeIVec(svec);
+			multi_seed_vec = (zVec*) zMalloc(sizeof(zVec), "main: multi_cdna_vec");
+			zInitVec(multi_seed_vec, 2);
+			if (zReadMultipleSeedAlignments(stream, multi_seed_vec) != cdna_entries) {
+				zDie("Incorrect number of seed alignments");
+			}
+			fclose(stream);
 		}
-		zFreeIVec(avec);
 
-		getrusage(RUSAGE_SELF,&ru);
-		current_usage = ru.ru_utime.tv_sec + ru.ru_stime.tv_sec;
-		zWriteLocalHeaders(stdout, genomic, multi_cdna[i], best_alignment_mode, best_splice_mode, current_usage-previous_usage, best_score);
-		previous_usage = current_usage;
-		if (zOption("i") != NULL) {
-			zWriteAFVec(stdout, best_afv, 0, 0);
-		} else {
-			zWriteAlignment(stdout, best_afv, 0);
-		}
-		fflush(stdout);
-		zFree(avec);
-		zFree(svec);
-		zFreeAFVec(best_afv);
-		zFree(best_afv);
-		zFreeDNA(best_cdna);
-		zFree(best_cdna);
-		zFreeDNA(best_genomic);
-		zFree(best_genomic);
-	}
+		/*******************************************************************
+		 *  Run the alignment algorithm
+		 *******************************************************************/
 
-	/* Multiple cDNA and multiple seed alignment stuff */
-	for (i = 0; i < cdna_entries; i++) {
-		zFreeDNA((zDNA*)multi_cdna_vec->elem[i]);
-		zFree(multi_cdna_vec->elem[i]);
+		time(&stop_time);
+		zWriteGlobalHeaders(stdout,full_command_line,parameter_file_name,ctime(&stop_time));
+		run.multi_cdna     = multi_cdna;
+		run.multi_seed_vec = multi_seed_vec;
+		zAlignPairagonEntries(&run, cdna_entries, &alignment_mode, threads);
+
+		/* Multiple cDNA and multiple seed alignment stuff */
+		for (i = 0; i < cdna_entries; i++) {
+			zFreeDNA((zDNA*)multi_cdna_vec->elem[i]);
+			zFree(multi_cdna_vec->elem[i]);
+		}
+		zFreeVec(multi_cdna_vec);
+		zFree(multi_cdna_vec);
+		zFree(multi_cdna);
+		if (multi_seed_vec != NULL) {
+			zFreeVec(multi_seed_vec);
+			zFree(multi_seed_vec);
+		}
 	}
-	zFreeVec(multi_cdna_vec);
-	zFree(multi_cdna_vec);
-	zFree(multi_cdna);
-	if (multi_seed_vec != NULL) {
-		zFreeVec(multi_seed_vec);
-		zFree(multi_seed_vec);
+	if (kmer_index != NULL) {
+		zFreeKmerIndex(kmer_index);
+		zFree(kmer_index);
 	}
 
-	zFreeDNA(genomic);
-	zFree(genomic);
-	zFree(cdna);
+	zFreePairScannerCache(&run.scanners);
+	zClosePairagonGenome(&genome);
 	zFreeHMM(&hmm);
 	zFreeOptions();
 	zFree(full_command_line);
@@ -428,6 +508,100 @@ int main (int argc, char *argv[]) {
 	return 0;
 }
 
+static zPairagonContig* zAddPairagonContig(zPairagonGenome *genome, const char *name, int number, zDNA *dna) {
+	zPairagonContig *contig = zMalloc(sizeof(zPairagonContig), "zAddPairagonContig: contig");
+
+	contig->number = number;
+	contig->dna    = dna;
+	zPushVec(&genome->contigs, contig);
+	if (zGetHash(&genome->names, name) == NULL) zSetHash(&genome->names, name, contig);
+	return contig;
+}
+
+void zOpenPairagonGenome(zPairagonGenome *genome, char *filename) {
+	zDNA *first;
+	char *name;
+	int   i;
+
+	genome->filename = filename;
+	genome->index    = NULL;
+	genome->fasta    = NULL;
+	zInitVec(&genome->contigs, 1);
+	zInitHash(&genome->names);
+
+	if (zIsGenomeIndex(filename)) {
+		genome->index = zOpenGenomeIndex(filename);
+		for (i = 0; i < genome->index->contigs; i++) {
+			name = zGetSeqNameFromFastaHeader(genome->index->map + genome->index->contig[i].def_offset);
+			zAddPairagonContig(genome, name, i, NULL);
+			zFree(name);
+		}
+		return;
+	}
+
+	/* The first record is loaded the way a single sequence fasta file always was */
+	first = zMalloc(sizeof(zDNA), "zOpenPairagonGenome: first");
+	zInitDNA(first);
+	zLoadDNAFromFasta(first, filename, NULL);
+	zSetDNAPadding(first, PADDING); /* Padded once here, every trellis borrows it as it is */
+	zAddPairagonContig(genome, first->seqname, -1, first);
+}
+
+/* The contig called name, or the first one for NULL */
+
+zDNA* zGetPairagonContig(zPairagonGenome *genome, const char *name) {
+	zPairagonContig *contig;
+	zDNA            *dna;
+
+	if (name == NULL) {
+		contig = (zPairagonContig*) genome->contigs.elem[0];
+	} else if ((contig = (zPairagonContig*) zGetHash(&genome->names, name)) == NULL) {
+		if (genome->index != NULL) zDie("no genomic sequence %s in %s", name, genome->filename);
+
+		/* Read on through the fasta file, keeping the records on the way */
+		if (genome->fasta == NULL) {
+			genome->fasta = zGetDNAIterator(genome->filename, NULL);
+			dna = zGetNextDNA(genome->fasta); /* the first record, loaded already */
+			zFreeDNA(dna);
+			zFree(dna);
+		}
+		while (contig == NULL) {
+			if ((dna = zGetNextDNA(genome->fasta)) == NULL) {
+				zDie("no genomic sequence %s in %s", name, genome->filename);
+			}
+			dna->seq->default_char = 'N';
+			zSetDNAPadding(dna, PADDING);
+			zAddPairagonContig(genome, dna->seqname, -1, dna);
+			contig = (zPairagonContig*) zGetHash(&genome->names, name);
+		}
+	}
+
+	if (contig->dna == NULL) {
+		contig->dna = zMalloc(sizeof(zDNA), "zGetPairagonContig: dna");
+		zInitDNA(contig->dna);
+		zLoadDNAFromGenomeIndex(contig->dna, genome->index, contig->number);
+		zSetDNAPadding(contig->dna, PADDING);
+	}
+	return contig->dna;
+}
+
+void zClosePairagonGenome(zPairagonGenome *genome) {
+	int i;
+
+	for (i = 0; i < genome->contigs.size; i++) {
+		zPairagonContig *contig = (zPairagonContig*) genome->contigs.elem[i];
+		if (contig->dna != NULL) {
+			zFreeDNA(contig->dna);
+			zFree(contig->dna);
+		}
+		zFree(contig);
+	}
+	zFreeVec(&genome->contigs);
+	zFreeHash(&genome->names);
+	if (genome->fasta != NULL) zFreeDNAIterator(genome->fasta);
+	if (genome->index != NULL) zCloseGenomeIndex(genome->index);
+}
+
 /* Write the commented header */
 /* This writes the header for the total run */
 void zWriteGlobalHeaders(FILE* stream, char* full_command_line,char* parameter_file_name, 
@@ -446,10 +620,547 @@ void zWriteGlobalHeaders(FILE* stream, char* full_command_line,char* parameter_f
 
 void zWriteLocalHeaders(FILE* stream, zDNA* genomic, zDNA* cdna, int amode, int smode, double time, score_t score) {
 		fprintf(stream, "# Spliced alignment without quality value for cDNA\n");
-		fprintf(stream, "# Genomic Sequence: %s, %ubp\n", genomic->def, genomic->length);
+		fprintf(stream, "# Genomic Sequence: %s, %ubp\n", genomic->def, genomic->seq->real_length);
 		fprintf(stream, "# cDNA    Sequence: %s, %ubp\n", cdna->def, cdna->length);
 		fprintf(stream, "# Note Best alignment is between %s est and forward genome, %s splice sites imply %s gene\n", zGetAlignmentModeString(amode), (smode==REVERSE)?"but":"and", zGetSpliceModeString(smode));
 		fprintf(stream, "# Completed in %.2f CPU seconds\n", time); 
 		fprintf(stream, "# Optimal score: %f\n", score);
 }
 
+
+/* Expand the cDNA entries into jobs, one per alignment_mode and splice_mode  *
+ * combination, in the order they are tried. A seed strand fixes the          *
+ * alignment_mode for its entry and every entry after it without a strand,    *
+ * so *mode comes back as the alignment_mode for the entries that follow.     */
+
+void zPlanPairagonRun(zPairagonRun *run, int cdna_entries, int *mode) {
+	int i, j, k, smodes[2], amodes[2], acount, scount;
+	int alignment_mode = *mode;
+
+	run->entries    = cdna_entries;
+	run->entry      = zMalloc(cdna_entries*sizeof(zPairagonEntry), "zPlanPairagonRun: entry");
+	run->jobs       = 0;
+	run->job        = zMalloc((4*cdna_entries + 1)*sizeof(zPairagonJob), "zPlanPairagonRun: job"); /* at most 2 alignment x 2 splice modes */
+	run->next_entry = 0;
+
+	for (i = 0; i < cdna_entries; i++) {
+		zPairagonEntry *entry = &run->entry[i];
+
+		entry->first_job = run->jobs;
+		entry->jobs      = 0;
+		entry->strand    = UNDEFINED_STRAND;
+		entry->empty     = false;
+		entry->genomic   = zGetPairagonContig(run->genome, NULL);
+		if (run->multi_seed_vec != NULL) {
+			zSeedAlignment *seed = (zSeedAlignment*) run->multi_seed_vec->elem[i];
+			entry->genomic = zGetPairagonContig(run->genome, seed->contig);
+			if (seed->strand != UNDEFINED_STRAND) {
+				/* Once you are here, you have seed alignments, so you dont need the original value of alignment_mode */
+				alignment_mode = (seed->strand == '-')?REVERSE:FORWARD;
+				entry->strand  = seed->strand;
+			}
+			if (seed->gb_end == 0) {
+				entry->empty = true;
+				continue;
+			}
+		}
+
+		acount = 0;
+		if (alignment_mode == FORWARD) {
+			amodes[acount++] = FORWARD;
+		} else if (alignment_mode == REVERSE) {
+			amodes[acount++] = REVERSE;
+		} else {
+			amodes[acount++] = FORWARD;
+			amodes[acount++] = REVERSE;
+		}
+		if (acount == 2 && run->kmers != NULL && entry->genomic == run->kmers->genomic) {
+			/* Drop the orientation of the cDNA that k-mer chains hardly support */
+			long coverage[2];
+			zSeedStrandCoverage(run->kmers, run->multi_cdna[i], coverage);
+			for (j = 0; j < 2; j++) {
+				if (coverage[1-j] >= SEED_MIN_HSP && coverage[j]*PRUNE_MODES_RATIO < coverage[1-j]) {
+					fprintf(stderr, "# Skipping alignment_mode=%s for %s: k-mer chains cover %ld cDNA bases, against %ld\n",
+							zGetAlignmentModeString(amodes[j]), run->multi_cdna[i]->def, coverage[j], coverage[1-j]);
+					amodes[0] = amodes[1-j];
+					acount    = 1;
+					break;
+				}
+			}
+		}
+		for (j = 0; j < acount; j++) { /* Over all alignment modes */
+			scount = 0;
+			if (zOption("-splice_mode") != NULL) {
+				       if (strcmp(zOption("-splice_mode"), "forward") == 0) {
+					smodes[scount++] = FORWARD;
+				} else if (strcmp(zOption("-splice_mode"), "reverse") == 0) {
+					smodes[scount++] = REVERSE;
+				} else if (strcmp(zOption("-splice_mode"), "both") == 0) {
+					smodes[scount++] = FORWARD;
+					smodes[scount++] = REVERSE;
+				} else if (strcmp(zOption("-splice_mode"), "cdna") == 0) {
+					smodes[scount++] = amodes[j];
+				}
+			} else { /* This is default */
+				smodes[scount++] = amodes[j];
+			}
+			for (k = 0; k < scount; k++) { /* Over all splice modes */
+				zPairagonJob *job = &run->job[run->jobs++];
+				job->entry  = i;
+				job->amode  = amodes[j];
+				job->smode  = smodes[k];
+				job->twin   = -1;
+				job->riding = false;
+				job->score  = MIN_SCORE;
+				job->time   = 0;
+				job->text   = NULL;
+				job->length = 0;
+				job->done   = false;
+				entry->jobs++;
+			}
+		}
+		if (zOption("-shared_sweep") != NULL && run->multi_seed_vec == NULL) {
+			zPairSweepJobs(run, entry);
+		}
+	}
+	*mode = alignment_mode;
+}
+
+/* Pair every forward job of entry with the reverse job of the same splice_mode. *
+ * The splice_mode sets the strand of all the models, genomic ones included, so  *
+ * only jobs that share it can share the genomic side of a trellis               */
+
+void zPairSweepJobs(zPairagonRun *run, zPairagonEntry *entry) {
+	int j, k;
+
+	for (j = entry->first_job; j < entry->first_job + entry->jobs; j++) {
+		zPairagonJob *job = &run->job[j];
+		if (job->amode != FORWARD) continue;
+		for (k = entry->first_job; k < entry->first_job + entry->jobs; k++) {
+			zPairagonJob *twin = &run->job[k];
+			if (twin->amode == REVERSE && twin->smode == job->smode && !twin->riding) {
+				job->twin    = k;
+				twin->riding = true;
+				break;
+			}
+		}
+	}
+}
+
+/* Plan, align and write out the entries of run */
+
+void zAlignPairagonEntries(zPairagonRun *run, int cdna_entries, int *alignment_mode, int threads) {
+	int i;
+
+	zPlanPairagonRun(run, cdna_entries, alignment_mode);
+	if (threads > 1) {
+		zRunWorkerPool(run, threads);
+	} else {
+		for (i = 0; i < run->jobs; i++) {
+			if (run->job[i].riding) continue;
+			zRunPairagonJob(run, &run->job[i]);
+			zWritePairagonEntries(run);
+		}
+		zWritePairagonEntries(run); /* trailing entries without jobs */
+	}
+	zFreePairagonRun(run);
+}
+
+/* The seed alignment of cdna: searched for in index when there is one, *
+ * otherwise the next record of stream                                  */
+
+zSeedAlignment* zGetNextSeedAlignment(FILE *stream, zKmerIndex *index, zDNA *cdna) {
+	zSeedAlignment *seed = (zSeedAlignment*) zMalloc(sizeof(zSeedAlignment), "zGetNextSeedAlignment: seed");
+
+	if (index != NULL) {
+		zSearchSeedAlignment(index, cdna, seed);
+	} else if (zReadSeedAlignment(stream, seed) == -1) {
+		zDie("Incorrect number of seed alignments");
+	}
+	return seed;
+}
+
+void zFreePairagonRun(zPairagonRun *run) {
+	int i;
+	for (i = 0; i < run->jobs; i++) {
+		if (run->job[i].text != NULL) zFree(run->job[i].text);
+	}
+	zFree(run->job);
+	zFree(run->entry);
+}
+
+/* Align one job and keep its score, CPU time and rendered alignment. A job *
+ * with a twin turns the trellis around and decodes the twin after it       */
+
+void zRunPairagonJob(zPairagonRun *run, zPairagonJob *job) {
+	zPairTrellis    trellis;
+	zDNA           *cdna = zMalloc(sizeof(zDNA), "zRunPairagonJob: cdna");
+	zSeedAlignment *seed = NULL;
+	struct rusage   ru;
+	double          start, split;
+
+	getrusage(RUSAGE_SELF,&ru);
+	start = ru.ru_utime.tv_sec + ru.ru_stime.tv_sec;
+
+	if (run->multi_seed_vec != NULL) {
+		seed = (zSeedAlignment*) run->multi_seed_vec->elem[job->entry];
+	}
+
+	fprintf(stderr, "# Running alignment_mode=%s, splice_mode=%s\n", zGetAlignmentModeString(job->amode), zGetSpliceModeString(job->smode));
+	zInitDNA(cdna);
+	zCopyDNA(run->multi_cdna[job->entry], cdna);
+	if (job->smode == REVERSE) { /* splice_mode = reverse */
+		zSetHMMStrand(run->hmm, '-');
+	} else {
+		zSetHMMStrand(run->hmm, '+');
+	}
+	if (job->amode == REVERSE) { /* alignment_mode = reverse */
+		zAntiDNA(cdna);
+	}
+
+	/* Run Pairagon using the options */
+	zInitCachedPairTrellis(&trellis, seed, run->entry[job->entry].genomic, cdna, run->hmm, &run->scanners);
+	zSetTrellisOptions(&trellis);
+	zDecodePairagonJob(run, job, &trellis, seed, cdna);
+
+	getrusage(RUSAGE_SELF,&ru);
+	split = ru.ru_utime.tv_sec + ru.ru_stime.tv_sec;
+	job->time = split - start;
+	job->done = true;
+
+	if (job->twin >= 0) {
+		zPairagonJob *twin = &run->job[job->twin];
+		fprintf(stderr, "# Running alignment_mode=%s, splice_mode=%s\n", zGetAlignmentModeString(twin->amode), zGetSpliceModeString(twin->smode));
+		zReversePairTrellis(&trellis);
+		zAntiDNA(cdna);
+		zDecodePairagonJob(run, twin, &trellis, seed, cdna);
+
+		getrusage(RUSAGE_SELF,&ru);
+		twin->time = ru.ru_utime.tv_sec + ru.ru_stime.tv_sec - split;
+		twin->done = true;
+	}
+
+	zFreePairTrellis(&trellis);
+	zFreeDNA(cdna);
+	zFree(cdna);
+}
+
+/* Decode job on trellis and render its alignment while the trellis still owns the sequences */
+
+void zDecodePairagonJob(zPairagonRun *run, zPairagonJob *job, zPairTrellis *trellis, zSeedAlignment *seed, zDNA *cdna) {
+	zAFVec *afv, *mea;
+	FILE   *text;
+	score_t score;
+
+	if (run->optimized_mode) {
+		afv = zRunPairViterbi(trellis,&job->score);
+		if (trellis->beam > 0) {
+			zWarn("# Beam dropped %ld cells aligning %s%s", trellis->beam_hits, cdna->def, (trellis->beam_retried) ? ", decoded again without it" : "");
+		}
+	} else {
+		afv = zRunPairViterbiAndForward(trellis,&job->score);
+		if (zOption("-verify_compact") != NULL) zVerifyCompactCells(run, job, seed, cdna, afv);
+		if (trellis->posteriors) zRunPairBackward(trellis, (zOption("-posteriors") != NULL) ? afv : NULL);
+		if (zIsMEADecoder()) {
+			mea = zRunPairPosteriorDecoding(trellis, &score);
+			if (mea == NULL) {
+				zWarn("# No alignment of %s through cells of high enough posterior, keeping the Viterbi one", cdna->def);
+			} else {
+				zFreeAFVec(afv);
+				zFree(afv);
+				afv        = mea;
+				job->score = score;
+				if (zOption("-posteriors") != NULL) zComputePosteriorProbability(trellis, afv);
+			}
+		}
+	}
+
+	if ((text = tmpfile()) == NULL) zDie("zRunPairagonJob: cannot open a temporary file");
+	if (zOption("i") != NULL) {
+		zWriteAFVec(text, afv, 0, 0);
+	} else {
+		zWriteAlignment(text, afv, 0);
+	}
+	job->length = ftell(text);
+	job->text   = zMalloc(job->length + 1, "zRunPairagonJob: text");
+	rewind(text);
+	if (fread(job->text, 1, job->length, text) != job->length) zDie("zRunPairagonJob: cannot read back the alignment");
+	job->text[job->length] = '\0';
+	fclose(text);
+
+	zFreeAFVec(afv);
+	zFree(afv);
+}
+
+void zSetTrellisOptions(zPairTrellis *trellis) {
+	if (zOption("-noarena") != NULL) trellis->arena = false;
+	if (zOption("-nowavefront") != NULL) trellis->wavefront = false;
+	if (zOption("-nokernel") != NULL) trellis->specialize = false;
+	if (zOption("-nosplice_prune") != NULL) trellis->splice_prune = false;
+	if (zOption("-tile_threads") != NULL) trellis->tile_threads = atoi(zOption("-tile_threads"));
+	if (zOption("-band") != NULL) trellis->band = atoi(zOption("-band"));
+	if (zOption("-beam") != NULL) trellis->beam = atof(zOption("-beam"));
+	if (zOption("-beam_retry") != NULL) trellis->beam_retry = true;
+	if (zOption("-checkpoint") != NULL) trellis->checkpoint = true;
+	if (zOption("-posteriors") != NULL || zIsMEADecoder()) trellis->posteriors = true;
+	if (zIsMEADecoder()) trellis->mea_threshold = (zOption("-mea_threshold") != NULL) ? atof(zOption("-mea_threshold")) : MEA_THRESHOLD;
+}
+
+/* Align the job again with cell scores rounded to float, as a COMPACT_CELL *
+ * build keeps them, and report on stderr where its path leaves afv's       */
+
+void zVerifyCompactCells(zPairagonRun *run, zPairagonJob *job, zSeedAlignment *seed, zDNA *cdna, zAFVec *afv) {
+	zPairTrellis  trellis;
+	zAFVec       *compact;
+	score_t       score;
+	int           i;
+
+	zInitPairTrellis(&trellis, seed, run->entry[job->entry].genomic, cdna, run->hmm);
+	zSetTrellisOptions(&trellis);
+	trellis.compact = true;
+	trellis.posteriors = false; /* only the path is compared */
+	compact = zRunPairViterbiAndForward(&trellis, &score);
+
+	for (i = 0; i < afv->size && i < compact->size; i++) {
+		zAlnFeature *f = &afv->elem[i], *c = &compact->elem[i];
+		if (f->state != c->state || f->genomic_start != c->genomic_start || f->genomic_end != c->genomic_end
+			|| f->cdna_start != c->cdna_start || f->cdna_end != c->cdna_end) break;
+	}
+	fprintf(stderr, "# verify_compact: %s alignment_mode=%s splice_mode=%s score %f, compact %f: ", run->multi_cdna[job->entry]->def,
+			zGetAlignmentModeString(job->amode), zGetSpliceModeString(job->smode), job->score, score);
+	if (i == afv->size && i == compact->size) {
+		fprintf(stderr, "same path\n");
+	} else if (i == afv->size || i == compact->size) {
+		fprintf(stderr, "paths differ after %d features\n", i);
+	} else {
+		fprintf(stderr, "paths differ at feature %d, %s %u-%u %u-%u vs %s %u-%u %u-%u\n", i,
+				zStrIdx2Char(afv->elem[i].name), afv->elem[i].genomic_start, afv->elem[i].genomic_end, afv->elem[i].cdna_start, afv->elem[i].cdna_end,
+				zStrIdx2Char(compact->elem[i].name), compact->elem[i].genomic_start, compact->elem[i].genomic_end, compact->elem[i].cdna_start, compact->elem[i].cdna_end);
+	}
+
+	zFreeAFVec(compact);
+	zFree(compact);
+	zFreePairTrellis(&trellis);
+}
+
+/* Write every entry whose jobs are all done, stopping at the first one that *
+ * is not, so that the output comes out in input order                       */
+
+void zWritePairagonEntries(zPairagonRun *run) {
+	for (; run->next_entry < run->entries; run->next_entry++) {
+		zPairagonEntry *entry = &run->entry[run->next_entry];
+		zDNA           *cdna  = run->multi_cdna[run->next_entry];
+		zPairagonJob   *best  = NULL;
+		score_t         best_score = MIN_SCORE;
+		double          time = 0;
+		int             j;
+
+		for (j = 0; j < entry->jobs; j++) {
+			if (!run->job[entry->first_job + j].done) return;
+		}
+
+		if (entry->strand != UNDEFINED_STRAND) {
+			fprintf(stdout, "# Seed alignment found in %c strand of cDNA. %s alignment_mode enforced\n", entry->strand, (entry->strand=='-')?"reverse":"forward");
+		}
+		if (entry->empty) {
+			zWarn("# Empty seed alignment found. Skipping this cDNA");
+			zWriteLocalHeaders(stdout, entry->genomic, cdna, FORWARD, FORWARD, 0, (score_t)0);
+			continue;
+		}
+
+		for (j = 0; j < entry->jobs; j++) {
+			zPairagonJob *job = &run->job[entry->first_job + j];
+			time += job->time;
+			if (job->score > best_score) {
+				best_score = job->score;
+				best = job;
+			}
+		}
+		zWriteLocalHeaders(stdout, entry->genomic, cdna, (best == NULL)?-1:best->amode, (best == NULL)?-1:best->smode, time, best_score);
+		if (best != NULL) {
+			fwrite(best->text, 1, best->length, stdout);
+		} else {
+			zAFVec none;
+			zInitAFVec(&none, 1);
+			if (zOption("i") != NULL) {
+				zWriteAFVec(stdout, &none, 0, 0);
+			} else {
+				zWriteAlignment(stdout, &none, 0);
+			}
+			zFreeAFVec(&none);
+		}
+		fflush(stdout);
+
+		for (j = 0; j < entry->jobs; j++) {
+			zPairagonJob *job = &run->job[entry->first_job + j];
+			zFree(job->text);
+			job->text = NULL;
+		}
+	}
+}
+
+/****************************************************************************** Worker pool for --threads
+
+ The library keeps free lists and string pools in globals, so the workers are
+ processes rather than threads. They are forked after the HMM, the genomic
+ sequence and the cDNAs of the run (one batch of them with --stream) are
+ loaded and share them with the parent copy on write. Each worker reads job
+ numbers from its own command pipe and answers on its own result pipe; the
+ parent hands out the next job as soon as a worker reports back and writes the
+ entries in input order as they complete.
+
+\******************************************************************************/
+
+struct zPairagonResult {
+	int       job;
+	score_t   score;
+	double    time;
+	size_t    length;
+};
+typedef struct zPairagonResult zPairagonResult;
+
+static void zWriteFully(int fd, const void *buffer, size_t length) {
+	const char *p = (const char*) buffer;
+	while (length > 0) {
+		ssize_t n = write(fd, p, length);
+		if (n <= 0) zDie("worker pool: write failed");
+		p      += n;
+		length -= n;
+	}
+}
+
+static bool zReadFully(int fd, void *buffer, size_t length) {
+	char *p = (char*) buffer;
+	while (length > 0) {
+		ssize_t n = read(fd, p, length);
+		if (n <= 0) return false;
+		p      += n;
+		length -= n;
+	}
+	return true;
+}
+
+static void zWritePairagonResult(zPairagonRun *run, int result, int id) {
+	zPairagonJob    *job = &run->job[id];
+	zPairagonResult  r;
+
+	r.job    = id;
+	r.score  = job->score;
+	r.time   = job->time;
+	r.length = job->length;
+	zWriteFully(result, &r, sizeof(zPairagonResult));
+	zWriteFully(result, job->text, job->length);
+	zFree(job->text);
+	job->text = NULL;
+}
+
+static int zReadPairagonResult(zPairagonRun *run, int result, int w) {
+	zPairagonResult  r;
+	zPairagonJob    *job;
+
+	if (!zReadFully(result, &r, sizeof(zPairagonResult))) {
+		zDie("worker pool: worker %d exited before finishing its job", w);
+	}
+	job         = &run->job[r.job];
+	job->score  = r.score;
+	job->time   = r.time;
+	job->length = r.length;
+	job->text   = zMalloc(r.length + 1, "zRunWorkerPool: text");
+	if (!zReadFully(result, job->text, r.length)) {
+		zDie("worker pool: worker %d exited before finishing its job", w);
+	}
+	job->text[r.length] = '\0';
+	job->done = true;
+	return r.job;
+}
+
+/* The first job at or after next that is not riding on a twin */
+static int zNextPairagonJob(zPairagonRun *run, int next) {
+	while (next < run->jobs && run->job[next].riding) next++;
+	return next;
+}
+
+static void zRunWorker(zPairagonRun *run, int command, int result) {
+	int id;
+
+	while (zReadFully(command, &id, sizeof(int)) && id >= 0) {
+		zRunPairagonJob(run, &run->job[id]);
+		zWritePairagonResult(run, result, id);
+		if (run->job[id].twin >= 0) zWritePairagonResult(run, result, run->job[id].twin);
+	}
+	fflush(stderr);
+	_exit(0);
+}
+
+void zRunWorkerPool(zPairagonRun *run, int workers) {
+	int            *command = zMalloc(workers*sizeof(int), "zRunWorkerPool: command");
+	pid_t          *pid     = zMalloc(workers*sizeof(pid_t), "zRunWorkerPool: pid");
+	struct pollfd  *result  = zMalloc(workers*sizeof(struct pollfd), "zRunWorkerPool: result");
+	int             next, busy = 0, stop = -1, units = 0;
+	int             w, v;
+
+	for (next = zNextPairagonJob(run, 0); next < run->jobs; next = zNextPairagonJob(run, next + 1)) units++;
+	if (workers > units) workers = units;
+
+	fflush(stdout); /* or every worker would write out the parent's buffer again */
+	fflush(stderr);
+	for (w = 0; w < workers; w++) {
+		int c[2], r[2];
+		if (pipe(c) != 0 || pipe(r) != 0) zDie("worker pool: cannot create pipes");
+		if ((pid[w] = fork()) < 0) zDie("worker pool: cannot fork");
+		if (pid[w] == 0) {
+			for (v = 0; v < w; v++) {
+				close(command[v]);
+				close(result[v].fd);
+			}
+			close(c[1]);
+			close(r[0]);
+			zRunWorker(run, c[0], r[1]);
+		}
+		close(c[0]);
+		close(r[1]);
+		command[w]       = c[1];
+		result[w].fd     = r[0];
+		result[w].events = POLLIN;
+	}
+
+	/* Prime every worker with a job */
+	next = zNextPairagonJob(run, 0);
+	for (w = 0; w < workers; w++) {
+		zWriteFully(command[w], &next, sizeof(int));
+		next = zNextPairagonJob(run, next + 1);
+		busy++;
+	}
+
+	while (busy > 0) {
+		if (poll(result, workers, -1) < 0) zDie("worker pool: poll failed");
+		for (w = 0; w < workers; w++) {
+			if (result[w].fd < 0 || result[w].revents == 0) continue;
+			/* the worker answers for a job and then for its twin, if any */
+			if (run->job[zReadPairagonResult(run, result[w].fd, w)].twin >= 0) {
+				zReadPairagonResult(run, result[w].fd, w);
+			}
+
+			if (next < run->jobs) {
+				zWriteFully(command[w], &next, sizeof(int));
+				next = zNextPairagonJob(run, next + 1);
+			} else {
+				zWriteFully(command[w], &stop, sizeof(int));
+				close(command[w]);
+				close(result[w].fd);
+				result[w].fd = -1;
+				busy--;
+			}
+		}
+		zWritePairagonEntries(run);
+	}
+	zWritePairagonEntries(run);
+
+	for (w = 0; w < workers; w++) {
+		int status;
+		waitpid(pid[w], &status, 0);
+	}
+	zFree(command);
+	zFree(pid);
+	zFree(result);
+}
@@ -0,0 +1,35 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/*****************************************************************************\
+ pairagon_index.c
+ Parse a genomic fasta file once into a genome index (see zGenomeIndex.h)
+ that pairagon maps instead of reading the fasta file on every run.
+
+\*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ZOE.h"
+
+extern int optind; /* from <unistd.h> */
+
+static const char* usage =
+	"Usage:\n"
+	"    pairagon-index genomic_file index_file\n\n"
+	"Arguments:\n"
+	"    genomic_file      - input genomic sequence(s) in Fasta format\n"
+	"    index_file        - genome index to write, pass it to pairagon as its genomic_file\n";
+
+int main (int argc, char *argv[]) {
+	zSetProgramName(argv[0]);
+	zParseOptions(&argc, argv);
+
+	if (zOption("h") || zOption("-help") || argc - optind != 2) {
+		fputs(usage, (argc - optind != 2) ? stderr : stdout);
+		exit((argc - optind != 2) ? -1 : 0);
+	}
+
+	zWriteGenomeIndex(argv[optind], argv[optind+1]);
+
+	zFreeOptions();
+	return 0;
+}
@@ -36,6 +36,7 @@ void zClearAlnFeature (zAlnFeature *f) {
 	f->cdna_end      = UNDEFINED_COOR;
 	f->strand        = UNDEFINED_STRAND; 
 	f->score         = MIN_SCORE; 
+	f->posterior     = -1;
 	f->padding       = 0;
 }
 
@@ -109,9 +110,12 @@ MANI: It looks ugly with %f.
 			(void)fprintf(stream,   "%-12s\t%12s\t%-3.1f\t%12s\t%12s\t%20s\t%12s\t%12s\t%20s\n",
 				        zStrIdx2Char(f->name), score, f->percent_identity, genomic_start, genomic_end, genomic_seqname, cdna_start, cdna_end, cdna_seqname);
 		}
-	} else {
+	} else if (f->posterior < 0) {
 		(void)fprintf(stream, "%-12s\t%12s\t%-3.1f\t%12s\t%12s\t%20s\t%12s\t%12s\t%20s\t%s\n",
 			zStrIdx2Char(f->name), score, f->percent_identity, genomic_start, genomic_end, genomic_seqname, cdna_start, cdna_end, cdna_seqname, strand);
+	} else {
+		(void)fprintf(stream, "%-12s\t%12s\t%-3.1f\t%12s\t%12s\t%20s\t%12s\t%12s\t%20s\t%s\t%.4f\n",
+			zStrIdx2Char(f->name), score, f->percent_identity, genomic_start, genomic_end, genomic_seqname, cdna_start, cdna_end, cdna_seqname, strand, f->posterior);
 	}
 	zFree(genomic_seqname);
 	zFree(cdna_seqname);
@@ -175,6 +179,7 @@ int zReadAlnFeature (FILE *stream, zAlnFeature *f, zDNA *genomic, zDNA *cdna) {
 	f->strand = zText2Strand(strand);
 	f->score  = zText2Score(score);
 	f->percent_identity  = zText2Score(percent_identity);
+	f->posterior = -1;
 	
 	/* subtract 1 from start and end, zoe uses 0-based coordinates internally 
 	f->genomic_start--;
@@ -245,6 +250,7 @@ void zCopyAlnFeature (const zAlnFeature *orig, zAlnFeature *copy) {
 	copy->length        = orig->length;
 	copy->score         = orig->score;
 	copy->percent_identity = orig->percent_identity;
+	copy->posterior     = orig->posterior;
 	copy->padding       = orig->padding;
 }
 
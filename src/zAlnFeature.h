@@ -45,6 +45,7 @@ struct zAlnFeature {
 	coor_t    length;
 	score_t   score;
 	score_t   percent_identity;
+	score_t   posterior;        /* negative unless zComputePosteriorProbability set it */
 	coor_t    padding;
 };
 
@@ -11,6 +11,7 @@
 
 #include "zDNA.h"
 #include "zHMM.h"
+#include "zGenomeIndex.h"
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -25,6 +26,10 @@ static bool MAP_READY = 0;
 static char S5MAP[256];
 static char S16MAP[256];
 
+/* letters of the s16 codes, and of their complements, for packed sequences */
+static const char S16ALPHABET[]   = "NTGKCYSBAWRDMHVN";
+static const char S16COMPLEMENT[] = "NACMGRSVTWYHKDBN";
+
 int zSetDNABlockSize(coor_t size){
 	if(BLOCK_FIXED == true){
 		return 0;
@@ -181,6 +186,9 @@ void zComplementDNA (zDNA *dna) {
 	else{
 		dna->complement = true;
 	}
+	if(dna->seq->packed != NULL){
+		dna->seq->alphabet = (dna->complement) ? S16COMPLEMENT : S16ALPHABET;
+	}
 	block = zListMoveFirst(&dna->seq->seq);
 	while(block != NULL){
 		zComplementDNABlock(block);
@@ -399,6 +407,32 @@ void zLoadDNAFromFasta(zDNA* dna, char* filename, char* snp_filename){
 	}
 }
 
+/* The sequence stays in the index mapping, which must outlive dna */
+
+void zLoadDNAFromGenomeIndex(zDNA* dna, struct zGenomeIndex* index, int contig){
+	const zGenomeIndexContig *entry;
+	const char *def;
+
+	if(contig < 0 || contig >= index->contigs){
+		zDie("zLoadDNAFromGenomeIndex: no contig %d in %s", contig, index->filename);
+	}
+	entry = &index->contig[contig];
+	dna->seq = zMalloc(sizeof(zSequence), "zLoadDNAFromGenomeIndex seq");
+	zInitPackedSequence(dna->seq, index->filename, dna,
+						(const unsigned char*)index->map + entry->seq_offset,
+						S16ALPHABET, entry->length, index->block_size);
+	dna->length = entry->length;
+	dna->gc = entry->gc;
+	dna->complement = false;
+	dna->gcs = zMalloc(sizeof(float)*dna->seq->block_count,"zLoadDNAFromGenomeIndex gcs");
+	memcpy(dna->gcs, index->map + entry->gcs_offset, sizeof(float)*dna->seq->block_count);
+
+	def = index->map + entry->def_offset;
+	dna->def = zMalloc(strlen(def)+1,"zLoadDNAFromGenomeIndex def");
+	(void)strcpy(dna->def, def);
+	dna->seqname = zGetSeqNameFromFastaHeader(dna->def);
+}
+
 int zLoadMultiDNAFromMultiFasta(zVec *multi_dna, char* filename, char* snp_filename){
 	if(snp_filename != NULL){
 		zDie("Sequence variation cannot be handled for multifasta files yet");
@@ -661,5 +695,10 @@ zDNA* zGetNextDNA(zDNAIterator* iterator) {
 	return zGetNextParent(iterator->seq_iterator);
 }
 
+void zFreeDNAIterator(zDNAIterator* iterator) {
+	zFree(iterator->seq_iterator);
+	zFree(iterator);
+}
+
 #endif
 
@@ -81,6 +81,7 @@ to zFastaFile for printing.
 \******************************************************************************/
 
 struct zHMM;
+struct zGenomeIndex;
 
 struct zDNA {
 	coor_t        length;
@@ -115,6 +116,7 @@ void zAntiDNA (zDNA*);
 void zSetDNAPadding(zDNA*,coor_t);
 
 void zLoadDNAFromFasta(zDNA* dna, char* filename,char* snp_filename);
+void zLoadDNAFromGenomeIndex(zDNA* dna, struct zGenomeIndex* index, int contig);
 int zLoadMultiDNAFromMultiFasta(zVec *multi_dna, char* filename, char* snp_filename);
 char zGetDNAUCSeq(zDNA* dna, coor_t pos);
 char zGetDNASeq(zDNA* dna, coor_t pos);
@@ -147,5 +149,6 @@ typedef struct zDNAIterator zDNAIterator;
 
 zDNAIterator* zGetDNAIterator(char* filename, char* snp_filename);
 zDNA* zGetNextDNA(zDNAIterator* iterator);
+void zFreeDNAIterator(zDNAIterator* iterator);
 
 #endif
@@ -0,0 +1,167 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/******************************************************************************\
+  zGenomeIndex.c - part of the ZOE library for genomic analysis
+
+\******************************************************************************/
+
+#ifndef ZOE_GENOME_INDEX_C
+#define ZOE_GENOME_INDEX_C
+
+#include "zGenomeIndex.h"
+#include "zDNA.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+bool zIsGenomeIndex (const char *filename) {
+	FILE *fp;
+	char  magic[8];
+	bool  is_index = false;
+
+	if ((fp = fopen(filename, "rb")) == NULL) return false;
+	if (fread(magic, 1, sizeof(magic), fp) == sizeof(magic)
+		&& memcmp(magic, GENOME_INDEX_MAGIC, sizeof(magic)) == 0) {
+		is_index = true;
+	}
+	fclose(fp);
+	return is_index;
+}
+
+zGenomeIndex* zOpenGenomeIndex (const char *filename) {
+	int                        fd;
+	struct stat                stbuf;
+	void                      *map;
+	const zGenomeIndexHeader  *header;
+	zGenomeIndex              *index;
+
+	if ((fd = open(filename, O_RDONLY)) < 0) {
+		zDie("genome index error (%s)", filename);
+	}
+	if (fstat(fd, &stbuf) != 0 || (size_t)stbuf.st_size < sizeof(zGenomeIndexHeader)) {
+		zDie("genome index too short (%s)", filename);
+	}
+	map = mmap(NULL, stbuf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) zDie("can't map genome index (%s)", filename);
+
+	header = (const zGenomeIndexHeader*)map;
+	if (memcmp(header->magic, GENOME_INDEX_MAGIC, sizeof(header->magic)) != 0) {
+		zDie("%s is not a genome index", filename);
+	}
+	if (header->contigs < 1 || header->block_size < 1 || header->table_offset < 0
+		|| (size_t)header->table_offset + header->contigs*sizeof(zGenomeIndexContig) > (size_t)stbuf.st_size) {
+		zDie("genome index %s is truncated or corrupt", filename);
+	}
+
+	index = zMalloc(sizeof(zGenomeIndex), "zOpenGenomeIndex index");
+	index->filename   = zMalloc(strlen(filename)+1, "zOpenGenomeIndex filename");
+	strcpy(index->filename, filename);
+	index->map        = (const char*)map;
+	index->size       = stbuf.st_size;
+	index->contigs    = header->contigs;
+	index->block_size = header->block_size;
+	index->contig     = (const zGenomeIndexContig*)(index->map + header->table_offset);
+	return index;
+}
+
+void zCloseGenomeIndex (zGenomeIndex *index) {
+	munmap((void*)index->map, index->size);
+	zFree(index->filename);
+	zFree(index);
+}
+
+static void zPadGenomeIndex (FILE *fp) {
+	while (ftell(fp) % 8 != 0) fputc(0, fp);
+}
+
+static void zWriteGenomeIndexContig (FILE *fp, zDNA *dna, zGenomeIndexContig *entry) {
+	coor_t  block_size = dna->seq->block_size;
+	coor_t  pos, end;
+	long    blocks, b, gc, unmasked;
+	float   block_gc;
+	char    c;
+	int     code, byte = 0;
+
+	entry->length = dna->length;
+	entry->gc     = dna->gc;
+
+	entry->def_offset = ftell(fp);
+	fwrite(dna->def, 1, strlen(dna->def)+1, fp);
+	zPadGenomeIndex(fp);
+
+	/* same windows and arithmetic as zReadDNASequence, at least one window */
+	entry->gcs_offset = ftell(fp);
+	blocks = (dna->length + block_size - 1)/block_size;
+	if (blocks == 0) blocks = 1;
+	for (b = 0; b < blocks; b++) {
+		gc = unmasked = 0;
+		end = MIN(dna->length, (b+1)*block_size);
+		for (pos = b*block_size; pos < end; pos++) {
+			c = zGetDNASeq(dna, pos);
+			if (c == 'A' || c == 'C' || c == 'G' || c == 'T') unmasked++;
+			if (c == 'C' || c == 'G') gc++;
+		}
+		block_gc = (float)gc/unmasked;
+		fwrite(&block_gc, sizeof(float), 1, fp);
+	}
+	zPadGenomeIndex(fp);
+
+	/* anything outside of the s16 alphabet is stored as N */
+	entry->seq_offset = ftell(fp);
+	for (pos = 0; pos < dna->length; pos++) {
+		code = zGetDNAS16(dna, pos);
+		if (code < 0) code = 15;
+		if (pos & 1) {
+			fputc(byte | (code << 4), fp);
+		} else {
+			byte = code;
+		}
+	}
+	if (dna->length & 1) fputc(byte, fp);
+	zPadGenomeIndex(fp);
+
+	if (ferror(fp)) zDie("zWriteGenomeIndex write error");
+}
+
+void zWriteGenomeIndex (char *fasta_file, const char *index_file) {
+	FILE                *fp;
+	zDNAIterator        *iterator;
+	zDNA                *dna;
+	zGenomeIndexHeader   header;
+	zGenomeIndexContig  *table = NULL;
+	int                  size = 0;
+
+	if ((fp = fopen(index_file, "wb")) == NULL) {
+		zDie("can't write genome index (%s)", index_file);
+	}
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, GENOME_INDEX_MAGIC, sizeof(header.magic));
+	fwrite(&header, sizeof(header), 1, fp); /* rewritten once the table is known */
+
+	iterator = zGetDNAIterator(fasta_file, NULL);
+	while ((dna = zGetNextDNA(iterator)) != NULL) {
+		if (header.contigs == size) {
+			size  = (size == 0) ? 16 : 2*size;
+			table = zRealloc(table, size*sizeof(zGenomeIndexContig), "zWriteGenomeIndex table");
+		}
+		header.block_size = dna->seq->block_size;
+		memset(&table[header.contigs], 0, sizeof(zGenomeIndexContig)); /* no stray padding bytes */
+		zWriteGenomeIndexContig(fp, dna, &table[header.contigs]);
+		header.contigs++;
+		zFreeDNA(dna);
+		zFree(dna);
+	}
+	zFreeDNAIterator(iterator);
+	if (header.contigs == 0) zDie("no sequences in %s", fasta_file);
+
+	header.table_offset = ftell(fp);
+	fwrite(table, sizeof(zGenomeIndexContig), header.contigs, fp);
+	fseek(fp, 0, SEEK_SET);
+	fwrite(&header, sizeof(header), 1, fp);
+	if (ferror(fp) || fclose(fp) != 0) zDie("zWriteGenomeIndex write error (%s)", index_file);
+	zFree(table);
+}
+
+#endif
@@ -0,0 +1,72 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/******************************************************************************\
+zGenomeIndex.h - part of the ZOE library for genomic analysis
+
+ A genome index is a fasta file that has already been parsed: every contig is
+ stored as s16 codes (see zDNA.h), two per byte, next to its definition line,
+ its gc level and the gc level of each block. The file is mapped read-only,
+ so loading a contig costs no parsing and the pages are shared between all
+ the processes that map the same index.
+
+	zWriteGenomeIndex(fasta_file, index_file);   once, see pairagon-index
+
+	zGenomeIndex *index = zOpenGenomeIndex(index_file);
+	zLoadDNAFromGenomeIndex(&dna, index, 0);     see zDNA.h
+	...
+	zFreeDNA(&dna);
+	zCloseGenomeIndex(index);
+
+ The layout is native endian and native word size: an index is meant to be
+ built on the machine (or the kind of machine) that reads it.
+
+	header    magic[8] "ZOEGIDX1", contigs, block size, table offset
+	contig    definition line + '\0', gc of each block, packed sequence
+	...
+	table     one zGenomeIndexContig per contig
+
+ Every section starts on an 8 byte boundary.
+
+\******************************************************************************/
+
+#ifndef ZOE_GENOME_INDEX_H
+#define ZOE_GENOME_INDEX_H
+
+#include <stdio.h>
+
+#include "zTools.h"
+
+#define GENOME_INDEX_MAGIC "ZOEGIDX1"
+
+struct zGenomeIndexHeader {
+	char  magic[8];
+	long  contigs;
+	long  block_size;
+	long  table_offset;
+};
+typedef struct zGenomeIndexHeader zGenomeIndexHeader;
+
+struct zGenomeIndexContig {
+	long   def_offset;   /* '\0' terminated definition line, as in zDNA.def */
+	long   length;       /* letters */
+	long   gcs_offset;   /* (length + block_size - 1)/block_size floats, at least 1 */
+	long   seq_offset;   /* (length + 1)/2 bytes */
+	float  gc;           /* over the whole contig */
+};
+typedef struct zGenomeIndexContig zGenomeIndexContig;
+
+struct zGenomeIndex {
+	char                      *filename;
+	const char                *map;
+	size_t                     size;
+	int                        contigs;
+	coor_t                     block_size;
+	const zGenomeIndexContig  *contig;
+};
+typedef struct zGenomeIndex zGenomeIndex;
+
+bool          zIsGenomeIndex (const char*);
+zGenomeIndex* zOpenGenomeIndex (const char*);
+void          zCloseGenomeIndex (zGenomeIndex*);
+void          zWriteGenomeIndex (char*, const char*);
+
+#endif
@@ -65,6 +65,7 @@ int zIsCDnaOverhang(zStrIdx state);
 
 /* Functions that iterate through the states of the HMM and get the index of the right state */
 
+int zGetStateByName(zHMM* hmm, const char* name);
 int zGetU2Donor(zHMM* hmm);
 int zGetU2Acceptor(zHMM* hmm);
 int zGetU12Donor(zHMM* hmm);
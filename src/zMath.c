@@ -12,6 +12,10 @@
 #include <assert.h>
 #include "zMath.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 const int zPOWER[6][11] = {
 	{        1,        0,        0,        0,        0,        0,        0,        0,        0,        0,        0},
 	{        1,        1,        1,        1,        1,        1,        1,        1,        1,        1,        1},
@@ -55,6 +59,74 @@ score_t zFloatwiseScoreAdd(score_t p, score_t q) {
 	else        return p + zFloatwiseScoreAddHelper(-d);
 }
 
+/* zLogAddTable is exact at multiples of 1/zLogAddScale and interpolated *
+ * linearly in between. The array version does the same arithmetic in the *
+ * same order, two scores at a time with SSE2, so either one gives the    *
+ * same sums bit for bit                                                  */
+
+extern double zLogAddScale;
+extern double zLogAddMax;
+extern double zLogAddTable[];
+extern int    zLogAddCount;
+
+/* Unlike zFloatwiseScoreAdd, only MIN_SCORE (and whatever was added to it) *
+ * counts as zero: forward sums over long flanks drop far below -10000. So  *
+ * does NaN, the score of a transition into a state with a zero mean        *
+ * duration, which the Viterbi comparisons never take either                */
+
+score_t zLogAddScore(score_t p, score_t q) {
+	score_t hi, t, a;
+	int     i;
+
+	if (!(p > MIN_SCORE)) return q;
+	if (!(q > MIN_SCORE)) return p;
+	hi = (p > q) ? p : q;
+	t  = (hi - ((p > q) ? q : p))*zLogAddScale;
+	if (t >= -zLogAddMax*zLogAddScale) return hi;
+	i = (int)t;
+	a = zLogAddTable[i];
+	return hi + (a + (t - i)*(zLogAddTable[i+1] - a));
+}
+
+void zLogAddScores(score_t *sum, const score_t *add, int n) {
+	int k = 0;
+
+#ifdef __SSE2__
+	__m128d vfloor = _mm_set1_pd(MIN_SCORE);
+	__m128d vscale = _mm_set1_pd(zLogAddScale);
+	__m128d vlimit = _mm_set1_pd(-zLogAddMax*zLogAddScale);
+	for (; k + 2 <= n; k += 2) {
+		__m128d q  = _mm_loadu_pd(sum + k);
+		__m128d p  = _mm_loadu_pd(add + k);
+		__m128d hi = _mm_max_pd(p, q);
+		__m128d t  = _mm_mul_pd(_mm_sub_pd(hi, _mm_min_pd(p, q)), vscale);
+		__m128d near = _mm_cmplt_pd(t, vlimit);
+		__m128i idx;
+		__m128d i, a, b, r;
+		int     i0, i1;
+
+		/* far apart scores look up entry 0, the result is hi for them anyway */
+		t   = _mm_and_pd(t, near);
+		idx = _mm_cvttpd_epi32(t);
+		i0  = _mm_cvtsi128_si32(idx);
+		i1  = _mm_cvtsi128_si32(_mm_srli_si128(idx, 4));
+		i   = _mm_cvtepi32_pd(idx);
+		a   = _mm_set_pd(zLogAddTable[i1],   zLogAddTable[i0]);
+		b   = _mm_set_pd(zLogAddTable[i1+1], zLogAddTable[i0+1]);
+		r   = _mm_add_pd(hi, _mm_add_pd(a, _mm_mul_pd(_mm_sub_pd(t, i), _mm_sub_pd(b, a))));
+		r   = _mm_or_pd(_mm_and_pd(near, r), _mm_andnot_pd(near, hi));
+
+		/* a score at or below MIN_SCORE, or NaN, leaves the other one as it is */
+		r   = _mm_or_pd(_mm_and_pd(_mm_cmpngt_pd(q, vfloor), p), _mm_andnot_pd(_mm_cmpngt_pd(q, vfloor), r));
+		r   = _mm_or_pd(_mm_and_pd(_mm_cmpngt_pd(p, vfloor), q), _mm_andnot_pd(_mm_cmpngt_pd(p, vfloor), r));
+		_mm_storeu_pd(sum + k, r);
+	}
+#endif
+	for (; k < n; k++) {
+		sum[k] = zLogAddScore(add[k], sum[k]);
+	}
+}
+
 double zLnFactorial (int n) {
 	double f;
 	
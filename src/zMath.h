@@ -24,11 +24,17 @@ functions for floats and scores as well as some common distributions.
 	s = zScoreNormal(mean, std_dev, x);
 	s = zScoreLinear(slope, intercept, x);
 
+zFloatwiseScoreAdd and zLogAddScore add two scores as probabilities. The
+first looks up a 0.01 grid, the second interpolates a finer one for
+forward and backward sums; zLogAddScores adds a whole array into another.
+
 \******************************************************************************/
 
 score_t zFloat2Score (double);
 double  zScore2Float (score_t);
 score_t zFloatwiseScoreAdd(score_t, score_t);
+score_t zLogAddScore(score_t, score_t);
+void    zLogAddScores(score_t*, const score_t*, int);
 double  zLog2 (double);
 double  zLnFactorial (int);
 score_t zScoreGeometric (double, double, double);
@@ -10003,3 +10003,810 @@ float zFloatAddTable[]={
 0.01409170310944318771362304687500};
 
 int zFloatAddCount = 10000;
+
+double zLogAddScale = 8.00000000000000000000000000000000;
+double zLogAddMax = -100.00000000000000000000000000000000;
+double zLogAddTable[]={
+10.00000000000000000000000000000000,
+9.93763537988524170430082449456677,
+9.87554151445954353505385370226577,
+9.81371838847939059746749990154058,
+9.75216597654146966078769764862955,
+9.69088424308647411464789911406115,
+9.62987314240445435586934763705358,
+9.56913261864167274950432329205796,
+9.50866260580896494047919986769557,
+9.44846302779166435925617406610399,
+9.38853379836098689281698170816526,
+9.32887482118695920974005275638774,
+9.26948598985285165952063834993169,
+9.21036718787109620620867644902319,
+9.15151828870070893628962949151173,
+9.09293915576621714080829406157136,
+9.03462964247804123374407936353236,
+8.97658959225439012641345470910892,
+8.91881883854460433269650820875540,
+8.86131720485396279229917126940563,
+8.80408450476995874112162709934637,
+8.74712054199003219423502741847187,
+8.69042511035069864533397776540369,
+8.63399799385816102414992201374844,
+8.57783896672030898855609848396853,
+8.52194779338013930214401625562459,
+8.46632422855057598098937887698412,
+8.41096801725067599875274026999250,
+8.35587889484322055011489283060655,
+8.30105658707365989812387851998210,
+8.24650081011042423995149874826893,
+8.19221127058657927477725024800748,
+8.13818766564279272301973833236843,
+8.08442968297163311319764034124091,
+8.03093700086315109842871606815606,
+7.97770928825179215237994867493398,
+7.92474620476451541151163837639615,
+7.87204740077023856770210841204971,
+7.81961251743047647266848798608407,
+7.76744118675123651485137088457122,
+7.71553303163612014259342686273158,
+7.66388766594061365822199149988592,
+7.61250469452756739485721482196823,
+7.56138371332383130152265948709100,
+7.51052430937805226562886673491448,
+7.45992606091957277669735049130395,
+7.40958853741847356388916523428634,
+7.35951129964669270577815041178837,
+7.30969389974021233058465440990403,
+7.26013588126232622954603357356973,
+7.21083677926793509271874427213334,
+7.16179612036884893910837490693666,
+7.11301342280011361651759216329083,
+7.06448819648730541587156039895490,
+7.01621994311479735273451296961866,
+6.96820815619495537163174958550371,
+6.92045232113826980224757789983414,
+6.87295191532438831671925072441809,
+6.82570640817402196631746846833266,
+6.77871526122173317929764380096458,
+6.73197792818954088289729043026455,
+6.68549385506137650025948460097425,
+6.63926248015831266258146570180543,
+6.59328323421458595277044878457673,
+6.54755554045438969978931709192693,
+6.50207881466937909209491408546455,
+6.45685246529691614369994567823596,
+6.41187589349898789947701516211964,
+6.36714849324183251866315913503058,
+6.32266965137617997783081591478549,
+6.27843874771814824953253264538944,
+6.23445515513074433044948818860576,
+6.19071823960595235547543779830448,
+6.14722736034739014598926587495953,
+6.10398186985350399424987699603662,
+6.06098111400129102577238882076927,
+6.01822443213054381061510866857134,
+5.97571115712853462298426165943965,
+5.93344061551519885711059032473713,
+5.89141212752871812341481927433051,
+5.84962500721156253291610482847318,
+5.80807856249688647665152529953048,
+5.76677209529532319720601662993431,
+5.72570490158212486164757137885317,
+5.68487627148462681958562825457193,
+5.64428548937001739460583848995157,
+5.60393183393342741993592426297255,
+5.56381457828623915418120304821059,
+5.52393299004466964419179930700921,
+5.48428633141859211974633581121452,
+5.44487385930052258942168919020332,
+5.40569482535481959928347350796685,
+5.36674847610704652822732896311209,
+5.32803405303346355736948680714704,
+5.28955079265064753712977108079940,
+5.25129792660522287661706286598928,
+5.21327468176366437546676024794579,
+5.17548028030216755723813548684120,
+5.13791393979655985901899839518592,
+5.10057487331225267723766592098400,
+5.06346228949415877451656342600472,
+5.02657539265664432548419426893815,
+4.98991338287341434920563187915832,
+4.95347545606735462087044652434997,
+4.91726080410030874645599396899343,
+4.88126861486276997226241292082705,
+4.84549807236344154404150685877539,
+4.80994835681871624188943314948119,
+4.77461864474196051588705813628621,
+4.73950810903269292850836791330948,
+4.70461591906555209874341016984545,
+4.66994124077907279968258080771193,
+4.63548323676426932138383563142270,
+4.60124106635297547285290420404635,
+4.56721388570595188127754227025434,
+4.53340084790073216680639234255068,
+4.49980110301918845294721904792823,
+4.46641379823481621258451923495159,
+4.43323807789970913972865673713386,
+4.40027308363120983614180659060366,
+4.36751795439823986555438750656322,
+4.33497182660725943748047939152457,
+4.30263383418787892509271841845475,
+4.27050310867809201909039984457195,
+4.23857877930911275399239457328804,
+4.20685997308980486053542335866950,
+4.17534581489070699689136745291762,
+4.14403542752761300249630949110724,
+4.11292793184471339174024251406081,
+4.08202244679729453480376832885668,
+4.05131808953394756400712140020914,
+4.02081397547831542738094867672771,
+3.99050921841033989778679824667051,
+3.96040293054702319253124187525827,
+3.93049422262265046867923956597224,
+3.90078220396851005347116370103322,
+3.87126598259208121177721295680385,
+3.84194466525565747616610678960569,
+3.81281735755443440538670074602123,
+3.78388316399404267542649904498830,
+3.75514118806747543288793167448603,
+3.72659053233146853045809621107765,
+3.69823029848228745919413995579816,
+3.67005958743087923323855648050085,
+3.64207749937747404800347794662230,
+3.61428313388552524543229083064944,
+3.58667558995505686425531166605651,
+3.55925396609536415226671124401037,
+3.53201736039708791281555022578686,
+3.50496487060365602417277841595933,
+3.47809559418203484426612703828141,
+3.45140862839288287133854282728862,
+3.42490307035999119733560291933827,
+3.39857801713909291052573280467186,
+3.37243256578597394579333013098221,
+3.34646581342391780111711341305636,
+3.32067685731047745889554789755493,
+3.29506479490353365591204237716738,
+3.26962872392668391086090196040459,
+3.24436774243392145322673059126828,
+3.21928094887362359344251672155224,
+3.19436744215182644168748993251938,
+3.16962632169479707755499475752003,
+3.14505668751090139423354230530094,
+3.12065764025174319229449793056119,
+3.09642828127259095438716940407176,
+3.07236771269210295898233198386151,
+3.04847503745130588015399553114548,
+3.02474935937185884782252287550364,
+3.00118978321360252436988957924768,
+2.97779541473136566409607439709362,
+2.95456536073104736317418428370729,
+2.93149872912498610233456020068843,
+2.90859462898655962703742261510342,
+2.88585217060409959799471835140139,
+2.86327046553403841144813668506686,
+2.84084862665333570674874863470905,
+2.81858576821118278488143005233724,
+2.79648100587994807852965095662512,
+2.77453345680542406981317071767990,
+2.75274223965629794008691533235833,
+2.73110647467293787826747575309128,
+2.70962528371541866434313305944670,
+2.68829779031081184115237192600034,
+2.66712311969977777792450979177374,
+2.64610039888238723904123617103323,
+2.62522875666326127586103211797308,
+2.60450732369595039372711653413717,
+2.58393523252660139988279297540430,
+2.56351161763691770545392500935122,
+2.54323561548636600804229601635598,
+2.52310636455371550823656434658915,
+2.50312300537780441089807936805300,
+2.48328468059763318720456481969450,
+2.46359053499174951440409131464548,
+2.44403971551688536933966133801732,
+2.42463137134594486354899345315062,
+2.40536465390524778484859780292027,
+2.38623871691109590287283026555087,
+2.36725271640563006414481606043410,
+2.34840581079201848879733915964607,
+2.32969716086892120188167609740049,
+2.31112592986431897301713433989789,
+2.29269128346859707434646225010511,
+2.27439238986701841582771521643735,
+2.25622841977147636782774497987702,
+2.23819854645159921346930786967278,
+2.22030194576517514448710244323593,
+2.20253779618794087724609198630787,
+2.18490527884268281866297911619768,
+2.16740357752770806953890314616729,
+2.15003187874466128448602830758318,
+2.13278937172569049707249178027268,
+2.11567524845998233828936463396531,
+2.09868870371967153332093403150793,
+2.08182893508508648494625958846882,
+2.06509514296942287003844285209198,
+2.04848653064274666135702318570111,
+2.03200230425541450429705037095118,
+2.01564167286087148056594742229208,
+1.99940384843785246005154476733878,
+1.98328804591196861117907701554941,
+1.96729348317671970391984359594062,
+1.95141938111390178534065853455104,
+1.93566496361343443055602620006539,
+1.92002945759261023361830211797496,
+1.90451209301478541213725748093566,
+1.88911210290747089146634607459418,
+1.87382872337988937161412650311831,
+1.85866119363996995517140931042377,
+1.84360875601077145446993199584540,
+1.82867065594639632841733600798761,
+1.81384614204732974584999283251818,
+1.79913446607525417952899715601234,
+1.78453488296735440776785708294483,
+1.77004665085007362179680967528839,
+1.75566903105236082893725324538536,
+1.74140128811841576883523430296918,
+1.72724268981990447535679322754731,
+1.71319250716770277165323932422325,
+1.69925001442312373356458010675851,
+1.68541448910866442645328788785264,
+1.67168521201826680844249040092109,
+1.65806146722710590069027603021823,
+1.64454254210089767518354619824095,
+1.63112772730474642202125323819928,
+1.61781631681152826551794987608446,
+1.60460760790983258949893297540257,
+1.59150090121142784305163786484627,
+1.57849550065831434331187210773351,
+1.56559071352931233889194118091837,
+1.55278585044625083710911894741002,
+1.54008022537969169185601003846386,
+1.52747315565425823002954075491289,
+1.51496396195355709224372731114272,
+1.50255196832465776068943341670092,
+1.49023650218220038432548335549654,
+1.47801689431209615221973763254937,
+1.46589247887483020704735281469766,
+1.45386259340838130960094076726818,
+1.44192657883075980862486176192760,
+1.43008377944218079136362575809471,
+1.41833354292685243080995860509574,
+1.40667522035440506478209954366321,
+1.39510816618096633590084820752963,
+1.38363173824988150428794142499100,
+1.37224529779208426205627802119125,
+1.36094820942611693936896699597128,
+1.34973984115784340076515945838764,
+1.33861956437978557588053263316397,
+1.32758675387017266444900087662973,
+1.31664078779165172328191601991421,
+1.30578104768968916715721206855960,
+1.29500691849064897276377905654954,
+1.28431778849958933008679196063895,
+1.27371304939773111186696041841060,
+1.26319209623965544864176990813576,
+1.25275432745019998925783966114977,
+1.24239914482107649540409965993604,
+1.23212595350719933406935524544679,
+1.22193416202274485193868258647854,
+1.21182318223694429626391411147779,
+1.20179242936961494514491732843453,
+1.19184132198641834499142078129807,
+1.18196928199386896984890427120263,
+1.17217573463410706935405869444367,
+1.16246010847940017818302749219583,
+1.15282183542643057450050037004985,
+1.14326035069032139190881025569979,
+1.13377509279845911649431400292087,
+1.12436550358405917826587483432377,
+1.11503102817954036218850433215266,
+1.10577111500965097334869824408088,
+1.09658521578440804056242541264510,
+1.08747278549181247697674734808970,
+1.07843328239035751714425259706331,
+1.06946616800136617975169883720810,
+1.06057090710108092856955863680923,
+1.05174696771261655392493139515864,
+1.04299382109768545845440712582786,
+1.03431094174816906594571719324449,
+1.02569780737748428300903924537124,
+1.01715389891179408543564477440668,
+1.00867870048104446567549530300312,
+1.00027169940982485485392317059450,
+0.99193238620808166228215441151406,
+0.98366025456164618567811430693837,
+0.97545480132265338646391228394350,
+0.96731552649975593993758593569510,
+0.95924193324822137896035201265477,
+0.95123352785989534474708761990769,
+0.94328981975299042161964280239772,
+0.93541032146177505168793686607387,
+0.92759454862610302150471852655755,
+0.91984201998082149032143206568435,
+0.91215225734506732990780619729776,
+0.90452478561142168889119830055279,
+0.89695913273495420092729091265937,
+0.88945482972215206274313459289260,
+0.88201141061974330792594400918460,
+0.87462841250339407039859906944912,
+0.86730537546631802925389820302371,
+0.86004184260777594150937375161448,
+0.85283736002147159105390983313555,
+0.84569147678386813460349458182463,
+0.83860374494239420251062711031409,
+0.83157371950355796208498304622481,
+0.82460095842100156193765769785387,
+0.81768502258343922495242850345676,
+0.81082547580252939400935474623111,
+0.80402188480067626752401110934443,
+0.79727381919874262816705368095427,
+0.79058085150369028504258039902197,
+0.78394255709616644800519225100288,
+0.77735851421800439275955341145163,
+0.77082830395966517311734378381516,
+0.76435151024763547944473884854233,
+0.75792771983173756744633919879561,
+0.75155652227239844176409633291769,
+0.74523750992786608193796382693108,
+0.73897027794137704059806992518133,
+0.73275442422825853849843724674429,
+0.72658954946299114663332829877618,
+0.72047525706625059616072803692077,
+0.71441115319186654364358446400729,
+0.70839684671377189939533991491771,
+0.70243194921290896814980442286469,
+0.69651607496408585173952587865642,
+0.69064884092281364491583417475340,
+0.68482986671211965035155344594386,
+0.67905877460930819111695200263057,
+0.67333518953271642715208145091310,
+0.66765873902842942655411206942517,
+0.66202905325699035188335983548313,
+0.65644576498007189968575403327122,
+0.65090850954713419529440443511703,
+0.64541692488207902389518721975037,
+0.63997065146986320538502468480146,
+0.63456933234312229430429397325497,
+0.62921261306878017993682306041592,
+0.62390014173461938451481501033413,
+0.61863156893589965612534342653817,
+0.61340654776189984520584630445228,
+0.60822473378252539522037523056497,
+0.60308578503486165445224287395831,
+0.59798936200974261989671276751324,
+0.59293512763833366996379936608719,
+0.58792274727868931716301403866964,
+0.58295188870233460853853557637194,
+0.57802222208085307642022598884068,
+0.57313341997245148551343163489946,
+0.56828515730857687149324419806362,
+0.56347711138049672019434410685790,
+0.55870896182593443590747028792975,
+0.55398039061566939356140437666909,
+0.54929108204019339023460588578018,
+0.54464072269635432910206418455346,
+0.54002900147402277397645775636192,
+0.53545560954277848786375670897542,
+0.53092024033860385490157796084532,
+0.52642258955062115610701312107267,
+0.52196235510781252564527221693425,
+0.51753923716580463310066306803492,
+0.51315293809363204946549785745447,
+0.50880316246056667139896489970852,
+0.50448961702293149134135319400229,
+0.50021201071097498580542151103145,
+0.49597005461574728002460688003339,
+0.49176346197601733534199297537270,
+0.48759194816521467252812271908624,
+0.48345523067840096009817330013902,
+0.47935302911926996882741036642983,
+0.47528506518717966722320511507860,
+0.47125106266422661649428960117802,
+0.46725074740233646375386911131500,
+0.46328384731039190524981563612528,
+0.45935009234141682687990737576911,
+0.45544921447976199901930272062600,
+0.45158094772835505326114002855320,
+0.44774502809596627983523831062485,
+0.44394119358453437707012767532433,
+0.44016918417651551553859690102399,
+0.43642874182226870649614625108370,
+0.43271961042749207404511935237679,
+0.42904153584069271154532998480136,
+0.42539426584070222370215219598322,
+0.42177755012423484570760479073215,
+0.41819114029346954319876772387943,
+0.41463478984370988333907348533103,
+0.41110825415105123337156101115397,
+0.40761129046011407295324602273467,
+0.40414365787182254807774484106631,
+0.40070511733120639519256656058133,
+0.39729543161527797190402111482399,
+0.39391436532093543343435726455937,
+0.39056168485291420378047178019187,
+0.38723715841179406904615234452649,
+0.38394055598204751555968528009544,
+0.38067164932012925726567686979251,
+0.37743021194263354223252804331423,
+0.37421601911448532096216013087542,
+0.37102884783717243744050051645900,
+0.36786847683704942957305661366263,
+0.36473468655368190827203989101690,
+0.36162725912822057949824738898315,
+0.35854597839186169716541030538792,
+0.35549062985433421690828481587232,
+0.35246100069244012953362243933952,
+0.34945687973865163789000121141726,
+0.34647805746975585128311081462016,
+0.34352432599556009806818224205927,
+0.34059547904763687320439657923998,
+0.33769131196812113282490486199094,
+0.33481162169857797694660916931753,
+0.33195620676889120437280666919833,
+0.32912486728624706922019527155499,
+0.32631740492413213727829202071007,
+0.32353362291140164153091518528527,
+0.32077332602140429251846853730967,
+0.31803632056114994330897616237053,
+0.31532241436054858629844943607168,
+0.31263141676167582883039131047553,
+0.30996313860812235718711349363730,
+0.30731739223436843611025892641919,
+0.30469399145524522776184994654614,
+0.30209275155541787105661910572962,
+0.29951348927894472229382927253027,
+0.29695602281888899831585604260908,
+0.29442017180696827827190986681671,
+0.29190575730327145143050415754260,
+0.28941260178605043851263189935707,
+0.28694052914151191302494225965347,
+0.28448936465372720583388854720397,
+0.28205893499455458872660074121086,
+0.27964906821362411903919564792886,
+0.27725959372840019989681081824529,
+0.27489034231425601984000195443514,
+0.27254114609465246443775754414673,
+0.27021183853133384777933656550886,
+0.26790225441459863953141962156224,
+0.26561222985360877224536579888081,
+0.26334160226678132721289671280829,
+0.26109021037220175864845828073157,
+0.25885789417811244650380331222550,
+0.25664449497345270811976547520317,
+0.25444985531845104587134187568154,
+0.25227381903527335005321674543666,
+0.25011623119872822273990209396288,
+0.24797693812701832039024907317071,
+0.24585578737254959458269354399818,
+0.24375262771281350215879513143591,
+0.24166730914128212170943754699692,
+0.23959968285840882451509514794452,
+0.23754960126263116593214874683326,
+0.23551691794147441849638369149034,
+0.23350148766267783684291714507708,
+0.23150316636538881276408119447296,
+0.22952181115139652645140699860349,
+0.22755728027644733790779696391837,
+0.22560943314158354855436527941492,
+0.22367813028454508472719908240833,
+0.22176323337124026480182692466769,
+0.21986460518724385004851740177401,
+0.21798210962937139556494514636142,
+0.21611561169728521480948302269098,
+0.21426497748517484009944666922820,
+0.21243007417346454479556427941134,
+0.21061077002060568652552774437936,
+0.20880693435489144915706560823310,
+0.20701843756633500626129773536377,
+0.20524515109860974604316652403213,
+0.20348694744101922249335245851398,
+0.20174370012053957634812206833885,
+0.20001528369390608741440473750117,
+0.19830157373974108270253680075257,
+0.19660244685075609072377744723781,
+0.19491778062597725496019052116026,
+0.19324745366304271754209764822008,
+0.19159134555053775050836861737480,
+0.18994933686039264242317869957333,
+0.18832130914031322554968994609226,
+0.18670714490628839699049024147826,
+0.18510672763511487604048966204573,
+0.18351994175698740918711848735256,
+0.18194667264815808649380812767049,
+0.18038680662360492834572767151258,
+0.17884023092977691105076587518852,
+0.17730683373738387320628362431307,
+0.17578650413423563270143290537817,
+0.17427913211811085769653573152027,
+0.17278460858971075864154443024745,
+0.17130282534562146778966962301638,
+0.16983367507135893603731346956920,
+0.16837705133442631977302994528145,
+0.16693284857745807614470834323583,
+0.16550096211137751978093035631900,
+0.16408128810861297153245175195480,
+0.16267372359637602419191182434588,
+0.16127816644996118000676688097883,
+0.15989451538610177649957222456578,
+0.15852266995638952806757515645586,
+0.15716253054070355998916852513503,
+0.15581399834072237609028377391951,
+0.15447697537345614349213462901389,
+0.15315136446484034493664694309700,
+0.15183706924335618748678200518043,
+0.15053399413371693071894696913660,
+0.14924204435058474604858247403172,
+0.14796112589233159639867665191559,
+0.14669114553486004015603327843564,
+0.14543201082544340851931963243260,
+0.14418363007663606567554381854279,
+0.14294591236020356972424849573144,
+0.14171876750110770637469670418795,
+0.14050210607153737485397471118631,
+0.13929583938497916428822520629183,
+0.13809987949032490051060051428067,
+0.13691413916602879208284093692782,
+0.13573853191430532150185683804011,
+0.13457297195536180312025464900216,
+0.13341737422169064331001209211536,
+0.13227165435237825397152278128488,
+0.13113572868747738753292253477412,
+0.13000951426240556219049437913782,
+0.12889292880239247574003513818752,
+0.12778589071696294654501002696634,
+0.12668831909447239580934763125697,
+0.12560013369665032345601218821685,
+0.12452125495323440595996089541586,
+0.12345160395659117436029106329443,
+0.12239110245641805774230448378148,
+0.12133967285445472483740303459854,
+0.12029723819925094985272551184607,
+0.11926372218096947808163577064988,
+0.11823904912622691665280427741891,
+0.11722314399296678011364036819941,
+0.11621593236537428039945041291503,
+0.11521734044884268666208981812815,
+0.11422729506494361251256464129256,
+0.11324572364648122224650705902604,
+0.11227255423254121902143509714733,
+0.11130771546359213841626001340046,
+0.11035113657664254172008355681101,
+0.10940274740039014622627888684292,
+0.10846247835046245178158841326876,
+0.10753026042464645939400469387692,
+0.10660602519817498345933159953347,
+0.10568970481905380631726387719027,
+0.10478123200341041276750786437333,
+0.10388054003088383059338895009205,
+0.10298756274005577138197509157180,
+0.10210223452389455278677132810117,
+0.10122449032527541801229631346359,
+0.10035426563248535380967751962089,
+0.09949149647478897073860082400643,
+0.09863611941803944460627207035941,
+0.09778807156028711256023910891599,
+0.09694729052746231534598564394400,
+0.09611371446905914162073258921737,
+0.09528728205386835514723031792528,
+0.09446793246573370606000707994099,
+0.09365560539935476047634921314966,
+0.09285024105611310030194971432138,
+0.09205178013992626473438463108323,
+0.09126016385313194534401048940708,
+0.09047533389243161972004259041569,
+0.08969723244481726809329558136596,
+0.08892580218357686028252118148885,
+0.08816098626430204920900735032774,
+0.08740272832093370913852936610056,
+0.08665097246184796930812410664657,
+0.08590566326594545332184793551278,
+0.08516674577880993524114927595292,
+0.08443416550886694016408995366874,
+0.08370786842357728907426661635327,
+0.08298780094567531628868550797051,
+0.08227390994941026491904523254561,
+0.08156614275684860582149582342026,
+0.08086444713418301788454556344732,
+0.08016877128806719488007814788944,
+0.07947906386200238870731737961250,
+0.07879527393272438284821390652723,
+0.07811735100664865538711012504791,
+0.07744524501630691004638862295906,
+0.07677890631685117817095687087203,
+0.07611828568255295246469671610612,
+0.07546333430335085135087780372487,
+0.07481400378140612428268241274054,
+0.07417024612771670744049146151156,
+0.07353201375871991352095591309990,
+0.07289925949294118190380231681047,
+0.07227193654768269970301020066472,
+0.07164999853570397370106093148934,
+0.07103339946196472742823146973024,
+0.07042209372037280812328674528544,
+0.06981603609054663761579462288864,
+0.06921518173464652479154324282717,
+0.06861948619418267725222904118709,
+0.06802890538686963417536190945611,
+0.06744339560352453910585523999544,
+0.06686291350494526219971902492034,
+0.06628741611885773099555052567666,
+0.06571686083685616963645514942982,
+0.06515120541139662879714933296782,
+0.06459040795277409818808678210189,
+0.06403442692617854203884775188271,
+0.06348322114871543520031593743624,
+0.06293674978649263507257671790285,
+0.06239497235171343608728378171691,
+0.06185784869980082839591162269244,
+0.06132533902653133917048933199112,
+0.06079740386520989664509428962447,
+0.06027400408384136348827198048639,
+0.05975510088236577616038758264949,
+0.05924065578986788954685138719469,
+0.05873063066184743691300340628914,
+0.05822498767748934822563455782074,
+0.05772368933696276488420906503052,
+0.05722669845874896188409053365831,
+0.05673397817697260064884190455814,
+0.05624549193878106839727948340624,
+0.05576120350171147321827191944976,
+0.05528107693111204007374581692602,
+0.05480507659756403415762804343103,
+0.05433316717432003922771954762538,
+0.05386531363479375028591178420356,
+0.05340148125003439660840598435243,
+0.05294163558623356941046367296622,
+0.05248574250226788889817086669609,
+0.05203376814723266463591500041730,
+0.05158567895803056746473203020287,
+0.05114144165694502891517103648766,
+0.05070102324925608583416902774843,
+0.05026439102086322635587478657726,
+0.04983151253594433893745474506431,
+0.04940235563460604328867020740290,
+0.04897688843059229413245958539846,
+0.04855507930895898438539148855853,
+0.04813689692382290552519208404192,
+0.04772231019609585178642419123207,
+0.04731128831123580097406389199932,
+0.04690380071703752207223914183487,
+0.04649981712142112894037282444515,
+0.04609930749025061696988458947999,
+0.04570224204517280008897017751224,
+0.04530859126144468063124293166766,
+0.04491832586583245634503924748060,
+0.04453141683447350146485277377906,
+0.04414783539078438734382103803000,
+0.04376755300338631970991087882794,
+0.04339054138403843075000310136602,
+0.04301677248559152705320585141635,
+0.04264621849995312713454964637094,
+0.04227885185608575707716383362822,
+0.04191464521800054854328010378595,
+0.04155357148278424062048941323155,
+0.04119560377862787475811146009619,
+0.04084071546288897680554441649292,
+0.04048888012014911080838075463362,
+0.04014007156031128981110711606561,
+0.03979426381668328682739144142033,
+0.03945143114411048257395009386528,
+0.03911154801709773587425900132075,
+0.03877458912795541529083820364576,
+0.03844052938496314575367307497800,
+0.03810934391054823094924230986180,
+0.03778100803948188091130333532419,
+0.03745549731707408652736646104131,
+0.03713278749740561018866102926950,
+0.03681285454156179443030438847018,
+0.03649567461588441863451492963577,
+0.03618122409023496327540314609905,
+0.03586947953627912799579036118303,
+0.03556041772577333420768397331813,
+0.03525401562887881673491463629944,
+0.03495025041248409763960935947580,
+0.03464909943854240642613362410884,
+0.03435054026241107782979611329210,
+0.03405455063123150744042177962001,
+0.03376110848229196825798226200277,
+0.03347019194143095038862512069500,
+0.03318177932142352820621411524371,
+0.03289584912042409214905092085246,
+0.03261238002036993127719100016293,
+0.03233135088544440011171232640663,
+0.03205274076052316845064638073382,
+0.03177652886964514589163144364647,
+0.03150269461450157237880631555527,
+0.03123121757291463795880304132879,
+0.03096207749736316558464288561936,
+0.03069525431349137342684763041234,
+0.03043072811863915469454688889073,
+0.03016847918039392006939181101188,
+0.02990848793514472997445707846964,
+0.02965073498663880341430498788213,
+0.02939520110458519741580829531813,
+0.02914186722321930600454464865834,
+0.02889071443993050658516352768856,
+0.02864172401386342811657748086418,
+0.02839487736454727323520685899894,
+0.02815015607054038165868448118090,
+0.02790754186807081066445945793930,
+0.02766701664970500074147707891825,
+0.02742856246301573000523355005953,
+0.02719216150926855729563769159540,
+0.02695779614211073899054937896835,
+0.02672544886628511195958424195851,
+0.02649510233633685374332600304115,
+0.02626673935534841117234172713779,
+0.02604034287367057443063345090195,
+0.02581589598767210919083581188715,
+0.02559338193850794682115967759728,
+0.02537278411086759180581573502877,
+0.02515408603177407553808109241800,
+0.02493727136936957355928257129563,
+0.02472232393170037748064693516881,
+0.02450922766554292434038053727363,
+0.02429796665522285584182249351670,
+0.02408852512143674212685695579239,
+0.02388088742008598330812674248591,
+0.02367503804115187598933189860873,
+0.02347096160752209018096614556725,
+0.02326864287388063362582713011761,
+0.02306806672557811313528652874538,
+0.02286921817752390201361478716535,
+0.02267208237307143103844708775796,
+0.02247664458294130682136646726121,
+0.02228289020411530416132528387152,
+0.02209080475878735447259337831838,
+0.02190037389326935160505094302152,
+0.02171158337694767404002504918026,
+0.02152441910124248264368773675415,
+0.02133886707854416517338158598704,
+0.02115491344120377231741159107514,
+0.02097254444050382013453592833230,
+0.02079174644563826571119768971130,
+0.02061250594271771263699122300750,
+0.02043480953375818864881097169928,
+0.02025864393571113336589561981782,
+0.02008399597946420797600630692159,
+0.01991085260888653812871851300770,
+0.01973920087985113827611094450276,
+0.01956902795928263522062806600843,
+0.01940032112422377177929355696051,
+0.01923306776087280178799687746505,
+0.01906725536366851714298320530361,
+0.01890287153435891639996491164766,
+0.01873990398108878532856813592389,
+0.01857834051749010159659825092149,
+0.01841816906178174451103046749267,
+0.01825937763587846124346825149587,
+0.01810195436449634973086197931025,
+0.01794588747429321645698863108009,
+0.01779116529297663368280879581107,
+0.01763777624845969810296608670797,
+0.01748570886798769818959442545747,
+0.01733495177730611652711090187040,
+0.01718549369980591073892028930459,
+0.01703732345569734796253413833256,
+0.01689042996118355829948676216645,
+0.01674480222763062228774622042238,
+0.01660042936076298880632151622194,
+0.01645730055985545128849345530853,
+0.01631540511693124057002179938536,
+0.01617473241597271876868191498033,
+0.01603527193213176091357574648555,
+0.01589701323094956653125819912020,
+0.01575994596759217394876806395132,
+0.01562405988607297978310040065253,
+0.01548934481850062702679160508978,
+0.01535579068431705551667221243406,
+0.01522338748956412156354556231008,
+0.01509212532613405342851731205656,
+0.01496199437102602516902472018501,
+0.01483298488564416608981311185289,
+0.01470508721504735355489756898351,
+0.01457829178725320549980803974677,
+0.01445258911251306316314568789494,
+0.01432796978262520538882629494992,
+0.01420442447022222769159593980248,
+0.01408194392808389053262096979324};
+
+int zLogAddCount = 801;
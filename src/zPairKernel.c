@@ -0,0 +1,117 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/******************************************************************************\
+  zPairKernel.c - part of the ZOE library for genomic analysis
+
+  Signatures of pair HMM topologies and the kernels registered for them. The
+  generator and the run time build the signature with the same function, so
+  a kernel matches exactly the HMMs it was generated from.
+
+\******************************************************************************/
+
+#ifndef ZOE_PAIR_KERNEL_C
+#define ZOE_PAIR_KERNEL_C
+
+#include "zPairKernel.h"
+
+static const zPairKernel *PAIR_KERNEL[PAIR_KERNELS_MAX];
+static int                PAIR_KERNELS = 0;
+
+/* "%.17g" reads back to the same double; every NaN is the same "nan" */
+
+static void zFormatKernelScore (score_t score, char *text) {
+	if (score != score) {
+		strcpy(text, "nan");
+	} else {
+		sprintf(text, "%.17g", score);
+	}
+}
+
+/* Line n of the signature of hmm with transitions of isochore group iso, into *
+ * line (PAIR_KERNEL_LINE chars). 0 past the last line                        */
+
+int zPairKernelSignature (zHMM *hmm, int iso, int n, char *line) {
+	int   state, j;
+	char  score[PAIR_KERNEL_LINE];
+
+	if (n == 0) {
+		sprintf(line, "states %d", hmm->states);
+		return 1;
+	}
+	if (n <= hmm->states) {
+		state = n - 1;
+		sprintf(line, "state %d %d %d %d %d", state, (int)hmm->state[state].type,
+				(int)hmm->mmap[hmm->state[state].model]->seq_type,
+				zGetGenomicIncrement(hmm, state), zGetCDnaIncrement(hmm, state));
+		return 1;
+	}
+	n -= hmm->states + 1;
+	for (state = 0; state < hmm->states; state++) {
+		if (n >= hmm->jmap[state]->size) {
+			n -= hmm->jmap[state]->size;
+			continue;
+		}
+		j = hmm->jmap[state]->elem[n];
+		zFormatKernelScore(zGetTransitionScore(hmm, j, state, iso), score);
+		sprintf(line, "jump %d %d %s", state, j, score);
+		return 1;
+	}
+	return 0;
+}
+
+/* FNV-1a over the lines of the signature, each one ended by '\n' */
+
+unsigned long zPairKernelFingerprint (zHMM *hmm, int iso) {
+	unsigned long  hash = 2166136261UL;
+	char           line[PAIR_KERNEL_LINE];
+	const char    *c;
+	int            n;
+
+	for (n = 0; zPairKernelSignature(hmm, iso, n, line); n++) {
+		for (c = line; *c != '\0'; c++) {
+			hash = ((hash ^ (unsigned char)*c) * 16777619UL) & 0xffffffffUL;
+		}
+		hash = ((hash ^ '\n') * 16777619UL) & 0xffffffffUL;
+	}
+	return hash;
+}
+
+void zAddPairKernel (const zPairKernel *kernel) {
+	if (PAIR_KERNELS == PAIR_KERNELS_MAX) zDie("zAddPairKernel: more than %d kernels", PAIR_KERNELS_MAX);
+	PAIR_KERNEL[PAIR_KERNELS++] = kernel;
+}
+
+static bool zSamePairKernelSignature (const zPairKernel *kernel, zHMM *hmm, int iso) {
+	char line[PAIR_KERNEL_LINE];
+	int  n;
+
+	for (n = 0; zPairKernelSignature(hmm, iso, n, line); n++) {
+		if (kernel->signature[n] == NULL || strcmp(kernel->signature[n], line) != 0) return false;
+	}
+	return kernel->signature[n] == NULL;
+}
+
+/* The kernel for the HMM and transitions of trellis, NULL if none was registered. *
+ * The scanners have to score the way the generated code expects them to          */
+
+const zPairKernel* zFindPairKernel (zPairTrellis *trellis) {
+	zHMM          *hmm = trellis->hmm;
+	zScanner      *scanner;
+	unsigned long  fingerprint;
+	int            k, state;
+
+	if (PAIR_KERNELS == 0 || trellis->tiso_group < 0) return NULL;
+	for (state = 0; state < hmm->states; state++) {
+		scanner = trellis->scanner[hmm->state[state].model];
+		if (scanner->model->seq_type != hmm->mmap[hmm->state[state].model]->seq_type) return NULL;
+		if (scanner->model->seq_type == PAIR && scanner->pairscore == NULL) return NULL;
+	}
+
+	fingerprint = zPairKernelFingerprint(hmm, trellis->tiso_group);
+	for (k = 0; k < PAIR_KERNELS; k++) {
+		if (PAIR_KERNEL[k]->fingerprint != fingerprint) continue;
+		if (zSamePairKernelSignature(PAIR_KERNEL[k], hmm, trellis->tiso_group)) return PAIR_KERNEL[k];
+	}
+	return NULL;
+}
+
+#endif
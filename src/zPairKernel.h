@@ -0,0 +1,50 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/******************************************************************************\
+zPairKernel.h - part of the ZOE library for genomic analysis
+
+ Pair HMM Viterbi kernels specialized for one topology. zPairKernelGen reads
+ a .zhmm file and writes, for every strand of it, a fill function with the
+ states unrolled, the increments constant and the transition scores inlined
+ (src/zPairKernels.c, from parameters/pairagon.zhmm). A program registers
+ the kernels it was linked with before it decodes:
+
+	zRegisterPairKernels();               generated
+	...
+	trellis->kernel = zFindPairKernel(trellis);
+
+ The signature of a topology is a list of lines: the number of states, the
+ type, emission and increments of each state, then every jump in jmap order
+ with its transition score as "%.17g" text (NaN as "nan"). A kernel is taken
+ only if its signature is the one of the HMM and isochore group of the
+ trellis, line for line, so it computes the same scores in the same order as
+ zRunPartialPairViterbiAndForward does. The fingerprint, an FNV-1a hash of
+ the signature, only narrows the search.
+
+\******************************************************************************/
+
+#ifndef ZOE_PAIR_KERNEL_H
+#define ZOE_PAIR_KERNEL_H
+
+#include "zPairTrellis.h"
+
+#define PAIR_KERNEL_LINE 128 /* longest signature line, '\0' included */
+#define PAIR_KERNELS_MAX 16  /* kernels a program may register */
+
+typedef void (*zPairKernelFunc)(zPairTrellis*, coor_t, coor_t, coor_t, coor_t, long, long);
+
+struct zPairKernel {
+	const char      *name;
+	unsigned long    fingerprint;
+	const char     **signature;  /* NULL terminated */
+	zPairKernelFunc  fill;       /* same arguments as zRunPairWavefront */
+};
+typedef struct zPairKernel zPairKernel;
+
+int                zPairKernelSignature (zHMM*, int, int, char*);
+unsigned long      zPairKernelFingerprint (zHMM*, int);
+void               zAddPairKernel (const zPairKernel*);
+const zPairKernel* zFindPairKernel (zPairTrellis*);
+
+void               zRegisterPairKernels (void); /* generated, src/zPairKernels.c */
+
+#endif
@@ -0,0 +1,293 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/*****************************************************************************\
+ zPairKernelGen.c
+
+ Writes the C source of the pair Viterbi kernels for one .zhmm file:
+
+	zPairKernelGen parameters/pairagon.zhmm > src/zPairKernels.c
+
+ The HMM is read the way pairagon reads it, null model included, and a kernel
+ comes out for every strand and isochore group of transitions that gives a
+ signature of its own (zSetHMMStrand rebuilds jmap in state order, so '+'
+ after '-' may differ from the '+' of the file). Each kernel is the loop of
+ zRunPartialPairViterbiAndForward with the states unrolled: the increments
+ are constants, the transition scores literals, the emission of a state is
+ scored once per cell, and once per row or column for a state that emits
+ only genomic or only cDNA. Jumps with a NaN score are left out; the generic
+ code never takes them (see zLogAddScore). Explicit states still go through
+ zExplicitPairTrans. The states zInitPairSpliceSites may flag check the skip
+ row of zGetSpliceSkipRow, as the generic code does.
+
+\*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ZOE.h"
+#include "zHardCoding.h"
+
+#define KERNEL_STRANDS "+-+"
+
+struct zKernelSource {
+	char   name[PAIR_KERNEL_LINE];
+	char **signature;
+	int    lines;
+};
+typedef struct zKernelSource zKernelSource;
+
+static void zGetKernelSource (zHMM *hmm, int iso, zKernelSource *source) {
+	char line[PAIR_KERNEL_LINE];
+	int  n;
+
+	for (n = 0; zPairKernelSignature(hmm, iso, n, line); n++);
+	source->lines     = n;
+	source->signature = zMalloc(n*sizeof(char*), "zGetKernelSource signature");
+	for (n = 0; zPairKernelSignature(hmm, iso, n, line); n++) {
+		source->signature[n] = zMalloc(strlen(line) + 1, "zGetKernelSource line");
+		strcpy(source->signature[n], line);
+	}
+}
+
+static void zFreeKernelSource (zKernelSource *source) {
+	int n;
+
+	for (n = 0; n < source->lines; n++) zFree(source->signature[n]);
+	zFree(source->signature);
+}
+
+static bool zSameKernelSource (const zKernelSource *a, const zKernelSource *b) {
+	int n;
+
+	if (a->lines != b->lines) return false;
+	for (n = 0; n < a->lines; n++) {
+		if (strcmp(a->signature[n], b->signature[n]) != 0) return false;
+	}
+	return true;
+}
+
+static int zSeqTypeOf (zHMM *hmm, int state) {
+	return hmm->mmap[hmm->state[state].model]->seq_type;
+}
+
+/* Emission of state in the generated code, with row and column filled per call */
+
+static void zWriteEmission (FILE *out, zHMM *hmm, int state, const int *slot) {
+	switch (zSeqTypeOf(hmm, state)) {
+	case GENOMIC: fprintf(out, "row[%d]", slot[state]); break;
+	case DNA:     fprintf(out, "column[%d][cdna - cstart]", slot[state]); break;
+	case PAIR:    fprintf(out, "zGetPairEmission(trellis, scanner[%d], genomic, cdna)", state); break;
+	default:      fprintf(out, "0"); break;
+	}
+}
+
+static void zWriteState (FILE *out, zHMM *hmm, int iso, int state, const int *slot, bool forward) {
+	zIVec       *jumps = hmm->jmap[state];
+	int          gincrement = zGetGenomicIncrement(hmm, state);
+	int          cincrement = zGetCDnaIncrement(hmm, state);
+	int          prev, from;
+	score_t      trans;
+	bool         pruned = zIsSplicePrunedState(hmm, state);
+	const char  *in = pruned ? "\t\t\t\t\t" : "\t\t\t\t";
+
+	fprintf(out, "\t\t\t/* %s */\n", zStrIdx2Char(hmm->state[state].name));
+	fprintf(out, "\t\t\tif (cell[%d].score == MIN_SCORE) {\n", state);
+	if (forward) fprintf(out, "\t\t\t\tfwd[%d] = MIN_SCORE;\n", state);
+	if (pruned)  fprintf(out, "\t\t\t\tif (skip == NULL || !skip[%d]) {\n", state);
+
+	if (hmm->state[state].type == EXPLICIT) {
+		for (prev = 0; prev < jumps->size; prev++) {
+			fprintf(out, "%szExplicitPairTrans(trellis, %d, %d, genomic, cdna);\n", in, jumps->elem[prev], state);
+		}
+	} else {
+		fprintf(out, "%semit = ", in);
+		zWriteEmission(out, hmm, state, slot);
+		fprintf(out, ";\n");
+		fprintf(out, "%sprev = trellis->cell[genomic - %d][cdna - %d];\n", in, gincrement, cincrement);
+		if (forward) fprintf(out, "%spfwd = trellis->forward[genomic - %d][cdna - %d];\n", in, gincrement, cincrement);
+
+		for (prev = 0; prev < jumps->size; prev++) {
+			from  = jumps->elem[prev];
+			trans = zGetTransitionScore(hmm, from, state, iso);
+			fprintf(out, "%s/* %s -> %s */\n", in, zStrIdx2Char(hmm->state[from].name), zStrIdx2Char(hmm->state[state].name));
+			if (trans != trans) {
+				fprintf(out, "%s/* NaN transition, never taken */\n", in);
+				continue;
+			}
+			fprintf(out, "%stotal = emit + (%.17g);\n", in, trans);
+			fprintf(out, "%sif (total != MIN_SCORE) {\n", in);
+			if (forward) fprintf(out, "%s\tfwd[%d] = zLogAddScore(total + pfwd[%d], fwd[%d]);\n", in, state, from, state);
+			fprintf(out, "%s\tscore = total + prev[%d].score;\n", in, from);
+			fprintf(out, "%s\tif (score > cell[%d].score) {\n", in, state);
+			fprintf(out, "%s\t\tzSetCellScore(trellis, &cell[%d], score);\n", in, state);
+			if (from == state) {
+				fprintf(out, "%s\t\tcell[%d].length = prev[%d].length + 1;\n", in, state, from);
+				fprintf(out, "%s\t\tcell[%d].trace  = prev[%d].trace;\n", in, state, from);
+			} else {
+				fprintf(out, "%s\t\tcell[%d].trace  = %d;\n", in, state, from);
+				fprintf(out, "%s\t\tcell[%d].length = 1;\n", in, state);
+			}
+			fprintf(out, "%s\t}\n", in);
+			fprintf(out, "%s}\n", in);
+		}
+	}
+	if (pruned) fprintf(out, "\t\t\t\t}\n");
+	fprintf(out, "\t\t\t}\n");
+}
+
+static void zWriteFill (FILE *out, zHMM *hmm, int iso, int k, bool forward) {
+	int  *slot = zMalloc(hmm->states*sizeof(int), "zWriteFill slot");
+	int   rows = 0, columns = 0, state;
+
+	for (state = 0; state < hmm->states; state++) {
+		if (hmm->state[state].type == EXPLICIT) continue;
+		if (zSeqTypeOf(hmm, state) == GENOMIC) slot[state] = rows++;
+		if (zSeqTypeOf(hmm, state) == DNA)     slot[state] = columns++;
+	}
+
+	fprintf(out, "static void zPairKernel%d%s (zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi) {\n",
+			k, forward ? "Forward" : "Viterbi");
+	fprintf(out, "\tzHMM              *hmm = trellis->hmm;\n");
+	fprintf(out, "\tzScanner          *scanner[%d];\n", hmm->states);
+	if (rows > 0)    fprintf(out, "\tscore_t            row[%d];       /* genomic only emissions of the row */\n", rows);
+	if (columns > 0) fprintf(out, "\tscore_t           *column[%d];    /* cdna only emissions, cstart..cend */\n", columns);
+	fprintf(out, "\tzPairTrellisCell  *cell, *prev;\n");
+	if (forward) fprintf(out, "\tscore_t           *fwd, *pfwd;\n");
+	fprintf(out, "\tscore_t            emit, total, score;\n");
+	fprintf(out, "\tcoor_t             genomic, cdna;\n");
+	fprintf(out, "\tlong               clo, chi;\n");
+	fprintf(out, "\tcoor_t             ahead = zGetSpliceAheadEnd(trellis, gstart, gend);\n");
+	fprintf(out, "\tconst char        *skip;          /* see zPairSplice.h */\n");
+	fprintf(out, "\tint                state;\n\n");
+
+	fprintf(out, "\tfor (state = 0; state < %d; state++) scanner[state] = trellis->scanner[hmm->state[state].model];\n", hmm->states);
+	for (state = 0; state < hmm->states; state++) {
+		if (hmm->state[state].type == EXPLICIT || zSeqTypeOf(hmm, state) != DNA) continue;
+		fprintf(out, "\tcolumn[%d] = zMalloc((cend - cstart + 1)*sizeof(score_t), \"zPairKernel%d column\");\n", slot[state], k);
+		fprintf(out, "\tfor (cdna = cstart; cdna <= cend; cdna++) column[%d][cdna - cstart] = zGetPairUScore(trellis, scanner[%d], %d, cdna);\n", slot[state], state, state);
+	}
+	fprintf(out, "\n\tfor (genomic = gstart; genomic <= gend; genomic++) {\n");
+	fprintf(out, "\t\tclo = MAX((long)cstart, (long)genomic - dhi);\n");
+	fprintf(out, "\t\tchi = MIN((long)cend,   (long)genomic - dlo);\n");
+	fprintf(out, "\t\tif (chi < clo || trellis->cell[genomic] == NULL) continue;\n");
+	for (state = 0; state < hmm->states; state++) {
+		if (hmm->state[state].type == EXPLICIT || zSeqTypeOf(hmm, state) != GENOMIC) continue;
+		fprintf(out, "\t\trow[%d] = zGetPairUScore(trellis, scanner[%d], %d, genomic);\n", slot[state], state, state);
+	}
+	fprintf(out, "\t\tskip = zGetSpliceSkipRow(trellis, genomic, ahead);\n");
+	fprintf(out, "\t\tfor (cdna = clo; cdna <= (coor_t)chi; cdna++) {\n");
+	fprintf(out, "\t\t\tif (NULL == (cell = trellis->cell[genomic][cdna])) continue;\n");
+	if (forward) fprintf(out, "\t\t\tfwd = trellis->forward[genomic][cdna];\n");
+	for (state = 0; state < hmm->states; state++) {
+		zWriteState(out, hmm, iso, state, slot, forward);
+	}
+	fprintf(out, "\t\t}\n");
+	fprintf(out, "\t}\n");
+	for (state = 0; state < columns; state++) {
+		fprintf(out, "\tzFree(column[%d]);\n", state);
+	}
+	fprintf(out, "}\n\n");
+	zFree(slot);
+}
+
+static void zWriteKernel (FILE *out, zHMM *hmm, int iso, int k, const zKernelSource *source) {
+	int n;
+
+	fprintf(out, "/* %s */\n\n", source->name);
+	fprintf(out, "static const char *zPairKernel%dSignature[] = {\n", k);
+	for (n = 0; n < source->lines; n++) {
+		fprintf(out, "\t\"%s\",\n", source->signature[n]);
+	}
+	fprintf(out, "\tNULL\n};\n\n");
+
+	zWriteFill(out, hmm, iso, k, false);
+	zWriteFill(out, hmm, iso, k, true);
+
+	fprintf(out, "static void zPairKernel%d (zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi) {\n", k);
+	fprintf(out, "\tif (gend < gstart || cend < cstart) return;\n");
+	fprintf(out, "\tif (trellis->forward != NULL) {\n");
+	fprintf(out, "\t\tzPairKernel%dForward(trellis, gstart, gend, cstart, cend, dlo, dhi);\n", k);
+	fprintf(out, "\t} else {\n");
+	fprintf(out, "\t\tzPairKernel%dViterbi(trellis, gstart, gend, cstart, cend, dlo, dhi);\n", k);
+	fprintf(out, "\t}\n");
+	fprintf(out, "}\n\n");
+
+	fprintf(out, "static const zPairKernel zPairKernel%dEntry = {\n", k);
+	fprintf(out, "\t\"%s\",\n", source->name);
+	fprintf(out, "\t%luUL,\n", zPairKernelFingerprint(hmm, iso));
+	fprintf(out, "\tzPairKernel%dSignature,\n", k);
+	fprintf(out, "\tzPairKernel%d\n", k);
+	fprintf(out, "};\n\n");
+}
+
+/* Only jumps into internal and explicit states from states that are not *
+ * external: the phase check of zInternalPairTransHelper is not unrolled  */
+
+static void zCheckKernelTopology (zHMM *hmm) {
+	int state, prev;
+
+	for (state = 0; state < hmm->states; state++) {
+		if (hmm->state[state].type == EXTERNAL) {
+			zDie("%s: external states have no kernel", zStrIdx2Char(hmm->state[state].name));
+		}
+		for (prev = 0; prev < hmm->jmap[state]->size; prev++) {
+			if (hmm->state[hmm->jmap[state]->elem[prev]].type == EXTERNAL) {
+				zDie("%s: jumps from external states have no kernel", zStrIdx2Char(hmm->state[state].name));
+			}
+		}
+	}
+}
+
+int main (int argc, char *argv[]) {
+	FILE           *stream;
+	zHMM            hmm;
+	zKernelSource   source[PAIR_KERNELS_MAX];
+	int             kernels = 0, k, s, iso, isos;
+
+	zSetProgramName(argv[0]);
+	zParseOptions(&argc, argv);
+	if (argc != 2) {
+		zDie("usage: %s [-nonull] hmm_file > zPairKernels.c", argv[0]);
+	}
+	if ((stream = fopen(argv[1], "r")) == NULL) zDie("hmm file error (%s)", argv[1]);
+	if (!zReadHMM(stream, &hmm, GPAIRHMM)) zDie("error reading hmm");
+	fclose(stream);
+	if (zOption("nonull") == NULL && !zNullifyHMM(&hmm)) zDie("Cannot process NULL model");
+	zCheckKernelTopology(&hmm);
+
+	printf("/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */\n");
+	printf("/* Generated by zPairKernelGen from %s, do not edit. See zPairKernel.h */\n\n", argv[1]);
+	printf("#include \"zPairKernel.h\"\n");
+	printf("#include \"zPairSplice.h\"\n");
+	printf("#include \"zPairTile.h\"\n\n");
+
+	isos = (hmm.iso_transitions > 0) ? hmm.iso_transitions : 1;
+	for (s = 0; KERNEL_STRANDS[s] != '\0'; s++) {
+		zSetHMMStrand(&hmm, KERNEL_STRANDS[s]);
+		for (iso = 0; iso < isos; iso++) {
+			zKernelSource *next = &source[kernels];
+			zGetKernelSource(&hmm, iso, next);
+			for (k = 0; k < kernels; k++) {
+				if (zSameKernelSource(&source[k], next)) break;
+			}
+			if (k < kernels) {
+				zFreeKernelSource(next);
+				continue;
+			}
+			if (kernels == PAIR_KERNELS_MAX) zDie("more than %d kernels", PAIR_KERNELS_MAX);
+			sprintf(next->name, "%.64s %c%s, isochore group %d", hmm.name, KERNEL_STRANDS[s],
+					(s > 0 && KERNEL_STRANDS[s] == KERNEL_STRANDS[0]) ? " (after zSetHMMStrand)" : "", iso);
+			zWriteKernel(stdout, &hmm, iso, kernels, next);
+			kernels++;
+		}
+	}
+
+	printf("void zRegisterPairKernels (void) {\n");
+	for (k = 0; k < kernels; k++) {
+		printf("\tzAddPairKernel(&zPairKernel%dEntry);\n", k);
+	}
+	printf("}\n");
+
+	for (k = 0; k < kernels; k++) zFreeKernelSource(&source[k]);
+	zFreeHMM(&hmm);
+	return 0;
+}
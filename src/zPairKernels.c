@@ -0,0 +1,2033 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/* Generated by zPairKernelGen from parameters/pairagon.zhmm, do not edit. See zPairKernel.h */
+
+#include "zPairKernel.h"
+#include "zPairSplice.h"
+#include "zPairTile.h"
+
+/* pairagon +, isochore group 0 */
+
+static const char *zPairKernel0Signature[] = {
+	"states 17",
+	"state 0 0 4 1 0",
+	"state 1 0 0 0 1",
+	"state 2 0 5 1 1",
+	"state 3 0 4 8 0",
+	"state 4 0 4 6 0",
+	"state 5 0 4 8 0",
+	"state 6 0 4 6 0",
+	"state 7 0 4 1 0",
+	"state 8 0 4 1 0",
+	"state 9 0 4 8 0",
+	"state 10 3 4 1 0",
+	"state 11 0 4 8 0",
+	"state 12 3 4 1 0",
+	"state 13 0 4 1 0",
+	"state 14 0 0 0 1",
+	"state 15 0 4 1 0",
+	"state 16 0 0 0 1",
+	"jump 0 0 -0.0012074700147479689",
+	"jump 1 0 -67.804064738660159",
+	"jump 1 1 -1.3655030597305",
+	"jump 2 0 -74.456475068045719",
+	"jump 2 1 -72.936443751499382",
+	"jump 2 2 -0.08242156708689663",
+	"jump 2 4 -72.948668296558409",
+	"jump 2 6 -72.936443751499382",
+	"jump 2 13 -73.296243845049844",
+	"jump 2 14 -72.936443751499382",
+	"jump 3 2 -2.3211592641207628",
+	"jump 3 13 -53.431957909926545",
+	"jump 4 10 0.0013893330730354592",
+	"jump 5 2 -80.796342944841825",
+	"jump 6 12 0.0013893330730354592",
+	"jump 7 3 -122.5824842002327",
+	"jump 7 7 -0.0027136216763921084",
+	"jump 8 5 -122.5824842002327",
+	"jump 8 8 -0.0027136216763921084",
+	"jump 9 7 0.0018524440974090339",
+	"jump 10 9 0.00023155551215836567",
+	"jump 11 8 0.0018524440974090339",
+	"jump 12 11 0.00023155551215836567",
+	"jump 13 2 -90.482772864798079",
+	"jump 13 4 -154.72113826349525",
+	"jump 13 13 -1.3748036819077356",
+	"jump 14 2 -92.811518221546052",
+	"jump 14 4 -143.90263716759512",
+	"jump 14 14 -1.1452399964432303",
+	"jump 15 2 -167.17261170293622",
+	"jump 15 15 -0.0012077571450959113",
+	"jump 16 2 nan",
+	"jump 16 15 nan",
+	"jump 16 16 nan",
+	NULL
+};
+
+static void zPairKernel0Viterbi (zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi) {
+	zHMM              *hmm = trellis->hmm;
+	zScanner          *scanner[17];
+	score_t            row[11];       /* genomic only emissions of the row */
+	score_t           *column[3];    /* cdna only emissions, cstart..cend */
+	zPairTrellisCell  *cell, *prev;
+	score_t            emit, total, score;
+	coor_t             genomic, cdna;
+	long               clo, chi;
+	coor_t             ahead = zGetSpliceAheadEnd(trellis, gstart, gend);
+	const char        *skip;          /* see zPairSplice.h */
+	int                state;
+
+	for (state = 0; state < 17; state++) scanner[state] = trellis->scanner[hmm->state[state].model];
+	column[0] = zMalloc((cend - cstart + 1)*sizeof(score_t), "zPairKernel0 column");
+	for (cdna = cstart; cdna <= cend; cdna++) column[0][cdna - cstart] = zGetPairUScore(trellis, scanner[1], 1, cdna);
+	column[1] = zMalloc((cend - cstart + 1)*sizeof(score_t), "zPairKernel0 column");
+	for (cdna = cstart; cdna <= cend; cdna++) column[1][cdna - cstart] = zGetPairUScore(trellis, scanner[14], 14, cdna);
+	column[2] = zMalloc((cend - cstart + 1)*sizeof(score_t), "zPairKernel0 column");
+	for (cdna = cstart; cdna <= cend; cdna++) column[2][cdna - cstart] = zGetPairUScore(trellis, scanner[16], 16, cdna);
+
+	for (genomic = gstart; genomic <= gend; genomic++) {
+		clo = MAX((long)cstart, (long)genomic - dhi);
+		chi = MIN((long)cend,   (long)genomic - dlo);
+		if (chi < clo || trellis->cell[genomic] == NULL) continue;
+		row[0] = zGetPairUScore(trellis, scanner[0], 0, genomic);
+		row[1] = zGetPairUScore(trellis, scanner[3], 3, genomic);
+		row[2] = zGetPairUScore(trellis, scanner[4], 4, genomic);
+		row[3] = zGetPairUScore(trellis, scanner[5], 5, genomic);
+		row[4] = zGetPairUScore(trellis, scanner[6], 6, genomic);
+		row[5] = zGetPairUScore(trellis, scanner[7], 7, genomic);
+		row[6] = zGetPairUScore(trellis, scanner[8], 8, genomic);
+		row[7] = zGetPairUScore(trellis, scanner[9], 9, genomic);
+		row[8] = zGetPairUScore(trellis, scanner[11], 11, genomic);
+		row[9] = zGetPairUScore(trellis, scanner[13], 13, genomic);
+		row[10] = zGetPairUScore(trellis, scanner[15], 15, genomic);
+		skip = zGetSpliceSkipRow(trellis, genomic, ahead);
+		for (cdna = clo; cdna <= (coor_t)chi; cdna++) {
+			if (NULL == (cell = trellis->cell[genomic][cdna])) continue;
+			/* RGenomic1 */
+			if (cell[0].score == MIN_SCORE) {
+				emit = row[0];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				/* RGenomic1 -> RGenomic1 */
+				total = emit + (-0.0012074700147479689);
+				if (total != MIN_SCORE) {
+					score = total + prev[0].score;
+					if (score > cell[0].score) {
+						zSetCellScore(trellis, &cell[0], score);
+						cell[0].length = prev[0].length + 1;
+						cell[0].trace  = prev[0].trace;
+					}
+				}
+			}
+			/* RCDna1 */
+			if (cell[1].score == MIN_SCORE) {
+				emit = column[0][cdna - cstart];
+				prev = trellis->cell[genomic - 0][cdna - 1];
+				/* RGenomic1 -> RCDna1 */
+				total = emit + (-67.804064738660159);
+				if (total != MIN_SCORE) {
+					score = total + prev[0].score;
+					if (score > cell[1].score) {
+						zSetCellScore(trellis, &cell[1], score);
+						cell[1].trace  = 0;
+						cell[1].length = 1;
+					}
+				}
+				/* RCDna1 -> RCDna1 */
+				total = emit + (-1.3655030597305);
+				if (total != MIN_SCORE) {
+					score = total + prev[1].score;
+					if (score > cell[1].score) {
+						zSetCellScore(trellis, &cell[1], score);
+						cell[1].length = prev[1].length + 1;
+						cell[1].trace  = prev[1].trace;
+					}
+				}
+			}
+			/* Match */
+			if (cell[2].score == MIN_SCORE) {
+				emit = zGetPairEmission(trellis, scanner[2], genomic, cdna);
+				prev = trellis->cell[genomic - 1][cdna - 1];
+				/* RGenomic1 -> Match */
+				total = emit + (-74.456475068045719);
+				if (total != MIN_SCORE) {
+					score = total + prev[0].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 0;
+						cell[2].length = 1;
+					}
+				}
+				/* RCDna1 -> Match */
+				total = emit + (-72.936443751499382);
+				if (total != MIN_SCORE) {
+					score = total + prev[1].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 1;
+						cell[2].length = 1;
+					}
+				}
+				/* Match -> Match */
+				total = emit + (-0.08242156708689663);
+				if (total != MIN_SCORE) {
+					score = total + prev[2].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].length = prev[2].length + 1;
+						cell[2].trace  = prev[2].trace;
+					}
+				}
+				/* AccU2 -> Match */
+				total = emit + (-72.948668296558409);
+				if (total != MIN_SCORE) {
+					score = total + prev[4].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 4;
+						cell[2].length = 1;
+					}
+				}
+				/* AccU12 -> Match */
+				total = emit + (-72.936443751499382);
+				if (total != MIN_SCORE) {
+					score = total + prev[6].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 6;
+						cell[2].length = 1;
+					}
+				}
+				/* Genomic -> Match */
+				total = emit + (-73.296243845049844);
+				if (total != MIN_SCORE) {
+					score = total + prev[13].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 13;
+						cell[2].length = 1;
+					}
+				}
+				/* CDna -> Match */
+				total = emit + (-72.936443751499382);
+				if (total != MIN_SCORE) {
+					score = total + prev[14].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 14;
+						cell[2].length = 1;
+					}
+				}
+			}
+			/* DonorU2 */
+			if (cell[3].score == MIN_SCORE) {
+				if (skip == NULL || !skip[3]) {
+					emit = row[1];
+					prev = trellis->cell[genomic - 8][cdna - 0];
+					/* Match -> DonorU2 */
+					total = emit + (-2.3211592641207628);
+					if (total != MIN_SCORE) {
+						score = total + prev[2].score;
+						if (score > cell[3].score) {
+							zSetCellScore(trellis, &cell[3], score);
+							cell[3].trace  = 2;
+							cell[3].length = 1;
+						}
+					}
+					/* Genomic -> DonorU2 */
+					total = emit + (-53.431957909926545);
+					if (total != MIN_SCORE) {
+						score = total + prev[13].score;
+						if (score > cell[3].score) {
+							zSetCellScore(trellis, &cell[3], score);
+							cell[3].trace  = 13;
+							cell[3].length = 1;
+						}
+					}
+				}
+			}
+			/* AccU2 */
+			if (cell[4].score == MIN_SCORE) {
+				if (skip == NULL || !skip[4]) {
+					emit = row[2];
+					prev = trellis->cell[genomic - 6][cdna - 0];
+					/* BrAccU2 -> AccU2 */
+					total = emit + (0.0013893330730354592);
+					if (total != MIN_SCORE) {
+						score = total + prev[10].score;
+						if (score > cell[4].score) {
+							zSetCellScore(trellis, &cell[4], score);
+							cell[4].trace  = 10;
+							cell[4].length = 1;
+						}
+					}
+				}
+			}
+			/* DonorU12 */
+			if (cell[5].score == MIN_SCORE) {
+				if (skip == NULL || !skip[5]) {
+					emit = row[3];
+					prev = trellis->cell[genomic - 8][cdna - 0];
+					/* Match -> DonorU12 */
+					total = emit + (-80.796342944841825);
+					if (total != MIN_SCORE) {
+						score = total + prev[2].score;
+						if (score > cell[5].score) {
+							zSetCellScore(trellis, &cell[5], score);
+							cell[5].trace  = 2;
+							cell[5].length = 1;
+						}
+					}
+				}
+			}
+			/* AccU12 */
+			if (cell[6].score == MIN_SCORE) {
+				if (skip == NULL || !skip[6]) {
+					emit = row[4];
+					prev = trellis->cell[genomic - 6][cdna - 0];
+					/* BrAccU12 -> AccU12 */
+					total = emit + (0.0013893330730354592);
+					if (total != MIN_SCORE) {
+						score = total + prev[12].score;
+						if (score > cell[6].score) {
+							zSetCellScore(trellis, &cell[6], score);
+							cell[6].trace  = 12;
+							cell[6].length = 1;
+						}
+					}
+				}
+			}
+			/* IntronU2 */
+			if (cell[7].score == MIN_SCORE) {
+				emit = row[5];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				/* DonorU2 -> IntronU2 */
+				total = emit + (-122.5824842002327);
+				if (total != MIN_SCORE) {
+					score = total + prev[3].score;
+					if (score > cell[7].score) {
+						zSetCellScore(trellis, &cell[7], score);
+						cell[7].trace  = 3;
+						cell[7].length = 1;
+					}
+				}
+				/* IntronU2 -> IntronU2 */
+				total = emit + (-0.0027136216763921084);
+				if (total != MIN_SCORE) {
+					score = total + prev[7].score;
+					if (score > cell[7].score) {
+						zSetCellScore(trellis, &cell[7], score);
+						cell[7].length = prev[7].length + 1;
+						cell[7].trace  = prev[7].trace;
+					}
+				}
+			}
+			/* IntronU12 */
+			if (cell[8].score == MIN_SCORE) {
+				emit = row[6];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				/* DonorU12 -> IntronU12 */
+				total = emit + (-122.5824842002327);
+				if (total != MIN_SCORE) {
+					score = total + prev[5].score;
+					if (score > cell[8].score) {
+						zSetCellScore(trellis, &cell[8], score);
+						cell[8].trace  = 5;
+						cell[8].length = 1;
+					}
+				}
+				/* IntronU12 -> IntronU12 */
+				total = emit + (-0.0027136216763921084);
+				if (total != MIN_SCORE) {
+					score = total + prev[8].score;
+					if (score > cell[8].score) {
+						zSetCellScore(trellis, &cell[8], score);
+						cell[8].length = prev[8].length + 1;
+						cell[8].trace  = prev[8].trace;
+					}
+				}
+			}
+			/* BranchU2 */
+			if (cell[9].score == MIN_SCORE) {
+				emit = row[7];
+				prev = trellis->cell[genomic - 8][cdna - 0];
+				/* IntronU2 -> BranchU2 */
+				total = emit + (0.0018524440974090339);
+				if (total != MIN_SCORE) {
+					score = total + prev[7].score;
+					if (score > cell[9].score) {
+						zSetCellScore(trellis, &cell[9], score);
+						cell[9].trace  = 7;
+						cell[9].length = 1;
+					}
+				}
+			}
+			/* BrAccU2 */
+			if (cell[10].score == MIN_SCORE) {
+				if (skip == NULL || !skip[10]) {
+					zExplicitPairTrans(trellis, 9, 10, genomic, cdna);
+				}
+			}
+			/* BranchU12 */
+			if (cell[11].score == MIN_SCORE) {
+				emit = row[8];
+				prev = trellis->cell[genomic - 8][cdna - 0];
+				/* IntronU12 -> BranchU12 */
+				total = emit + (0.0018524440974090339);
+				if (total != MIN_SCORE) {
+					score = total + prev[8].score;
+					if (score > cell[11].score) {
+						zSetCellScore(trellis, &cell[11], score);
+						cell[11].trace  = 8;
+						cell[11].length = 1;
+					}
+				}
+			}
+			/* BrAccU12 */
+			if (cell[12].score == MIN_SCORE) {
+				if (skip == NULL || !skip[12]) {
+					zExplicitPairTrans(trellis, 11, 12, genomic, cdna);
+				}
+			}
+			/* Genomic */
+			if (cell[13].score == MIN_SCORE) {
+				emit = row[9];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				/* Match -> Genomic */
+				total = emit + (-90.482772864798079);
+				if (total != MIN_SCORE) {
+					score = total + prev[2].score;
+					if (score > cell[13].score) {
+						zSetCellScore(trellis, &cell[13], score);
+						cell[13].trace  = 2;
+						cell[13].length = 1;
+					}
+				}
+				/* AccU2 -> Genomic */
+				total = emit + (-154.72113826349525);
+				if (total != MIN_SCORE) {
+					score = total + prev[4].score;
+					if (score > cell[13].score) {
+						zSetCellScore(trellis, &cell[13], score);
+						cell[13].trace  = 4;
+						cell[13].length = 1;
+					}
+				}
+				/* Genomic -> Genomic */
+				total = emit + (-1.3748036819077356);
+				if (total != MIN_SCORE) {
+					score = total + prev[13].score;
+					if (score > cell[13].score) {
+						zSetCellScore(trellis, &cell[13], score);
+						cell[13].length = prev[13].length + 1;
+						cell[13].trace  = prev[13].trace;
+					}
+				}
+			}
+			/* CDna */
+			if (cell[14].score == MIN_SCORE) {
+				emit = column[1][cdna - cstart];
+				prev = trellis->cell[genomic - 0][cdna - 1];
+				/* Match -> CDna */
+				total = emit + (-92.811518221546052);
+				if (total != MIN_SCORE) {
+					score = total + prev[2].score;
+					if (score > cell[14].score) {
+						zSetCellScore(trellis, &cell[14], score);
+						cell[14].trace  = 2;
+						cell[14].length = 1;
+					}
+				}
+				/* AccU2 -> CDna */
+				total = emit + (-143.90263716759512);
+				if (total != MIN_SCORE) {
+					score = total + prev[4].score;
+					if (score > cell[14].score) {
+						zSetCellScore(trellis, &cell[14], score);
+						cell[14].trace  = 4;
+						cell[14].length = 1;
+					}
+				}
+				/* CDna -> CDna */
+				total = emit + (-1.1452399964432303);
+				if (total != MIN_SCORE) {
+					score = total + prev[14].score;
+					if (score > cell[14].score) {
+						zSetCellScore(trellis, &cell[14], score);
+						cell[14].length = prev[14].length + 1;
+						cell[14].trace  = prev[14].trace;
+					}
+				}
+			}
+			/* RGenomic2 */
+			if (cell[15].score == MIN_SCORE) {
+				emit = row[10];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				/* Match -> RGenomic2 */
+				total = emit + (-167.17261170293622);
+				if (total != MIN_SCORE) {
+					score = total + prev[2].score;
+					if (score > cell[15].score) {
+						zSetCellScore(trellis, &cell[15], score);
+						cell[15].trace  = 2;
+						cell[15].length = 1;
+					}
+				}
+				/* RGenomic2 -> RGenomic2 */
+				total = emit + (-0.0012077571450959113);
+				if (total != MIN_SCORE) {
+					score = total + prev[15].score;
+					if (score > cell[15].score) {
+						zSetCellScore(trellis, &cell[15], score);
+						cell[15].length = prev[15].length + 1;
+						cell[15].trace  = prev[15].trace;
+					}
+				}
+			}
+			/* RCDna2 */
+			if (cell[16].score == MIN_SCORE) {
+				emit = column[2][cdna - cstart];
+				prev = trellis->cell[genomic - 0][cdna - 1];
+				/* Match -> RCDna2 */
+				/* NaN transition, never taken */
+				/* RGenomic2 -> RCDna2 */
+				/* NaN transition, never taken */
+				/* RCDna2 -> RCDna2 */
+				/* NaN transition, never taken */
+			}
+		}
+	}
+	zFree(column[0]);
+	zFree(column[1]);
+	zFree(column[2]);
+}
+
+static void zPairKernel0Forward (zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi) {
+	zHMM              *hmm = trellis->hmm;
+	zScanner          *scanner[17];
+	score_t            row[11];       /* genomic only emissions of the row */
+	score_t           *column[3];    /* cdna only emissions, cstart..cend */
+	zPairTrellisCell  *cell, *prev;
+	score_t           *fwd, *pfwd;
+	score_t            emit, total, score;
+	coor_t             genomic, cdna;
+	long               clo, chi;
+	coor_t             ahead = zGetSpliceAheadEnd(trellis, gstart, gend);
+	const char        *skip;          /* see zPairSplice.h */
+	int                state;
+
+	for (state = 0; state < 17; state++) scanner[state] = trellis->scanner[hmm->state[state].model];
+	column[0] = zMalloc((cend - cstart + 1)*sizeof(score_t), "zPairKernel0 column");
+	for (cdna = cstart; cdna <= cend; cdna++) column[0][cdna - cstart] = zGetPairUScore(trellis, scanner[1], 1, cdna);
+	column[1] = zMalloc((cend - cstart + 1)*sizeof(score_t), "zPairKernel0 column");
+	for (cdna = cstart; cdna <= cend; cdna++) column[1][cdna - cstart] = zGetPairUScore(trellis, scanner[14], 14, cdna);
+	column[2] = zMalloc((cend - cstart + 1)*sizeof(score_t), "zPairKernel0 column");
+	for (cdna = cstart; cdna <= cend; cdna++) column[2][cdna - cstart] = zGetPairUScore(trellis, scanner[16], 16, cdna);
+
+	for (genomic = gstart; genomic <= gend; genomic++) {
+		clo = MAX((long)cstart, (long)genomic - dhi);
+		chi = MIN((long)cend,   (long)genomic - dlo);
+		if (chi < clo || trellis->cell[genomic] == NULL) continue;
+		row[0] = zGetPairUScore(trellis, scanner[0], 0, genomic);
+		row[1] = zGetPairUScore(trellis, scanner[3], 3, genomic);
+		row[2] = zGetPairUScore(trellis, scanner[4], 4, genomic);
+		row[3] = zGetPairUScore(trellis, scanner[5], 5, genomic);
+		row[4] = zGetPairUScore(trellis, scanner[6], 6, genomic);
+		row[5] = zGetPairUScore(trellis, scanner[7], 7, genomic);
+		row[6] = zGetPairUScore(trellis, scanner[8], 8, genomic);
+		row[7] = zGetPairUScore(trellis, scanner[9], 9, genomic);
+		row[8] = zGetPairUScore(trellis, scanner[11], 11, genomic);
+		row[9] = zGetPairUScore(trellis, scanner[13], 13, genomic);
+		row[10] = zGetPairUScore(trellis, scanner[15], 15, genomic);
+		skip = zGetSpliceSkipRow(trellis, genomic, ahead);
+		for (cdna = clo; cdna <= (coor_t)chi; cdna++) {
+			if (NULL == (cell = trellis->cell[genomic][cdna])) continue;
+			fwd = trellis->forward[genomic][cdna];
+			/* RGenomic1 */
+			if (cell[0].score == MIN_SCORE) {
+				fwd[0] = MIN_SCORE;
+				emit = row[0];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				pfwd = trellis->forward[genomic - 1][cdna - 0];
+				/* RGenomic1 -> RGenomic1 */
+				total = emit + (-0.0012074700147479689);
+				if (total != MIN_SCORE) {
+					fwd[0] = zLogAddScore(total + pfwd[0], fwd[0]);
+					score = total + prev[0].score;
+					if (score > cell[0].score) {
+						zSetCellScore(trellis, &cell[0], score);
+						cell[0].length = prev[0].length + 1;
+						cell[0].trace  = prev[0].trace;
+					}
+				}
+			}
+			/* RCDna1 */
+			if (cell[1].score == MIN_SCORE) {
+				fwd[1] = MIN_SCORE;
+				emit = column[0][cdna - cstart];
+				prev = trellis->cell[genomic - 0][cdna - 1];
+				pfwd = trellis->forward[genomic - 0][cdna - 1];
+				/* RGenomic1 -> RCDna1 */
+				total = emit + (-67.804064738660159);
+				if (total != MIN_SCORE) {
+					fwd[1] = zLogAddScore(total + pfwd[0], fwd[1]);
+					score = total + prev[0].score;
+					if (score > cell[1].score) {
+						zSetCellScore(trellis, &cell[1], score);
+						cell[1].trace  = 0;
+						cell[1].length = 1;
+					}
+				}
+				/* RCDna1 -> RCDna1 */
+				total = emit + (-1.3655030597305);
+				if (total != MIN_SCORE) {
+					fwd[1] = zLogAddScore(total + pfwd[1], fwd[1]);
+					score = total + prev[1].score;
+					if (score > cell[1].score) {
+						zSetCellScore(trellis, &cell[1], score);
+						cell[1].length = prev[1].length + 1;
+						cell[1].trace  = prev[1].trace;
+					}
+				}
+			}
+			/* Match */
+			if (cell[2].score == MIN_SCORE) {
+				fwd[2] = MIN_SCORE;
+				emit = zGetPairEmission(trellis, scanner[2], genomic, cdna);
+				prev = trellis->cell[genomic - 1][cdna - 1];
+				pfwd = trellis->forward[genomic - 1][cdna - 1];
+				/* RGenomic1 -> Match */
+				total = emit + (-74.456475068045719);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[0], fwd[2]);
+					score = total + prev[0].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 0;
+						cell[2].length = 1;
+					}
+				}
+				/* RCDna1 -> Match */
+				total = emit + (-72.936443751499382);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[1], fwd[2]);
+					score = total + prev[1].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 1;
+						cell[2].length = 1;
+					}
+				}
+				/* Match -> Match */
+				total = emit + (-0.08242156708689663);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[2], fwd[2]);
+					score = total + prev[2].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].length = prev[2].length + 1;
+						cell[2].trace  = prev[2].trace;
+					}
+				}
+				/* AccU2 -> Match */
+				total = emit + (-72.948668296558409);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[4], fwd[2]);
+					score = total + prev[4].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 4;
+						cell[2].length = 1;
+					}
+				}
+				/* AccU12 -> Match */
+				total = emit + (-72.936443751499382);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[6], fwd[2]);
+					score = total + prev[6].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 6;
+						cell[2].length = 1;
+					}
+				}
+				/* Genomic -> Match */
+				total = emit + (-73.296243845049844);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[13], fwd[2]);
+					score = total + prev[13].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 13;
+						cell[2].length = 1;
+					}
+				}
+				/* CDna -> Match */
+				total = emit + (-72.936443751499382);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[14], fwd[2]);
+					score = total + prev[14].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 14;
+						cell[2].length = 1;
+					}
+				}
+			}
+			/* DonorU2 */
+			if (cell[3].score == MIN_SCORE) {
+				fwd[3] = MIN_SCORE;
+				if (skip == NULL || !skip[3]) {
+					emit = row[1];
+					prev = trellis->cell[genomic - 8][cdna - 0];
+					pfwd = trellis->forward[genomic - 8][cdna - 0];
+					/* Match -> DonorU2 */
+					total = emit + (-2.3211592641207628);
+					if (total != MIN_SCORE) {
+						fwd[3] = zLogAddScore(total + pfwd[2], fwd[3]);
+						score = total + prev[2].score;
+						if (score > cell[3].score) {
+							zSetCellScore(trellis, &cell[3], score);
+							cell[3].trace  = 2;
+							cell[3].length = 1;
+						}
+					}
+					/* Genomic -> DonorU2 */
+					total = emit + (-53.431957909926545);
+					if (total != MIN_SCORE) {
+						fwd[3] = zLogAddScore(total + pfwd[13], fwd[3]);
+						score = total + prev[13].score;
+						if (score > cell[3].score) {
+							zSetCellScore(trellis, &cell[3], score);
+							cell[3].trace  = 13;
+							cell[3].length = 1;
+						}
+					}
+				}
+			}
+			/* AccU2 */
+			if (cell[4].score == MIN_SCORE) {
+				fwd[4] = MIN_SCORE;
+				if (skip == NULL || !skip[4]) {
+					emit = row[2];
+					prev = trellis->cell[genomic - 6][cdna - 0];
+					pfwd = trellis->forward[genomic - 6][cdna - 0];
+					/* BrAccU2 -> AccU2 */
+					total = emit + (0.0013893330730354592);
+					if (total != MIN_SCORE) {
+						fwd[4] = zLogAddScore(total + pfwd[10], fwd[4]);
+						score = total + prev[10].score;
+						if (score > cell[4].score) {
+							zSetCellScore(trellis, &cell[4], score);
+							cell[4].trace  = 10;
+							cell[4].length = 1;
+						}
+					}
+				}
+			}
+			/* DonorU12 */
+			if (cell[5].score == MIN_SCORE) {
+				fwd[5] = MIN_SCORE;
+				if (skip == NULL || !skip[5]) {
+					emit = row[3];
+					prev = trellis->cell[genomic - 8][cdna - 0];
+					pfwd = trellis->forward[genomic - 8][cdna - 0];
+					/* Match -> DonorU12 */
+					total = emit + (-80.796342944841825);
+					if (total != MIN_SCORE) {
+						fwd[5] = zLogAddScore(total + pfwd[2], fwd[5]);
+						score = total + prev[2].score;
+						if (score > cell[5].score) {
+							zSetCellScore(trellis, &cell[5], score);
+							cell[5].trace  = 2;
+							cell[5].length = 1;
+						}
+					}
+				}
+			}
+			/* AccU12 */
+			if (cell[6].score == MIN_SCORE) {
+				fwd[6] = MIN_SCORE;
+				if (skip == NULL || !skip[6]) {
+					emit = row[4];
+					prev = trellis->cell[genomic - 6][cdna - 0];
+					pfwd = trellis->forward[genomic - 6][cdna - 0];
+					/* BrAccU12 -> AccU12 */
+					total = emit + (0.0013893330730354592);
+					if (total != MIN_SCORE) {
+						fwd[6] = zLogAddScore(total + pfwd[12], fwd[6]);
+						score = total + prev[12].score;
+						if (score > cell[6].score) {
+							zSetCellScore(trellis, &cell[6], score);
+							cell[6].trace  = 12;
+							cell[6].length = 1;
+						}
+					}
+				}
+			}
+			/* IntronU2 */
+			if (cell[7].score == MIN_SCORE) {
+				fwd[7] = MIN_SCORE;
+				emit = row[5];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				pfwd = trellis->forward[genomic - 1][cdna - 0];
+				/* DonorU2 -> IntronU2 */
+				total = emit + (-122.5824842002327);
+				if (total != MIN_SCORE) {
+					fwd[7] = zLogAddScore(total + pfwd[3], fwd[7]);
+					score = total + prev[3].score;
+					if (score > cell[7].score) {
+						zSetCellScore(trellis, &cell[7], score);
+						cell[7].trace  = 3;
+						cell[7].length = 1;
+					}
+				}
+				/* IntronU2 -> IntronU2 */
+				total = emit + (-0.0027136216763921084);
+				if (total != MIN_SCORE) {
+					fwd[7] = zLogAddScore(total + pfwd[7], fwd[7]);
+					score = total + prev[7].score;
+					if (score > cell[7].score) {
+						zSetCellScore(trellis, &cell[7], score);
+						cell[7].length = prev[7].length + 1;
+						cell[7].trace  = prev[7].trace;
+					}
+				}
+			}
+			/* IntronU12 */
+			if (cell[8].score == MIN_SCORE) {
+				fwd[8] = MIN_SCORE;
+				emit = row[6];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				pfwd = trellis->forward[genomic - 1][cdna - 0];
+				/* DonorU12 -> IntronU12 */
+				total = emit + (-122.5824842002327);
+				if (total != MIN_SCORE) {
+					fwd[8] = zLogAddScore(total + pfwd[5], fwd[8]);
+					score = total + prev[5].score;
+					if (score > cell[8].score) {
+						zSetCellScore(trellis, &cell[8], score);
+						cell[8].trace  = 5;
+						cell[8].length = 1;
+					}
+				}
+				/* IntronU12 -> IntronU12 */
+				total = emit + (-0.0027136216763921084);
+				if (total != MIN_SCORE) {
+					fwd[8] = zLogAddScore(total + pfwd[8], fwd[8]);
+					score = total + prev[8].score;
+					if (score > cell[8].score) {
+						zSetCellScore(trellis, &cell[8], score);
+						cell[8].length = prev[8].length + 1;
+						cell[8].trace  = prev[8].trace;
+					}
+				}
+			}
+			/* BranchU2 */
+			if (cell[9].score == MIN_SCORE) {
+				fwd[9] = MIN_SCORE;
+				emit = row[7];
+				prev = trellis->cell[genomic - 8][cdna - 0];
+				pfwd = trellis->forward[genomic - 8][cdna - 0];
+				/* IntronU2 -> BranchU2 */
+				total = emit + (0.0018524440974090339);
+				if (total != MIN_SCORE) {
+					fwd[9] = zLogAddScore(total + pfwd[7], fwd[9]);
+					score = total + prev[7].score;
+					if (score > cell[9].score) {
+						zSetCellScore(trellis, &cell[9], score);
+						cell[9].trace  = 7;
+						cell[9].length = 1;
+					}
+				}
+			}
+			/* BrAccU2 */
+			if (cell[10].score == MIN_SCORE) {
+				fwd[10] = MIN_SCORE;
+				if (skip == NULL || !skip[10]) {
+					zExplicitPairTrans(trellis, 9, 10, genomic, cdna);
+				}
+			}
+			/* BranchU12 */
+			if (cell[11].score == MIN_SCORE) {
+				fwd[11] = MIN_SCORE;
+				emit = row[8];
+				prev = trellis->cell[genomic - 8][cdna - 0];
+				pfwd = trellis->forward[genomic - 8][cdna - 0];
+				/* IntronU12 -> BranchU12 */
+				total = emit + (0.0018524440974090339);
+				if (total != MIN_SCORE) {
+					fwd[11] = zLogAddScore(total + pfwd[8], fwd[11]);
+					score = total + prev[8].score;
+					if (score > cell[11].score) {
+						zSetCellScore(trellis, &cell[11], score);
+						cell[11].trace  = 8;
+						cell[11].length = 1;
+					}
+				}
+			}
+			/* BrAccU12 */
+			if (cell[12].score == MIN_SCORE) {
+				fwd[12] = MIN_SCORE;
+				if (skip == NULL || !skip[12]) {
+					zExplicitPairTrans(trellis, 11, 12, genomic, cdna);
+				}
+			}
+			/* Genomic */
+			if (cell[13].score == MIN_SCORE) {
+				fwd[13] = MIN_SCORE;
+				emit = row[9];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				pfwd = trellis->forward[genomic - 1][cdna - 0];
+				/* Match -> Genomic */
+				total = emit + (-90.482772864798079);
+				if (total != MIN_SCORE) {
+					fwd[13] = zLogAddScore(total + pfwd[2], fwd[13]);
+					score = total + prev[2].score;
+					if (score > cell[13].score) {
+						zSetCellScore(trellis, &cell[13], score);
+						cell[13].trace  = 2;
+						cell[13].length = 1;
+					}
+				}
+				/* AccU2 -> Genomic */
+				total = emit + (-154.72113826349525);
+				if (total != MIN_SCORE) {
+					fwd[13] = zLogAddScore(total + pfwd[4], fwd[13]);
+					score = total + prev[4].score;
+					if (score > cell[13].score) {
+						zSetCellScore(trellis, &cell[13], score);
+						cell[13].trace  = 4;
+						cell[13].length = 1;
+					}
+				}
+				/* Genomic -> Genomic */
+				total = emit + (-1.3748036819077356);
+				if (total != MIN_SCORE) {
+					fwd[13] = zLogAddScore(total + pfwd[13], fwd[13]);
+					score = total + prev[13].score;
+					if (score > cell[13].score) {
+						zSetCellScore(trellis, &cell[13], score);
+						cell[13].length = prev[13].length + 1;
+						cell[13].trace  = prev[13].trace;
+					}
+				}
+			}
+			/* CDna */
+			if (cell[14].score == MIN_SCORE) {
+				fwd[14] = MIN_SCORE;
+				emit = column[1][cdna - cstart];
+				prev = trellis->cell[genomic - 0][cdna - 1];
+				pfwd = trellis->forward[genomic - 0][cdna - 1];
+				/* Match -> CDna */
+				total = emit + (-92.811518221546052);
+				if (total != MIN_SCORE) {
+					fwd[14] = zLogAddScore(total + pfwd[2], fwd[14]);
+					score = total + prev[2].score;
+					if (score > cell[14].score) {
+						zSetCellScore(trellis, &cell[14], score);
+						cell[14].trace  = 2;
+						cell[14].length = 1;
+					}
+				}
+				/* AccU2 -> CDna */
+				total = emit + (-143.90263716759512);
+				if (total != MIN_SCORE) {
+					fwd[14] = zLogAddScore(total + pfwd[4], fwd[14]);
+					score = total + prev[4].score;
+					if (score > cell[14].score) {
+						zSetCellScore(trellis, &cell[14], score);
+						cell[14].trace  = 4;
+						cell[14].length = 1;
+					}
+				}
+				/* CDna -> CDna */
+				total = emit + (-1.1452399964432303);
+				if (total != MIN_SCORE) {
+					fwd[14] = zLogAddScore(total + pfwd[14], fwd[14]);
+					score = total + prev[14].score;
+					if (score > cell[14].score) {
+						zSetCellScore(trellis, &cell[14], score);
+						cell[14].length = prev[14].length + 1;
+						cell[14].trace  = prev[14].trace;
+					}
+				}
+			}
+			/* RGenomic2 */
+			if (cell[15].score == MIN_SCORE) {
+				fwd[15] = MIN_SCORE;
+				emit = row[10];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				pfwd = trellis->forward[genomic - 1][cdna - 0];
+				/* Match -> RGenomic2 */
+				total = emit + (-167.17261170293622);
+				if (total != MIN_SCORE) {
+					fwd[15] = zLogAddScore(total + pfwd[2], fwd[15]);
+					score = total + prev[2].score;
+					if (score > cell[15].score) {
+						zSetCellScore(trellis, &cell[15], score);
+						cell[15].trace  = 2;
+						cell[15].length = 1;
+					}
+				}
+				/* RGenomic2 -> RGenomic2 */
+				total = emit + (-0.0012077571450959113);
+				if (total != MIN_SCORE) {
+					fwd[15] = zLogAddScore(total + pfwd[15], fwd[15]);
+					score = total + prev[15].score;
+					if (score > cell[15].score) {
+						zSetCellScore(trellis, &cell[15], score);
+						cell[15].length = prev[15].length + 1;
+						cell[15].trace  = prev[15].trace;
+					}
+				}
+			}
+			/* RCDna2 */
+			if (cell[16].score == MIN_SCORE) {
+				fwd[16] = MIN_SCORE;
+				emit = column[2][cdna - cstart];
+				prev = trellis->cell[genomic - 0][cdna - 1];
+				pfwd = trellis->forward[genomic - 0][cdna - 1];
+				/* Match -> RCDna2 */
+				/* NaN transition, never taken */
+				/* RGenomic2 -> RCDna2 */
+				/* NaN transition, never taken */
+				/* RCDna2 -> RCDna2 */
+				/* NaN transition, never taken */
+			}
+		}
+	}
+	zFree(column[0]);
+	zFree(column[1]);
+	zFree(column[2]);
+}
+
+static void zPairKernel0 (zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi) {
+	if (gend < gstart || cend < cstart) return;
+	if (trellis->forward != NULL) {
+		zPairKernel0Forward(trellis, gstart, gend, cstart, cend, dlo, dhi);
+	} else {
+		zPairKernel0Viterbi(trellis, gstart, gend, cstart, cend, dlo, dhi);
+	}
+}
+
+static const zPairKernel zPairKernel0Entry = {
+	"pairagon +, isochore group 0",
+	822102510UL,
+	zPairKernel0Signature,
+	zPairKernel0
+};
+
+/* pairagon -, isochore group 0 */
+
+static const char *zPairKernel1Signature[] = {
+	"states 17",
+	"state 0 0 4 1 0",
+	"state 1 0 0 0 1",
+	"state 2 0 5 1 1",
+	"state 3 0 4 8 0",
+	"state 4 0 4 6 0",
+	"state 5 0 4 8 0",
+	"state 6 0 4 6 0",
+	"state 7 0 4 1 0",
+	"state 8 0 4 1 0",
+	"state 9 0 4 8 0",
+	"state 10 3 4 1 0",
+	"state 11 0 4 8 0",
+	"state 12 3 4 1 0",
+	"state 13 0 4 1 0",
+	"state 14 0 0 0 1",
+	"state 15 0 4 1 0",
+	"state 16 0 0 0 1",
+	"jump 0 0 -0.0012074700147479689",
+	"jump 1 0 -67.804064738660159",
+	"jump 1 1 -1.3655030597305",
+	"jump 2 0 -74.456475068045719",
+	"jump 2 1 -72.936443751499382",
+	"jump 2 2 -0.08242156708689663",
+	"jump 2 3 -2.3211592641207628",
+	"jump 2 5 -80.796342944841825",
+	"jump 2 13 -73.296243845049844",
+	"jump 2 14 -72.936443751499382",
+	"jump 3 7 -122.5824842002327",
+	"jump 4 2 -72.948668296558409",
+	"jump 4 13 -154.72113826349525",
+	"jump 4 14 -143.90263716759512",
+	"jump 5 8 -122.5824842002327",
+	"jump 6 2 -72.936443751499382",
+	"jump 7 7 -0.0027136216763921084",
+	"jump 7 9 0.0018524440974090339",
+	"jump 8 8 -0.0027136216763921084",
+	"jump 8 11 0.0018524440974090339",
+	"jump 9 10 0.00023155551215836567",
+	"jump 10 4 0.0013893330730354592",
+	"jump 11 12 0.00023155551215836567",
+	"jump 12 6 0.0013893330730354592",
+	"jump 13 2 -90.482772864798079",
+	"jump 13 3 -53.431957909926545",
+	"jump 13 13 -1.3748036819077356",
+	"jump 14 2 -92.811518221546052",
+	"jump 14 14 -1.1452399964432303",
+	"jump 15 2 -167.17261170293622",
+	"jump 15 15 -0.0012077571450959113",
+	"jump 16 2 nan",
+	"jump 16 15 nan",
+	"jump 16 16 nan",
+	NULL
+};
+
+static void zPairKernel1Viterbi (zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi) {
+	zHMM              *hmm = trellis->hmm;
+	zScanner          *scanner[17];
+	score_t            row[11];       /* genomic only emissions of the row */
+	score_t           *column[3];    /* cdna only emissions, cstart..cend */
+	zPairTrellisCell  *cell, *prev;
+	score_t            emit, total, score;
+	coor_t             genomic, cdna;
+	long               clo, chi;
+	coor_t             ahead = zGetSpliceAheadEnd(trellis, gstart, gend);
+	const char        *skip;          /* see zPairSplice.h */
+	int                state;
+
+	for (state = 0; state < 17; state++) scanner[state] = trellis->scanner[hmm->state[state].model];
+	column[0] = zMalloc((cend - cstart + 1)*sizeof(score_t), "zPairKernel1 column");
+	for (cdna = cstart; cdna <= cend; cdna++) column[0][cdna - cstart] = zGetPairUScore(trellis, scanner[1], 1, cdna);
+	column[1] = zMalloc((cend - cstart + 1)*sizeof(score_t), "zPairKernel1 column");
+	for (cdna = cstart; cdna <= cend; cdna++) column[1][cdna - cstart] = zGetPairUScore(trellis, scanner[14], 14, cdna);
+	column[2] = zMalloc((cend - cstart + 1)*sizeof(score_t), "zPairKernel1 column");
+	for (cdna = cstart; cdna <= cend; cdna++) column[2][cdna - cstart] = zGetPairUScore(trellis, scanner[16], 16, cdna);
+
+	for (genomic = gstart; genomic <= gend; genomic++) {
+		clo = MAX((long)cstart, (long)genomic - dhi);
+		chi = MIN((long)cend,   (long)genomic - dlo);
+		if (chi < clo || trellis->cell[genomic] == NULL) continue;
+		row[0] = zGetPairUScore(trellis, scanner[0], 0, genomic);
+		row[1] = zGetPairUScore(trellis, scanner[3], 3, genomic);
+		row[2] = zGetPairUScore(trellis, scanner[4], 4, genomic);
+		row[3] = zGetPairUScore(trellis, scanner[5], 5, genomic);
+		row[4] = zGetPairUScore(trellis, scanner[6], 6, genomic);
+		row[5] = zGetPairUScore(trellis, scanner[7], 7, genomic);
+		row[6] = zGetPairUScore(trellis, scanner[8], 8, genomic);
+		row[7] = zGetPairUScore(trellis, scanner[9], 9, genomic);
+		row[8] = zGetPairUScore(trellis, scanner[11], 11, genomic);
+		row[9] = zGetPairUScore(trellis, scanner[13], 13, genomic);
+		row[10] = zGetPairUScore(trellis, scanner[15], 15, genomic);
+		skip = zGetSpliceSkipRow(trellis, genomic, ahead);
+		for (cdna = clo; cdna <= (coor_t)chi; cdna++) {
+			if (NULL == (cell = trellis->cell[genomic][cdna])) continue;
+			/* RGenomic1 */
+			if (cell[0].score == MIN_SCORE) {
+				emit = row[0];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				/* RGenomic1 -> RGenomic1 */
+				total = emit + (-0.0012074700147479689);
+				if (total != MIN_SCORE) {
+					score = total + prev[0].score;
+					if (score > cell[0].score) {
+						zSetCellScore(trellis, &cell[0], score);
+						cell[0].length = prev[0].length + 1;
+						cell[0].trace  = prev[0].trace;
+					}
+				}
+			}
+			/* RCDna1 */
+			if (cell[1].score == MIN_SCORE) {
+				emit = column[0][cdna - cstart];
+				prev = trellis->cell[genomic - 0][cdna - 1];
+				/* RGenomic1 -> RCDna1 */
+				total = emit + (-67.804064738660159);
+				if (total != MIN_SCORE) {
+					score = total + prev[0].score;
+					if (score > cell[1].score) {
+						zSetCellScore(trellis, &cell[1], score);
+						cell[1].trace  = 0;
+						cell[1].length = 1;
+					}
+				}
+				/* RCDna1 -> RCDna1 */
+				total = emit + (-1.3655030597305);
+				if (total != MIN_SCORE) {
+					score = total + prev[1].score;
+					if (score > cell[1].score) {
+						zSetCellScore(trellis, &cell[1], score);
+						cell[1].length = prev[1].length + 1;
+						cell[1].trace  = prev[1].trace;
+					}
+				}
+			}
+			/* Match */
+			if (cell[2].score == MIN_SCORE) {
+				emit = zGetPairEmission(trellis, scanner[2], genomic, cdna);
+				prev = trellis->cell[genomic - 1][cdna - 1];
+				/* RGenomic1 -> Match */
+				total = emit + (-74.456475068045719);
+				if (total != MIN_SCORE) {
+					score = total + prev[0].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 0;
+						cell[2].length = 1;
+					}
+				}
+				/* RCDna1 -> Match */
+				total = emit + (-72.936443751499382);
+				if (total != MIN_SCORE) {
+					score = total + prev[1].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 1;
+						cell[2].length = 1;
+					}
+				}
+				/* Match -> Match */
+				total = emit + (-0.08242156708689663);
+				if (total != MIN_SCORE) {
+					score = total + prev[2].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].length = prev[2].length + 1;
+						cell[2].trace  = prev[2].trace;
+					}
+				}
+				/* DonorU2 -> Match */
+				total = emit + (-2.3211592641207628);
+				if (total != MIN_SCORE) {
+					score = total + prev[3].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 3;
+						cell[2].length = 1;
+					}
+				}
+				/* DonorU12 -> Match */
+				total = emit + (-80.796342944841825);
+				if (total != MIN_SCORE) {
+					score = total + prev[5].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 5;
+						cell[2].length = 1;
+					}
+				}
+				/* Genomic -> Match */
+				total = emit + (-73.296243845049844);
+				if (total != MIN_SCORE) {
+					score = total + prev[13].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 13;
+						cell[2].length = 1;
+					}
+				}
+				/* CDna -> Match */
+				total = emit + (-72.936443751499382);
+				if (total != MIN_SCORE) {
+					score = total + prev[14].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 14;
+						cell[2].length = 1;
+					}
+				}
+			}
+			/* DonorU2 */
+			if (cell[3].score == MIN_SCORE) {
+				if (skip == NULL || !skip[3]) {
+					emit = row[1];
+					prev = trellis->cell[genomic - 8][cdna - 0];
+					/* IntronU2 -> DonorU2 */
+					total = emit + (-122.5824842002327);
+					if (total != MIN_SCORE) {
+						score = total + prev[7].score;
+						if (score > cell[3].score) {
+							zSetCellScore(trellis, &cell[3], score);
+							cell[3].trace  = 7;
+							cell[3].length = 1;
+						}
+					}
+				}
+			}
+			/* AccU2 */
+			if (cell[4].score == MIN_SCORE) {
+				if (skip == NULL || !skip[4]) {
+					emit = row[2];
+					prev = trellis->cell[genomic - 6][cdna - 0];
+					/* Match -> AccU2 */
+					total = emit + (-72.948668296558409);
+					if (total != MIN_SCORE) {
+						score = total + prev[2].score;
+						if (score > cell[4].score) {
+							zSetCellScore(trellis, &cell[4], score);
+							cell[4].trace  = 2;
+							cell[4].length = 1;
+						}
+					}
+					/* Genomic -> AccU2 */
+					total = emit + (-154.72113826349525);
+					if (total != MIN_SCORE) {
+						score = total + prev[13].score;
+						if (score > cell[4].score) {
+							zSetCellScore(trellis, &cell[4], score);
+							cell[4].trace  = 13;
+							cell[4].length = 1;
+						}
+					}
+					/* CDna -> AccU2 */
+					total = emit + (-143.90263716759512);
+					if (total != MIN_SCORE) {
+						score = total + prev[14].score;
+						if (score > cell[4].score) {
+							zSetCellScore(trellis, &cell[4], score);
+							cell[4].trace  = 14;
+							cell[4].length = 1;
+						}
+					}
+				}
+			}
+			/* DonorU12 */
+			if (cell[5].score == MIN_SCORE) {
+				if (skip == NULL || !skip[5]) {
+					emit = row[3];
+					prev = trellis->cell[genomic - 8][cdna - 0];
+					/* IntronU12 -> DonorU12 */
+					total = emit + (-122.5824842002327);
+					if (total != MIN_SCORE) {
+						score = total + prev[8].score;
+						if (score > cell[5].score) {
+							zSetCellScore(trellis, &cell[5], score);
+							cell[5].trace  = 8;
+							cell[5].length = 1;
+						}
+					}
+				}
+			}
+			/* AccU12 */
+			if (cell[6].score == MIN_SCORE) {
+				if (skip == NULL || !skip[6]) {
+					emit = row[4];
+					prev = trellis->cell[genomic - 6][cdna - 0];
+					/* Match -> AccU12 */
+					total = emit + (-72.936443751499382);
+					if (total != MIN_SCORE) {
+						score = total + prev[2].score;
+						if (score > cell[6].score) {
+							zSetCellScore(trellis, &cell[6], score);
+							cell[6].trace  = 2;
+							cell[6].length = 1;
+						}
+					}
+				}
+			}
+			/* IntronU2 */
+			if (cell[7].score == MIN_SCORE) {
+				emit = row[5];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				/* IntronU2 -> IntronU2 */
+				total = emit + (-0.0027136216763921084);
+				if (total != MIN_SCORE) {
+					score = total + prev[7].score;
+					if (score > cell[7].score) {
+						zSetCellScore(trellis, &cell[7], score);
+						cell[7].length = prev[7].length + 1;
+						cell[7].trace  = prev[7].trace;
+					}
+				}
+				/* BranchU2 -> IntronU2 */
+				total = emit + (0.0018524440974090339);
+				if (total != MIN_SCORE) {
+					score = total + prev[9].score;
+					if (score > cell[7].score) {
+						zSetCellScore(trellis, &cell[7], score);
+						cell[7].trace  = 9;
+						cell[7].length = 1;
+					}
+				}
+			}
+			/* IntronU12 */
+			if (cell[8].score == MIN_SCORE) {
+				emit = row[6];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				/* IntronU12 -> IntronU12 */
+				total = emit + (-0.0027136216763921084);
+				if (total != MIN_SCORE) {
+					score = total + prev[8].score;
+					if (score > cell[8].score) {
+						zSetCellScore(trellis, &cell[8], score);
+						cell[8].length = prev[8].length + 1;
+						cell[8].trace  = prev[8].trace;
+					}
+				}
+				/* BranchU12 -> IntronU12 */
+				total = emit + (0.0018524440974090339);
+				if (total != MIN_SCORE) {
+					score = total + prev[11].score;
+					if (score > cell[8].score) {
+						zSetCellScore(trellis, &cell[8], score);
+						cell[8].trace  = 11;
+						cell[8].length = 1;
+					}
+				}
+			}
+			/* BranchU2 */
+			if (cell[9].score == MIN_SCORE) {
+				emit = row[7];
+				prev = trellis->cell[genomic - 8][cdna - 0];
+				/* BrAccU2 -> BranchU2 */
+				total = emit + (0.00023155551215836567);
+				if (total != MIN_SCORE) {
+					score = total + prev[10].score;
+					if (score > cell[9].score) {
+						zSetCellScore(trellis, &cell[9], score);
+						cell[9].trace  = 10;
+						cell[9].length = 1;
+					}
+				}
+			}
+			/* BrAccU2 */
+			if (cell[10].score == MIN_SCORE) {
+				if (skip == NULL || !skip[10]) {
+					zExplicitPairTrans(trellis, 4, 10, genomic, cdna);
+				}
+			}
+			/* BranchU12 */
+			if (cell[11].score == MIN_SCORE) {
+				emit = row[8];
+				prev = trellis->cell[genomic - 8][cdna - 0];
+				/* BrAccU12 -> BranchU12 */
+				total = emit + (0.00023155551215836567);
+				if (total != MIN_SCORE) {
+					score = total + prev[12].score;
+					if (score > cell[11].score) {
+						zSetCellScore(trellis, &cell[11], score);
+						cell[11].trace  = 12;
+						cell[11].length = 1;
+					}
+				}
+			}
+			/* BrAccU12 */
+			if (cell[12].score == MIN_SCORE) {
+				if (skip == NULL || !skip[12]) {
+					zExplicitPairTrans(trellis, 6, 12, genomic, cdna);
+				}
+			}
+			/* Genomic */
+			if (cell[13].score == MIN_SCORE) {
+				emit = row[9];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				/* Match -> Genomic */
+				total = emit + (-90.482772864798079);
+				if (total != MIN_SCORE) {
+					score = total + prev[2].score;
+					if (score > cell[13].score) {
+						zSetCellScore(trellis, &cell[13], score);
+						cell[13].trace  = 2;
+						cell[13].length = 1;
+					}
+				}
+				/* DonorU2 -> Genomic */
+				total = emit + (-53.431957909926545);
+				if (total != MIN_SCORE) {
+					score = total + prev[3].score;
+					if (score > cell[13].score) {
+						zSetCellScore(trellis, &cell[13], score);
+						cell[13].trace  = 3;
+						cell[13].length = 1;
+					}
+				}
+				/* Genomic -> Genomic */
+				total = emit + (-1.3748036819077356);
+				if (total != MIN_SCORE) {
+					score = total + prev[13].score;
+					if (score > cell[13].score) {
+						zSetCellScore(trellis, &cell[13], score);
+						cell[13].length = prev[13].length + 1;
+						cell[13].trace  = prev[13].trace;
+					}
+				}
+			}
+			/* CDna */
+			if (cell[14].score == MIN_SCORE) {
+				emit = column[1][cdna - cstart];
+				prev = trellis->cell[genomic - 0][cdna - 1];
+				/* Match -> CDna */
+				total = emit + (-92.811518221546052);
+				if (total != MIN_SCORE) {
+					score = total + prev[2].score;
+					if (score > cell[14].score) {
+						zSetCellScore(trellis, &cell[14], score);
+						cell[14].trace  = 2;
+						cell[14].length = 1;
+					}
+				}
+				/* CDna -> CDna */
+				total = emit + (-1.1452399964432303);
+				if (total != MIN_SCORE) {
+					score = total + prev[14].score;
+					if (score > cell[14].score) {
+						zSetCellScore(trellis, &cell[14], score);
+						cell[14].length = prev[14].length + 1;
+						cell[14].trace  = prev[14].trace;
+					}
+				}
+			}
+			/* RGenomic2 */
+			if (cell[15].score == MIN_SCORE) {
+				emit = row[10];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				/* Match -> RGenomic2 */
+				total = emit + (-167.17261170293622);
+				if (total != MIN_SCORE) {
+					score = total + prev[2].score;
+					if (score > cell[15].score) {
+						zSetCellScore(trellis, &cell[15], score);
+						cell[15].trace  = 2;
+						cell[15].length = 1;
+					}
+				}
+				/* RGenomic2 -> RGenomic2 */
+				total = emit + (-0.0012077571450959113);
+				if (total != MIN_SCORE) {
+					score = total + prev[15].score;
+					if (score > cell[15].score) {
+						zSetCellScore(trellis, &cell[15], score);
+						cell[15].length = prev[15].length + 1;
+						cell[15].trace  = prev[15].trace;
+					}
+				}
+			}
+			/* RCDna2 */
+			if (cell[16].score == MIN_SCORE) {
+				emit = column[2][cdna - cstart];
+				prev = trellis->cell[genomic - 0][cdna - 1];
+				/* Match -> RCDna2 */
+				/* NaN transition, never taken */
+				/* RGenomic2 -> RCDna2 */
+				/* NaN transition, never taken */
+				/* RCDna2 -> RCDna2 */
+				/* NaN transition, never taken */
+			}
+		}
+	}
+	zFree(column[0]);
+	zFree(column[1]);
+	zFree(column[2]);
+}
+
+static void zPairKernel1Forward (zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi) {
+	zHMM              *hmm = trellis->hmm;
+	zScanner          *scanner[17];
+	score_t            row[11];       /* genomic only emissions of the row */
+	score_t           *column[3];    /* cdna only emissions, cstart..cend */
+	zPairTrellisCell  *cell, *prev;
+	score_t           *fwd, *pfwd;
+	score_t            emit, total, score;
+	coor_t             genomic, cdna;
+	long               clo, chi;
+	coor_t             ahead = zGetSpliceAheadEnd(trellis, gstart, gend);
+	const char        *skip;          /* see zPairSplice.h */
+	int                state;
+
+	for (state = 0; state < 17; state++) scanner[state] = trellis->scanner[hmm->state[state].model];
+	column[0] = zMalloc((cend - cstart + 1)*sizeof(score_t), "zPairKernel1 column");
+	for (cdna = cstart; cdna <= cend; cdna++) column[0][cdna - cstart] = zGetPairUScore(trellis, scanner[1], 1, cdna);
+	column[1] = zMalloc((cend - cstart + 1)*sizeof(score_t), "zPairKernel1 column");
+	for (cdna = cstart; cdna <= cend; cdna++) column[1][cdna - cstart] = zGetPairUScore(trellis, scanner[14], 14, cdna);
+	column[2] = zMalloc((cend - cstart + 1)*sizeof(score_t), "zPairKernel1 column");
+	for (cdna = cstart; cdna <= cend; cdna++) column[2][cdna - cstart] = zGetPairUScore(trellis, scanner[16], 16, cdna);
+
+	for (genomic = gstart; genomic <= gend; genomic++) {
+		clo = MAX((long)cstart, (long)genomic - dhi);
+		chi = MIN((long)cend,   (long)genomic - dlo);
+		if (chi < clo || trellis->cell[genomic] == NULL) continue;
+		row[0] = zGetPairUScore(trellis, scanner[0], 0, genomic);
+		row[1] = zGetPairUScore(trellis, scanner[3], 3, genomic);
+		row[2] = zGetPairUScore(trellis, scanner[4], 4, genomic);
+		row[3] = zGetPairUScore(trellis, scanner[5], 5, genomic);
+		row[4] = zGetPairUScore(trellis, scanner[6], 6, genomic);
+		row[5] = zGetPairUScore(trellis, scanner[7], 7, genomic);
+		row[6] = zGetPairUScore(trellis, scanner[8], 8, genomic);
+		row[7] = zGetPairUScore(trellis, scanner[9], 9, genomic);
+		row[8] = zGetPairUScore(trellis, scanner[11], 11, genomic);
+		row[9] = zGetPairUScore(trellis, scanner[13], 13, genomic);
+		row[10] = zGetPairUScore(trellis, scanner[15], 15, genomic);
+		skip = zGetSpliceSkipRow(trellis, genomic, ahead);
+		for (cdna = clo; cdna <= (coor_t)chi; cdna++) {
+			if (NULL == (cell = trellis->cell[genomic][cdna])) continue;
+			fwd = trellis->forward[genomic][cdna];
+			/* RGenomic1 */
+			if (cell[0].score == MIN_SCORE) {
+				fwd[0] = MIN_SCORE;
+				emit = row[0];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				pfwd = trellis->forward[genomic - 1][cdna - 0];
+				/* RGenomic1 -> RGenomic1 */
+				total = emit + (-0.0012074700147479689);
+				if (total != MIN_SCORE) {
+					fwd[0] = zLogAddScore(total + pfwd[0], fwd[0]);
+					score = total + prev[0].score;
+					if (score > cell[0].score) {
+						zSetCellScore(trellis, &cell[0], score);
+						cell[0].length = prev[0].length + 1;
+						cell[0].trace  = prev[0].trace;
+					}
+				}
+			}
+			/* RCDna1 */
+			if (cell[1].score == MIN_SCORE) {
+				fwd[1] = MIN_SCORE;
+				emit = column[0][cdna - cstart];
+				prev = trellis->cell[genomic - 0][cdna - 1];
+				pfwd = trellis->forward[genomic - 0][cdna - 1];
+				/* RGenomic1 -> RCDna1 */
+				total = emit + (-67.804064738660159);
+				if (total != MIN_SCORE) {
+					fwd[1] = zLogAddScore(total + pfwd[0], fwd[1]);
+					score = total + prev[0].score;
+					if (score > cell[1].score) {
+						zSetCellScore(trellis, &cell[1], score);
+						cell[1].trace  = 0;
+						cell[1].length = 1;
+					}
+				}
+				/* RCDna1 -> RCDna1 */
+				total = emit + (-1.3655030597305);
+				if (total != MIN_SCORE) {
+					fwd[1] = zLogAddScore(total + pfwd[1], fwd[1]);
+					score = total + prev[1].score;
+					if (score > cell[1].score) {
+						zSetCellScore(trellis, &cell[1], score);
+						cell[1].length = prev[1].length + 1;
+						cell[1].trace  = prev[1].trace;
+					}
+				}
+			}
+			/* Match */
+			if (cell[2].score == MIN_SCORE) {
+				fwd[2] = MIN_SCORE;
+				emit = zGetPairEmission(trellis, scanner[2], genomic, cdna);
+				prev = trellis->cell[genomic - 1][cdna - 1];
+				pfwd = trellis->forward[genomic - 1][cdna - 1];
+				/* RGenomic1 -> Match */
+				total = emit + (-74.456475068045719);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[0], fwd[2]);
+					score = total + prev[0].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 0;
+						cell[2].length = 1;
+					}
+				}
+				/* RCDna1 -> Match */
+				total = emit + (-72.936443751499382);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[1], fwd[2]);
+					score = total + prev[1].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 1;
+						cell[2].length = 1;
+					}
+				}
+				/* Match -> Match */
+				total = emit + (-0.08242156708689663);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[2], fwd[2]);
+					score = total + prev[2].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].length = prev[2].length + 1;
+						cell[2].trace  = prev[2].trace;
+					}
+				}
+				/* DonorU2 -> Match */
+				total = emit + (-2.3211592641207628);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[3], fwd[2]);
+					score = total + prev[3].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 3;
+						cell[2].length = 1;
+					}
+				}
+				/* DonorU12 -> Match */
+				total = emit + (-80.796342944841825);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[5], fwd[2]);
+					score = total + prev[5].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 5;
+						cell[2].length = 1;
+					}
+				}
+				/* Genomic -> Match */
+				total = emit + (-73.296243845049844);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[13], fwd[2]);
+					score = total + prev[13].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 13;
+						cell[2].length = 1;
+					}
+				}
+				/* CDna -> Match */
+				total = emit + (-72.936443751499382);
+				if (total != MIN_SCORE) {
+					fwd[2] = zLogAddScore(total + pfwd[14], fwd[2]);
+					score = total + prev[14].score;
+					if (score > cell[2].score) {
+						zSetCellScore(trellis, &cell[2], score);
+						cell[2].trace  = 14;
+						cell[2].length = 1;
+					}
+				}
+			}
+			/* DonorU2 */
+			if (cell[3].score == MIN_SCORE) {
+				fwd[3] = MIN_SCORE;
+				if (skip == NULL || !skip[3]) {
+					emit = row[1];
+					prev = trellis->cell[genomic - 8][cdna - 0];
+					pfwd = trellis->forward[genomic - 8][cdna - 0];
+					/* IntronU2 -> DonorU2 */
+					total = emit + (-122.5824842002327);
+					if (total != MIN_SCORE) {
+						fwd[3] = zLogAddScore(total + pfwd[7], fwd[3]);
+						score = total + prev[7].score;
+						if (score > cell[3].score) {
+							zSetCellScore(trellis, &cell[3], score);
+							cell[3].trace  = 7;
+							cell[3].length = 1;
+						}
+					}
+				}
+			}
+			/* AccU2 */
+			if (cell[4].score == MIN_SCORE) {
+				fwd[4] = MIN_SCORE;
+				if (skip == NULL || !skip[4]) {
+					emit = row[2];
+					prev = trellis->cell[genomic - 6][cdna - 0];
+					pfwd = trellis->forward[genomic - 6][cdna - 0];
+					/* Match -> AccU2 */
+					total = emit + (-72.948668296558409);
+					if (total != MIN_SCORE) {
+						fwd[4] = zLogAddScore(total + pfwd[2], fwd[4]);
+						score = total + prev[2].score;
+						if (score > cell[4].score) {
+							zSetCellScore(trellis, &cell[4], score);
+							cell[4].trace  = 2;
+							cell[4].length = 1;
+						}
+					}
+					/* Genomic -> AccU2 */
+					total = emit + (-154.72113826349525);
+					if (total != MIN_SCORE) {
+						fwd[4] = zLogAddScore(total + pfwd[13], fwd[4]);
+						score = total + prev[13].score;
+						if (score > cell[4].score) {
+							zSetCellScore(trellis, &cell[4], score);
+							cell[4].trace  = 13;
+							cell[4].length = 1;
+						}
+					}
+					/* CDna -> AccU2 */
+					total = emit + (-143.90263716759512);
+					if (total != MIN_SCORE) {
+						fwd[4] = zLogAddScore(total + pfwd[14], fwd[4]);
+						score = total + prev[14].score;
+						if (score > cell[4].score) {
+							zSetCellScore(trellis, &cell[4], score);
+							cell[4].trace  = 14;
+							cell[4].length = 1;
+						}
+					}
+				}
+			}
+			/* DonorU12 */
+			if (cell[5].score == MIN_SCORE) {
+				fwd[5] = MIN_SCORE;
+				if (skip == NULL || !skip[5]) {
+					emit = row[3];
+					prev = trellis->cell[genomic - 8][cdna - 0];
+					pfwd = trellis->forward[genomic - 8][cdna - 0];
+					/* IntronU12 -> DonorU12 */
+					total = emit + (-122.5824842002327);
+					if (total != MIN_SCORE) {
+						fwd[5] = zLogAddScore(total + pfwd[8], fwd[5]);
+						score = total + prev[8].score;
+						if (score > cell[5].score) {
+							zSetCellScore(trellis, &cell[5], score);
+							cell[5].trace  = 8;
+							cell[5].length = 1;
+						}
+					}
+				}
+			}
+			/* AccU12 */
+			if (cell[6].score == MIN_SCORE) {
+				fwd[6] = MIN_SCORE;
+				if (skip == NULL || !skip[6]) {
+					emit = row[4];
+					prev = trellis->cell[genomic - 6][cdna - 0];
+					pfwd = trellis->forward[genomic - 6][cdna - 0];
+					/* Match -> AccU12 */
+					total = emit + (-72.936443751499382);
+					if (total != MIN_SCORE) {
+						fwd[6] = zLogAddScore(total + pfwd[2], fwd[6]);
+						score = total + prev[2].score;
+						if (score > cell[6].score) {
+							zSetCellScore(trellis, &cell[6], score);
+							cell[6].trace  = 2;
+							cell[6].length = 1;
+						}
+					}
+				}
+			}
+			/* IntronU2 */
+			if (cell[7].score == MIN_SCORE) {
+				fwd[7] = MIN_SCORE;
+				emit = row[5];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				pfwd = trellis->forward[genomic - 1][cdna - 0];
+				/* IntronU2 -> IntronU2 */
+				total = emit + (-0.0027136216763921084);
+				if (total != MIN_SCORE) {
+					fwd[7] = zLogAddScore(total + pfwd[7], fwd[7]);
+					score = total + prev[7].score;
+					if (score > cell[7].score) {
+						zSetCellScore(trellis, &cell[7], score);
+						cell[7].length = prev[7].length + 1;
+						cell[7].trace  = prev[7].trace;
+					}
+				}
+				/* BranchU2 -> IntronU2 */
+				total = emit + (0.0018524440974090339);
+				if (total != MIN_SCORE) {
+					fwd[7] = zLogAddScore(total + pfwd[9], fwd[7]);
+					score = total + prev[9].score;
+					if (score > cell[7].score) {
+						zSetCellScore(trellis, &cell[7], score);
+						cell[7].trace  = 9;
+						cell[7].length = 1;
+					}
+				}
+			}
+			/* IntronU12 */
+			if (cell[8].score == MIN_SCORE) {
+				fwd[8] = MIN_SCORE;
+				emit = row[6];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				pfwd = trellis->forward[genomic - 1][cdna - 0];
+				/* IntronU12 -> IntronU12 */
+				total = emit + (-0.0027136216763921084);
+				if (total != MIN_SCORE) {
+					fwd[8] = zLogAddScore(total + pfwd[8], fwd[8]);
+					score = total + prev[8].score;
+					if (score > cell[8].score) {
+						zSetCellScore(trellis, &cell[8], score);
+						cell[8].length = prev[8].length + 1;
+						cell[8].trace  = prev[8].trace;
+					}
+				}
+				/* BranchU12 -> IntronU12 */
+				total = emit + (0.0018524440974090339);
+				if (total != MIN_SCORE) {
+					fwd[8] = zLogAddScore(total + pfwd[11], fwd[8]);
+					score = total + prev[11].score;
+					if (score > cell[8].score) {
+						zSetCellScore(trellis, &cell[8], score);
+						cell[8].trace  = 11;
+						cell[8].length = 1;
+					}
+				}
+			}
+			/* BranchU2 */
+			if (cell[9].score == MIN_SCORE) {
+				fwd[9] = MIN_SCORE;
+				emit = row[7];
+				prev = trellis->cell[genomic - 8][cdna - 0];
+				pfwd = trellis->forward[genomic - 8][cdna - 0];
+				/* BrAccU2 -> BranchU2 */
+				total = emit + (0.00023155551215836567);
+				if (total != MIN_SCORE) {
+					fwd[9] = zLogAddScore(total + pfwd[10], fwd[9]);
+					score = total + prev[10].score;
+					if (score > cell[9].score) {
+						zSetCellScore(trellis, &cell[9], score);
+						cell[9].trace  = 10;
+						cell[9].length = 1;
+					}
+				}
+			}
+			/* BrAccU2 */
+			if (cell[10].score == MIN_SCORE) {
+				fwd[10] = MIN_SCORE;
+				if (skip == NULL || !skip[10]) {
+					zExplicitPairTrans(trellis, 4, 10, genomic, cdna);
+				}
+			}
+			/* BranchU12 */
+			if (cell[11].score == MIN_SCORE) {
+				fwd[11] = MIN_SCORE;
+				emit = row[8];
+				prev = trellis->cell[genomic - 8][cdna - 0];
+				pfwd = trellis->forward[genomic - 8][cdna - 0];
+				/* BrAccU12 -> BranchU12 */
+				total = emit + (0.00023155551215836567);
+				if (total != MIN_SCORE) {
+					fwd[11] = zLogAddScore(total + pfwd[12], fwd[11]);
+					score = total + prev[12].score;
+					if (score > cell[11].score) {
+						zSetCellScore(trellis, &cell[11], score);
+						cell[11].trace  = 12;
+						cell[11].length = 1;
+					}
+				}
+			}
+			/* BrAccU12 */
+			if (cell[12].score == MIN_SCORE) {
+				fwd[12] = MIN_SCORE;
+				if (skip == NULL || !skip[12]) {
+					zExplicitPairTrans(trellis, 6, 12, genomic, cdna);
+				}
+			}
+			/* Genomic */
+			if (cell[13].score == MIN_SCORE) {
+				fwd[13] = MIN_SCORE;
+				emit = row[9];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				pfwd = trellis->forward[genomic - 1][cdna - 0];
+				/* Match -> Genomic */
+				total = emit + (-90.482772864798079);
+				if (total != MIN_SCORE) {
+					fwd[13] = zLogAddScore(total + pfwd[2], fwd[13]);
+					score = total + prev[2].score;
+					if (score > cell[13].score) {
+						zSetCellScore(trellis, &cell[13], score);
+						cell[13].trace  = 2;
+						cell[13].length = 1;
+					}
+				}
+				/* DonorU2 -> Genomic */
+				total = emit + (-53.431957909926545);
+				if (total != MIN_SCORE) {
+					fwd[13] = zLogAddScore(total + pfwd[3], fwd[13]);
+					score = total + prev[3].score;
+					if (score > cell[13].score) {
+						zSetCellScore(trellis, &cell[13], score);
+						cell[13].trace  = 3;
+						cell[13].length = 1;
+					}
+				}
+				/* Genomic -> Genomic */
+				total = emit + (-1.3748036819077356);
+				if (total != MIN_SCORE) {
+					fwd[13] = zLogAddScore(total + pfwd[13], fwd[13]);
+					score = total + prev[13].score;
+					if (score > cell[13].score) {
+						zSetCellScore(trellis, &cell[13], score);
+						cell[13].length = prev[13].length + 1;
+						cell[13].trace  = prev[13].trace;
+					}
+				}
+			}
+			/* CDna */
+			if (cell[14].score == MIN_SCORE) {
+				fwd[14] = MIN_SCORE;
+				emit = column[1][cdna - cstart];
+				prev = trellis->cell[genomic - 0][cdna - 1];
+				pfwd = trellis->forward[genomic - 0][cdna - 1];
+				/* Match -> CDna */
+				total = emit + (-92.811518221546052);
+				if (total != MIN_SCORE) {
+					fwd[14] = zLogAddScore(total + pfwd[2], fwd[14]);
+					score = total + prev[2].score;
+					if (score > cell[14].score) {
+						zSetCellScore(trellis, &cell[14], score);
+						cell[14].trace  = 2;
+						cell[14].length = 1;
+					}
+				}
+				/* CDna -> CDna */
+				total = emit + (-1.1452399964432303);
+				if (total != MIN_SCORE) {
+					fwd[14] = zLogAddScore(total + pfwd[14], fwd[14]);
+					score = total + prev[14].score;
+					if (score > cell[14].score) {
+						zSetCellScore(trellis, &cell[14], score);
+						cell[14].length = prev[14].length + 1;
+						cell[14].trace  = prev[14].trace;
+					}
+				}
+			}
+			/* RGenomic2 */
+			if (cell[15].score == MIN_SCORE) {
+				fwd[15] = MIN_SCORE;
+				emit = row[10];
+				prev = trellis->cell[genomic - 1][cdna - 0];
+				pfwd = trellis->forward[genomic - 1][cdna - 0];
+				/* Match -> RGenomic2 */
+				total = emit + (-167.17261170293622);
+				if (total != MIN_SCORE) {
+					fwd[15] = zLogAddScore(total + pfwd[2], fwd[15]);
+					score = total + prev[2].score;
+					if (score > cell[15].score) {
+						zSetCellScore(trellis, &cell[15], score);
+						cell[15].trace  = 2;
+						cell[15].length = 1;
+					}
+				}
+				/* RGenomic2 -> RGenomic2 */
+				total = emit + (-0.0012077571450959113);
+				if (total != MIN_SCORE) {
+					fwd[15] = zLogAddScore(total + pfwd[15], fwd[15]);
+					score = total + prev[15].score;
+					if (score > cell[15].score) {
+						zSetCellScore(trellis, &cell[15], score);
+						cell[15].length = prev[15].length + 1;
+						cell[15].trace  = prev[15].trace;
+					}
+				}
+			}
+			/* RCDna2 */
+			if (cell[16].score == MIN_SCORE) {
+				fwd[16] = MIN_SCORE;
+				emit = column[2][cdna - cstart];
+				prev = trellis->cell[genomic - 0][cdna - 1];
+				pfwd = trellis->forward[genomic - 0][cdna - 1];
+				/* Match -> RCDna2 */
+				/* NaN transition, never taken */
+				/* RGenomic2 -> RCDna2 */
+				/* NaN transition, never taken */
+				/* RCDna2 -> RCDna2 */
+				/* NaN transition, never taken */
+			}
+		}
+	}
+	zFree(column[0]);
+	zFree(column[1]);
+	zFree(column[2]);
+}
+
+static void zPairKernel1 (zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi) {
+	if (gend < gstart || cend < cstart) return;
+	if (trellis->forward != NULL) {
+		zPairKernel1Forward(trellis, gstart, gend, cstart, cend, dlo, dhi);
+	} else {
+		zPairKernel1Viterbi(trellis, gstart, gend, cstart, cend, dlo, dhi);
+	}
+}
+
+static const zPairKernel zPairKernel1Entry = {
+	"pairagon -, isochore group 0",
+	2673836106UL,
+	zPairKernel1Signature,
+	zPairKernel1
+};
+
+void zRegisterPairKernels (void) {
+	zAddPairKernel(&zPairKernel0Entry);
+	zAddPairKernel(&zPairKernel1Entry);
+}
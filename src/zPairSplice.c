@@ -0,0 +1,268 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/******************************************************************************\
+  zPairSplice.c - part of the ZOE library for genomic analysis
+
+  A row of a splice state is a candidate site unless its scanner scores
+  MIN_SCORE there; every jump into the state then adds up to MIN_SCORE or
+  less, which zInternalPairTransHelper and zStartAlignmentForward leave
+  alone. The flags of the explicit states are counted from the candidate
+  sites of the splice states next to them, once per trellis.
+
+\******************************************************************************/
+
+#ifndef ZOE_PAIR_SPLICE_C
+#define ZOE_PAIR_SPLICE_C
+
+#include "zPairSplice.h"
+#include "zHardCoding.h"
+
+/* The donors and acceptors, as long as their cells only depend on one genomic row */
+
+static bool zIsSpliceState (zHMM *hmm, int state) {
+	if (state != zGetU2Donor(hmm) && state != zGetU2Acceptor(hmm)
+		&& state != zGetU12Donor(hmm) && state != zGetU12Acceptor(hmm)) return false;
+	if (hmm->state[state].type != INTERNAL && hmm->state[state].type != GINTERNAL) return false;
+	if (zGetCDnaIncrement(hmm, state) != 0) return false;
+	return hmm->mmap[hmm->state[state].model]->seq_type == GENOMIC;
+}
+
+/* States zInitPairSpliceSites may give flags to, for zPairKernelGen */
+
+bool zIsSplicePrunedState (zHMM *hmm, int state) {
+	return zIsSpliceState(hmm, state) || hmm->state[state].type == EXPLICIT;
+}
+
+/* MIN_SCORE emission: no jump into the state can lift it */
+
+static bool zSpliceStateStaysAtMin (zPairTrellis *trellis, int state) {
+	zHMM   *hmm = trellis->hmm;
+	score_t floor = MIN_SCORE;
+	int     prev;
+
+	for (prev = 0; prev < hmm->jmap[state]->size; prev++) {
+		if (floor + zGetTransitionScore(hmm, hmm->jmap[state]->elem[prev], state, trellis->tiso_group) > MIN_SCORE) return false;
+	}
+	return true;
+}
+
+static coor_t zGetExplicitReach (zHMM *hmm, int state) {
+	zDistribution *d = &hmm->dmap[hmm->state[state].duration]->duration[0].distribution[0];
+	return zGetGenomicIncrement(hmm, state)*(d->end - d->start + 1); /* see zExplicitPairTrans */
+}
+
+/* Explicit state whose lengths all start in splice states: a row is empty *
+ * without a candidate site in the rows the lengths start on               */
+
+static void zSetSpliceFromSites (zPairSpliceSites *sites, zHMM *hmm, int state, char **site) {
+	coor_t  rows = sites->end - sites->start + 1, i;
+	coor_t  reach = zGetExplicitReach(hmm, state);
+	coor_t  gincrement = zGetGenomicIncrement(hmm, state);
+	coor_t *count = zMalloc((rows + 1)*sizeof(coor_t), "zSetSpliceFromSites count");
+	int     prev;
+
+	/* count[i] sites in rows start .. start+i-1 */
+	count[0] = 0;
+	for (i = 0; i < rows; i++) {
+		bool any = false;
+		for (prev = 0; prev < hmm->jmap[state]->size; prev++) {
+			if (site[hmm->jmap[state]->elem[prev]][i]) any = true;
+		}
+		count[i+1] = count[i] + any;
+	}
+	sites->skip[state] = zMalloc(rows, "zSetSpliceFromSites skip");
+	for (i = 0; i < rows; i++) {
+		/* lengths start on rows i-reach .. i-gincrement; out of the window counts as a site */
+		if (i < reach || gincrement == 0) {
+			sites->skip[state][i] = SPLICE_FILL;
+		} else {
+			sites->skip[state][i] = (count[i - gincrement + 1] == count[i - reach]) ? SPLICE_SKIP : SPLICE_FILL;
+		}
+	}
+	zFree(count);
+}
+
+/* Explicit state that only splice states read: a row nobody reads */
+
+static void zSetSpliceToSites (zPairSpliceSites *sites, zHMM *hmm, int state, char **site, const int *readers, int count) {
+	coor_t  rows = sites->end - sites->start + 1, i, ahead;
+	int     k;
+
+	sites->skip[state] = zMalloc(rows, "zSetSpliceToSites skip");
+	for (i = 0; i < rows; i++) {
+		sites->skip[state][i] = SPLICE_AHEAD;
+		for (k = 0; k < count; k++) {
+			ahead = i + zGetGenomicIncrement(hmm, readers[k]);
+			if (ahead >= rows || site[readers[k]][ahead]) sites->skip[state][i] = SPLICE_FILL;
+		}
+	}
+	for (k = 0; k < count; k++) {
+		sites->reach = MAX(sites->reach, (coor_t)zGetGenomicIncrement(hmm, readers[k]));
+	}
+}
+
+/* zRunPairViterbiAndForward traces back from the rows in front of each *
+ * alignment block but the first, see zQuickTracePartialTrellis          */
+
+static void zKeepSpliceTraceRows (zPairSpliceSites *sites, zPairTrellis *trellis) {
+	coor_t  genomic, first, last;
+	int     state, k;
+
+	for (k = 1; k < trellis->blocks->hsps; k++) {
+		first = MAX(trellis->blocks->hsp[k].g_start - 1, sites->start);
+		last  = MIN(trellis->blocks->hsp[k].g_start + 2*BLOCK_OVERLAP - 1, sites->end);
+		for (state = 0; state < sites->states; state++) {
+			if (sites->skip[state] == NULL) continue;
+			for (genomic = first; genomic <= last; genomic++) {
+				if (sites->skip[state][genomic - sites->start] == SPLICE_AHEAD) sites->skip[state][genomic - sites->start] = SPLICE_FILL;
+			}
+		}
+	}
+}
+
+/* The flags a row at a time, with and without the SPLICE_AHEAD ones. Read *
+ * only from then on, so tile workers may share them (see zPairTile.h)     */
+
+static void zSetSpliceSkipRows (zPairSpliceSites *sites) {
+	coor_t  rows = sites->end - sites->start + 1, i;
+	int     state;
+	char   *now, *later;
+
+	sites->now   = zCalloc(rows*sites->states, sizeof(char), "zSetSpliceSkipRows now");
+	sites->later = zCalloc(rows*sites->states, sizeof(char), "zSetSpliceSkipRows later");
+	for (i = 0; i < rows; i++) {
+		now   = sites->now   + i*sites->states;
+		later = sites->later + i*sites->states;
+		for (state = 0; state < sites->states; state++) {
+			if (sites->skip[state] == NULL) continue;
+			now[state]   = (sites->skip[state][i] == SPLICE_SKIP);
+			later[state] = (sites->skip[state][i] != SPLICE_FILL);
+		}
+	}
+}
+
+/* Flags of the genomic window of trellis for the HMM as it is now, NULL if *
+ * there are no splice sites to go by. The alignment runs from row gmin,   *
+ * where zStartAlignmentForward sets cells without emissions, to row gmax  */
+
+zPairSpliceSites* zInitPairSpliceSites (zPairTrellis *trellis, coor_t gmin, coor_t gmax) {
+	zHMM              *hmm = trellis->hmm;
+	zPairSpliceSites  *sites;
+	zScanner          *scanner;
+	char             **site;
+	int               *readers;
+	int                state, prev, from, count;
+	coor_t             rows, i;
+	bool               any = false, all;
+
+	rows = trellis->window_end - trellis->window_start + 1;
+	site = zCalloc(hmm->states, sizeof(char*), "zInitPairSpliceSites site");
+	for (state = 0; state < hmm->states; state++) {
+		if (!zIsSpliceState(hmm, state) || !zSpliceStateStaysAtMin(trellis, state)) continue;
+		scanner     = trellis->scanner[hmm->state[state].model];
+		site[state] = zMalloc(rows, "zInitPairSpliceSites site");
+		for (i = 0; i < rows; i++) {
+			site[state][i] = (zGetUScore(scanner, trellis->window_start + i) != MIN_SCORE);
+		}
+		if (gmin >= trellis->window_start && gmin <= trellis->window_end) site[state][gmin - trellis->window_start] = 1;
+		any = true;
+	}
+	if (!any) {
+		zFree(site);
+		return NULL;
+	}
+
+	sites        = zMalloc(sizeof(zPairSpliceSites), "zInitPairSpliceSites");
+	sites->start = trellis->window_start;
+	sites->end   = trellis->window_end;
+	sites->states= hmm->states;
+	sites->gmax  = gmax;
+	sites->reach = 0;
+	sites->skip  = zCalloc(hmm->states, sizeof(char*), "zInitPairSpliceSites skip");
+	readers      = zMalloc(hmm->states*sizeof(int), "zInitPairSpliceSites readers");
+
+	for (state = 0; state < hmm->states; state++) {
+		if (site[state] != NULL) {
+			sites->skip[state] = zMalloc(rows, "zInitPairSpliceSites skip");
+			for (i = 0; i < rows; i++) sites->skip[state][i] = site[state][i] ? SPLICE_FILL : SPLICE_SKIP;
+			continue;
+		}
+		if (hmm->state[state].type != EXPLICIT) continue;
+
+		all = (hmm->jmap[state]->size > 0);
+		for (prev = 0; prev < hmm->jmap[state]->size; prev++) {
+			if (site[hmm->jmap[state]->elem[prev]] == NULL) all = false;
+		}
+		if (all) {
+			zSetSpliceFromSites(sites, hmm, state, site);
+			continue;
+		}
+
+		count = 0;
+		all   = true;
+		for (from = 0; from < hmm->states; from++) {
+			for (prev = 0; prev < hmm->jmap[from]->size; prev++) {
+				if (hmm->jmap[from]->elem[prev] != state) continue;
+				if (site[from] == NULL) all = false;
+				readers[count++] = from;
+				break;
+			}
+		}
+		if (all && count > 0) zSetSpliceToSites(sites, hmm, state, site, readers, count);
+	}
+
+	zKeepSpliceTraceRows(sites, trellis);
+	zSetSpliceSkipRows(sites);
+
+	for (state = 0; state < hmm->states; state++) {
+		if (site[state] != NULL) zFree(site[state]);
+	}
+	zFree(site);
+	zFree(readers);
+	return sites;
+}
+
+void zFreePairSpliceSites (zPairSpliceSites *sites) {
+	int state;
+
+	if (sites == NULL) return;
+	for (state = 0; state < sites->states; state++) {
+		if (sites->skip[state] != NULL) zFree(sites->skip[state]);
+	}
+	zFree(sites->skip);
+	zFree(sites->now);
+	zFree(sites->later);
+	zFree(sites);
+}
+
+/* Rows below the one returned may skip SPLICE_AHEAD cells in a fill of the *
+ * rows gstart to gend. The last rows of the fill stay, for the traceback   *
+ * zBandPathOnEdge starts there. 0 for none                                 */
+
+coor_t zGetSpliceAheadEnd (zPairTrellis *trellis, coor_t gstart, coor_t gend) {
+	zPairSpliceSites *sites = trellis->splice_sites;
+
+	if (sites == NULL || sites->reach == 0) return 0;
+	if (gend < gstart + sites->reach) return 0;
+	return MIN(gend - sites->reach + 1, sites->gmax);
+}
+
+/* row[state] is true for the states that stay at MIN_SCORE in row genomic. *
+ * NULL if there is nothing to skip                                         */
+
+const char* zGetSpliceSkipRow (zPairTrellis *trellis, coor_t genomic, coor_t ahead) {
+	zPairSpliceSites *sites = trellis->splice_sites;
+
+	if (sites == NULL || genomic < sites->start || genomic > sites->end) return NULL;
+	return ((genomic < ahead) ? sites->later : sites->now) + (genomic - sites->start)*sites->states;
+}
+
+bool zSkipSpliceCell (zPairTrellis *trellis, int state, coor_t genomic, coor_t ahead) {
+	zPairSpliceSites *sites = trellis->splice_sites;
+	char              skip;
+
+	if (sites == NULL || sites->skip[state] == NULL || genomic < sites->start || genomic > sites->end) return false;
+	skip = sites->skip[state][genomic - sites->start];
+	return (skip == SPLICE_SKIP || (skip == SPLICE_AHEAD && genomic < ahead));
+}
+
+#endif
@@ -0,0 +1,59 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/******************************************************************************\
+zPairSplice.h - part of the ZOE library for genomic analysis
+
+ Splice sites of the genomic window of a trellis, and the intron states they
+ make work for. The donor and acceptor states (zGetU2Donor, zGetU2Acceptor
+ and the U12 ones) only emit at their consensus: a row where the scanner of
+ one scores MIN_SCORE leaves all of its cells at MIN_SCORE. So does a row of
+ an explicit state whose lengths all start on rows like that, and nothing
+ reads the cells of an explicit state that only feeds splice states in rows
+ where those cannot emit. Those cells are left out of the fill; nothing else
+ changes. The intron states themselves keep their per-cell recurrence, with
+ no closed form along the intron, so a long intron still costs its length
+ in every cDNA column, only with fewer states to fill in most of its rows.
+
+	trellis->splice_sites = zInitPairSpliceSites(trellis, gmin, gmax);
+	ahead = zGetSpliceAheadEnd(trellis, gstart, gend);
+	skip  = zGetSpliceSkipRow(trellis, genomic, ahead);
+	if (skip != NULL && skip[state]) ... leave the cell at MIN_SCORE
+
+ Cells skipped for the states they feed are only skipped in rows below
+ ahead (none if it is 0). It keeps the rows the traceback of a block starts
+ on, which zRunPairViterbiAndForward reads before the alignment is done. The
+ forward sums skip them as well: what such a cell adds to the states it feeds
+ is zero, and zRunPairBackward passes nothing on from a cell without a
+ forward value, so the backward sums and posteriors come out the same.
+
+\******************************************************************************/
+
+#ifndef ZOE_PAIR_SPLICE_H
+#define ZOE_PAIR_SPLICE_H
+
+#include "zPairTrellis.h"
+
+struct zPairSpliceSites {
+	coor_t   start;  /* genomic rows of the flags */
+	coor_t   end;
+	int      states;
+	coor_t   gmax;   /* row of the end of the alignment, always filled */
+	coor_t   reach;  /* rows ahead that the states fed by a skipped cell read */
+	char   **skip;   /* skip[state][genomic - start], NULL for states always filled */
+	char    *now;    /* rows of states skipped, see zGetSpliceSkipRow */
+	char    *later;  /* the same, SPLICE_AHEAD included */
+};
+typedef struct zPairSpliceSites zPairSpliceSites;
+
+/* values of skip[state][] */
+#define SPLICE_FILL  0
+#define SPLICE_SKIP  1 /* nothing to fill */
+#define SPLICE_AHEAD 2 /* nothing reads it, in the rows below ahead */
+
+zPairSpliceSites* zInitPairSpliceSites (zPairTrellis*, coor_t, coor_t);
+void              zFreePairSpliceSites (zPairSpliceSites*);
+bool              zIsSplicePrunedState (zHMM*, int);
+coor_t            zGetSpliceAheadEnd (zPairTrellis*, coor_t, coor_t);
+const char*       zGetSpliceSkipRow (zPairTrellis*, coor_t, coor_t);
+bool              zSkipSpliceCell (zPairTrellis*, int, coor_t, coor_t);
+
+#endif
@@ -0,0 +1,202 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/******************************************************************************\
+  zPairTile.c - part of the ZOE library for genomic analysis
+
+  The worker pool of zRunPairTiles. The calling thread is one of the workers,
+  trellis->tile_threads - 1 more are started for the block and joined at the
+  end of it. Tile k is row k/columns, column k%columns of the block.
+
+\******************************************************************************/
+
+#ifndef ZOE_PAIR_TILE_C
+#define ZOE_PAIR_TILE_C
+
+#include "zPairTile.h"
+
+/* Rows and columns any jump reads behind the cell it fills, as zGetPairLookback */
+
+static void zGetPairTileReach (zHMM *hmm, coor_t *rows, coor_t *columns) {
+	int            state;
+	coor_t         steps;
+	zDistribution *d;
+
+	*rows    = 1;
+	*columns = 1;
+	for (state = 0; state < hmm->states; state++) {
+		steps = 1;
+		if (hmm->state[state].type == EXPLICIT) {
+			d     = &hmm->dmap[hmm->state[state].duration]->duration[0].distribution[0];
+			steps = d->end - d->start + 1; /* see zExplicitPairTrans */
+		}
+		*rows    = MAX(*rows, steps*zGetGenomicIncrement(hmm, state));
+		*columns = MAX(*columns, steps*zGetCDnaIncrement(hmm, state));
+	}
+}
+
+/* GENOMIC emissions of rows gstart - reach to gend and DNA ones of columns *
+ * cstart - reach to cend, every position any cell of the block scores      */
+
+static void zScorePairTileEmissions (zPairTiles *tiles, coor_t rows, coor_t columns) {
+	zPairTrellis *trellis = tiles->trellis;
+	zHMM         *hmm = trellis->hmm;
+	zScanner     *scanner;
+	zPairUScores *table;
+	coor_t        pos;
+	int           state, model;
+
+	tiles->uscore = zCalloc(hmm->feature_count, sizeof(zPairUScores), "zScorePairTileEmissions uscore");
+	for (state = 0; state < hmm->states; state++) {
+		model   = hmm->state[state].model;
+		scanner = trellis->scanner[model];
+		table   = &tiles->uscore[model];
+		if (table->score != NULL) continue;
+		if (scanner->model->seq_type == GENOMIC) {
+			table->start = (tiles->gstart > rows) ? tiles->gstart - rows : 0;
+			table->end   = tiles->gend;
+		} else if (scanner->model->seq_type == DNA) {
+			table->start = (tiles->cstart > columns) ? tiles->cstart - columns : 0;
+			table->end   = tiles->cend;
+		} else {
+			continue;
+		}
+		table->score = zMalloc((table->end - table->start + 1)*sizeof(score_t), "zScorePairTileEmissions score");
+		for (pos = table->start; pos <= table->end; pos++) {
+			table->score[pos - table->start] = zGetUScore(scanner, pos);
+		}
+	}
+}
+
+static void zFillPairTile (zPairTiles *tiles, int tile) {
+	coor_t gstart = tiles->gstart + (tile/tiles->columns)*tiles->height;
+	coor_t cstart = tiles->cstart + (tile%tiles->columns)*tiles->width;
+
+	tiles->fill(tiles->trellis, gstart, MIN(gstart + tiles->height - 1, tiles->gend),
+				cstart, MIN(cstart + tiles->width - 1, tiles->cend), tiles->dlo, tiles->dhi);
+}
+
+/* Called with the lock held */
+
+static void zReleasePairTile (zPairTiles *tiles, int tile) {
+	if (--tiles->wait[tile] == 0) tiles->ready[tiles->tail++] = tile;
+}
+
+static void* zPairTileWorker (void *arg) {
+	zPairTiles *tiles = arg;
+	int         tile, total = tiles->rows*tiles->columns;
+
+	pthread_mutex_lock(&tiles->lock);
+	for (;;) {
+		while (tiles->head == tiles->tail && tiles->done < total) {
+			pthread_cond_wait(&tiles->change, &tiles->lock);
+		}
+		if (tiles->head == tiles->tail) break;
+		tile = tiles->ready[tiles->head++];
+		pthread_mutex_unlock(&tiles->lock);
+
+		zFillPairTile(tiles, tile);
+
+		pthread_mutex_lock(&tiles->lock);
+		tiles->done++;
+		if (tile%tiles->columns < tiles->columns - 1) zReleasePairTile(tiles, tile + 1);
+		if (tile/tiles->columns < tiles->rows - 1)    zReleasePairTile(tiles, tile + tiles->columns);
+		pthread_cond_broadcast(&tiles->change);
+	}
+	pthread_mutex_unlock(&tiles->lock);
+	return NULL;
+}
+
+/* Same cells as fill(trellis, gstart, gend, cstart, cend, dlo, dhi) */
+
+void zRunPairTiles (zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi, zPairTileFunc fill) {
+	zPairTiles  tiles;
+	pthread_t  *thread;
+	coor_t      rows, columns;
+	int         k, threads, started;
+
+	if (trellis->tile_threads < 2 || gend < gstart || cend < cstart) {
+		fill(trellis, gstart, gend, cstart, cend, dlo, dhi);
+		return;
+	}
+	zGetPairTileReach(trellis->hmm, &rows, &columns);
+	tiles.height  = MAX(PAIR_TILE_SIZE, rows);
+	tiles.width   = MAX(PAIR_TILE_SIZE, columns);
+	tiles.rows    = (gend - gstart)/tiles.height + 1;
+	tiles.columns = (cend - cstart)/tiles.width + 1;
+	if (tiles.rows < 2 || tiles.columns < 2) {
+		fill(trellis, gstart, gend, cstart, cend, dlo, dhi); /* nothing to run side by side */
+		return;
+	}
+
+	tiles.trellis = trellis;
+	tiles.fill    = fill;
+	tiles.gstart  = gstart;
+	tiles.gend    = gend;
+	tiles.cstart  = cstart;
+	tiles.cend    = cend;
+	tiles.dlo     = dlo;
+	tiles.dhi     = dhi;
+	tiles.wait    = zMalloc(tiles.rows*tiles.columns*sizeof(int), "zRunPairTiles wait");
+	tiles.ready   = zMalloc(tiles.rows*tiles.columns*sizeof(int), "zRunPairTiles ready");
+	for (k = 0; k < tiles.rows*tiles.columns; k++) {
+		tiles.wait[k] = (k/tiles.columns > 0) + (k%tiles.columns > 0);
+	}
+	tiles.ready[0] = 0;
+	tiles.head     = 0;
+	tiles.tail     = 1;
+	tiles.done     = 0;
+	zScorePairTileEmissions(&tiles, rows, columns);
+	pthread_mutex_init(&tiles.lock, NULL);
+	pthread_mutex_init(&tiles.emission, NULL);
+	pthread_cond_init(&tiles.change, NULL);
+
+	/* never more threads than tiles on an anti-diagonal */
+	threads = MIN(trellis->tile_threads, MIN(tiles.rows, tiles.columns));
+	thread  = zMalloc(threads*sizeof(pthread_t), "zRunPairTiles thread");
+	zTrace2("tiles: %d x %d of %u x %u cells, %d threads", tiles.rows, tiles.columns, tiles.height, tiles.width, threads);
+
+	trellis->tiles = &tiles;
+	zShareMemoryCounts(true);
+	for (started = 1; started < threads; started++) {
+		if (pthread_create(&thread[started], NULL, zPairTileWorker, &tiles) != 0) break;
+	}
+	zPairTileWorker(&tiles);
+	for (k = 1; k < started; k++) pthread_join(thread[k], NULL);
+	zShareMemoryCounts(false);
+	trellis->tiles = NULL;
+
+	pthread_cond_destroy(&tiles.change);
+	pthread_mutex_destroy(&tiles.emission);
+	pthread_mutex_destroy(&tiles.lock);
+	for (k = 0; k < trellis->hmm->feature_count; k++) {
+		if (tiles.uscore[k].score != NULL) zFree(tiles.uscore[k].score);
+	}
+	zFree(tiles.uscore);
+	zFree(tiles.wait);
+	zFree(tiles.ready);
+	zFree(thread);
+}
+
+/* zGetUScore(scanner, pos) for the model of state, safe in a tile worker */
+
+score_t zGetPairUScore (zPairTrellis *trellis, zScanner *scanner, int state, coor_t pos) {
+	zPairUScores *table;
+	score_t       score;
+
+	if (trellis->tiles == NULL) return zGetUScore(scanner, pos);
+	table = &trellis->tiles->uscore[trellis->hmm->state[state].model];
+	if (table->score != NULL && pos >= table->start && pos <= table->end) return table->score[pos - table->start];
+	zLockPairEmission(trellis);
+	score = zGetUScore(scanner, pos);
+	zUnlockPairEmission(trellis);
+	return score;
+}
+
+void zLockPairEmission (zPairTrellis *trellis) {
+	if (trellis->tiles != NULL) pthread_mutex_lock(&trellis->tiles->emission);
+}
+
+void zUnlockPairEmission (zPairTrellis *trellis) {
+	if (trellis->tiles != NULL) pthread_mutex_unlock(&trellis->tiles->emission);
+}
+
+#endif
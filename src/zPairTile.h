@@ -0,0 +1,68 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/******************************************************************************\
+zPairTile.h - part of the ZOE library for genomic analysis
+
+ Fills one block of a pair trellis on several threads. The block is cut into
+ tiles of at least PAIR_TILE_SIZE x PAIR_TILE_SIZE cells, and no smaller than
+ the rows and columns a jump reaches back (the lengths of explicit states
+ included, see zGetPairLookback). A tile then only reads cells of itself and
+ of the tiles above, to the left and above left of it, so it is ready as soon
+ as the one above and the one to its left are done. Workers take ready tiles
+ and fill each one with the same code as a serial fill of the block:
+
+	zRunPairTiles(trellis, gstart, gend, cstart, cend, dlo, dhi, fill);
+
+ Every cell still sees its jumps in hmm->jmap order and reads the final
+ scores of the cells before it, so scores, traceback and forward sums are
+ the ones of the serial fill. The scanners are not thread safe: the GENOMIC
+ and DNA emissions the block needs are scored up front (zGetPairUScore reads
+ them) and whatever else goes to a scanner takes the emission lock.
+
+\******************************************************************************/
+
+#ifndef ZOE_PAIR_TILE_H
+#define ZOE_PAIR_TILE_H
+
+#include <pthread.h>
+#include "zPairTrellis.h"
+
+#define PAIR_TILE_SIZE 64 /* rows and columns of a tile, at least */
+
+typedef void (*zPairTileFunc)(zPairTrellis*, coor_t, coor_t, coor_t, coor_t, long, long);
+
+/* Emissions of one model from start to end, NULL for a model not scored up front */
+
+struct zPairUScores {
+	coor_t   start;
+	coor_t   end;
+	score_t *score;
+};
+typedef struct zPairUScores zPairUScores;
+
+struct zPairTiles {
+	zPairTrellis     *trellis;
+	zPairTileFunc     fill;
+	coor_t            gstart, gend, cstart, cend;
+	long              dlo, dhi;
+	coor_t            height;    /* rows of a tile */
+	coor_t            width;     /* columns of a tile */
+	int               rows;      /* tiles down the block */
+	int               columns;   /* tiles across it */
+	int              *wait;      /* tiles above and to the left not done yet */
+	int              *ready;     /* tiles to fill, from head to tail */
+	int               head;
+	int               tail;
+	int               done;
+	zPairUScores     *uscore;    /* indexed by model */
+	pthread_mutex_t   lock;      /* for all of the above */
+	pthread_cond_t    change;    /* a tile is ready or the last one is done */
+	pthread_mutex_t   emission;  /* for scanners */
+};
+typedef struct zPairTiles zPairTiles;
+
+void    zRunPairTiles (zPairTrellis*, coor_t, coor_t, coor_t, coor_t, long, long, zPairTileFunc);
+score_t zGetPairUScore (zPairTrellis*, zScanner*, int, coor_t);
+void    zLockPairEmission (zPairTrellis*);
+void    zUnlockPairEmission (zPairTrellis*);
+
+#endif
@@ -11,6 +11,7 @@
 
 #include "zTransition.h"
 #include "zPairTrellis.h"
+#include "zPairTile.h"
 #include "zFeatureFactory.h" /* for PSC definition */
 
 /******************************************************************************\
@@ -23,12 +24,12 @@ score_t zGetScannerScore (zPairTrellis *trellis, zScanner *scanner, int state, c
 /* The order here is GENOMIC, DNA, PAIR since the number of corresponding states are descending in that order */
 /* Calling zGetUScore since it has been precomputed */
  	if (scanner->model->seq_type == GENOMIC) {
-	 	total_score = zGetUScore(scanner, genomic);
+	 	total_score = zGetPairUScore(trellis, scanner, state, genomic);
 	} else if (scanner->model->seq_type == DNA) {
-	 	total_score = zGetUScore(scanner, cdna);
+	 	total_score = zGetPairUScore(trellis, scanner, state, cdna);
 	} else if (scanner->model->seq_type == PAIR) {
 		if (scanner->pairscore != NULL) {
-			total_score = scanner->pairscore(scanner, trellis->genomic, trellis->cdna, genomic, cdna);
+			total_score = zGetPairEmission(trellis, scanner, genomic, cdna);
 		} else {
 			zDie("PairHMM scoring function absent in scanner: %s", zStrIdx2Char(trellis->hmm->state[state].model));
 		}
@@ -36,6 +37,48 @@ score_t zGetScannerScore (zPairTrellis *trellis, zScanner *scanner, int state, c
 	return total_score;
 }
 
+/* Same score as scanner->pairscore for a PAIR LUT model, read from the s5 codes *
+ * zInitPairTrellis keeps instead of the sequence blocks. A length 2 model is a  *
+ * plain symbols x symbols table. Positions outside of gcode go to pairscore     */
+
+score_t zGetPairEmission (zPairTrellis *trellis, zScanner *scanner, coor_t genomic, coor_t cdna) {
+	zModel *model = scanner->model;
+	coor_t  i, index, length, gfocus, cfocus;
+	score_t score;
+
+	if (trellis->gcode == NULL || model->type != LUT
+		|| genomic < trellis->gcode_start + model->focus + model->length/2
+		|| genomic > trellis->gcode_end   + model->focus
+		|| cdna >= trellis->cdna->length  + model->focus) {
+		zLockPairEmission(trellis);
+		score = scanner->pairscore(scanner, trellis->genomic, trellis->cdna, genomic, cdna);
+		zUnlockPairEmission(trellis);
+		return score;
+	}
+
+	/* user defines and boundaries, as in zDNAScorePairLUT */
+	if ((genomic < scanner->min_gpos) || (genomic > scanner->max_pos) ||
+		(cdna < scanner->min_pos) || (cdna > scanner->max_pos))
+		return MIN_SCORE;
+
+	gfocus = genomic - model->focus - trellis->gcode_start;
+	cfocus = cdna    - model->focus;
+	if (model->length == 2) {
+		return model->data[model->symbols*trellis->gcode[gfocus] + trellis->ccode[cfocus]];
+	}
+
+	length = model->length / 2;
+	index  = 0;
+	for (i = 0; i < length; i++) {
+		index += zPOWER[model->symbols][i] * trellis->gcode[gfocus - i];
+	}
+	index *= zPOWER[model->symbols][length];
+	for (i = 0; i < length; i++) {
+		index += zPOWER[model->symbols][i] * trellis->ccode[cfocus - i];
+	}
+	return model->data[index];
+}
+
 /*****************************************************************************************
  * The GHMM version of this function (zScoreInternalState) takes in a bool first_base    *
  * argument to add the exit probability for this state if it is the first base of this   *
@@ -72,20 +115,18 @@ void zInternalPairTransHelper (zPairTrellis *trellis, int from_state, int to_sta
 
 	if (total_score == MIN_SCORE) return;
 
-#ifdef FORWARD
 	if (trellis->forward != NULL) {
 		trellis->forward[genomic][cdna][to_state] = 
-			zFloatwiseScoreAdd(total_score + trellis->forward[genomic-zGetGenomicIncrement(trellis->hmm, to_state)][cdna-zGetCDnaIncrement(trellis->hmm, to_state)][from_state], 
-								trellis->forward[genomic][cdna][to_state]);
+			zLogAddScore(total_score + trellis->forward[genomic-zGetGenomicIncrement(trellis->hmm, to_state)][cdna-zGetCDnaIncrement(trellis->hmm, to_state)][from_state], 
+						  trellis->forward[genomic][cdna][to_state]);
 	}
-#endif
 	
 	cell      = zGetCurrentCell(trellis, genomic, cdna, to_state);
 	prev_cell = zGetPreviousCell(trellis, genomic, cdna, to_state, from_state);
 
 	cell_score = total_score + prev_cell->score;
 	if (cell_score > cell->score) {
-		cell->score = cell_score;
+		zSetCellScore(trellis, cell, cell_score);
 		if (from_state == to_state) {
 			cell->length = prev_cell->length + 1;
 			cell->trace = prev_cell->trace;
@@ -101,10 +142,14 @@ static void zInternalPairTrans (zPairTrellis *trellis, int from_state, int to_st
 	zInternalPairTransHelper(trellis, from_state, to_state, genomic, cdna, zGetTransitionScore(trellis->hmm,from_state,to_state,trellis->tiso_group));
 }
 
+/* The backward sums run the forward recurrence the other way round: the jump   *
+ * from_state -> to_state that ends in (genomic, cdna) passes the backward score *
+ * of that cell on to the cell it was taken from                                 */
+
 static void zInternalPairTransBack (zPairTrellis *trellis, int from_state, int to_state, coor_t genomic, coor_t cdna) {
 	score_t    total_score;
-	int        gincrement = zGetGenomicIncrement(trellis->hmm, to_state);
-	int        cincrement = zGetCDnaIncrement(trellis->hmm, to_state);
+	coor_t     gfrom = genomic - zGetGenomicIncrement(trellis->hmm, to_state);
+	coor_t     cfrom = cdna    - zGetCDnaIncrement(trellis->hmm, to_state);
 
 	if (EXTERNAL == trellis->hmm->state[from_state].type) {
 		zPhase_t int_phase, ext_phase;
@@ -117,16 +162,66 @@ static void zInternalPairTransBack (zPairTrellis *trellis, int from_state, int t
 	total_score += zGetTransitionScore(trellis->hmm, from_state, to_state, trellis->tiso_group);
 	if (total_score == MIN_SCORE) return;
 	
-	trellis->backward[genomic][cdna][from_state] = 
-		  zFloatwiseScoreAdd(total_score + trellis->backward[genomic+gincrement][cdna+cincrement][to_state],
-							trellis->backward[genomic][cdna][from_state]);
+	trellis->backward[gfrom][cfrom][from_state] = 
+		  zLogAddScore(total_score + trellis->backward[genomic][cdna][to_state],
+					   trellis->backward[gfrom][cfrom][from_state]);
 	return;
 }
 
+/* zInternalPairTransBack for the cells cstart..cend of row genomic at once. Only *
+ * for a to_state that moves along the genomic, so that every cell passes its    *
+ * score on to an earlier row. Cells the forward pass did not reach in to_state  *
+ * pass nothing on. sum and add are scratch, one score per cell                  */
+
+void zInternalPairTransBackRow (zPairTrellis *trellis, int from_state, int to_state, coor_t genomic, coor_t cstart, coor_t cend, score_t *sum, score_t *add) {
+	zHMM      *hmm = trellis->hmm;
+	zScanner  *scanner = trellis->scanner[hmm->state[to_state].model];
+	coor_t     gfrom = genomic - zGetGenomicIncrement(hmm, to_state);
+	int        cincrement = zGetCDnaIncrement(hmm, to_state);
+	int        n = cend - cstart + 1, k;
+	score_t    trans, total_score;
+	coor_t     cdna;
+
+	if (EXTERNAL == hmm->state[from_state].type) {
+		if (hmm->state[to_state].phase != hmm->state[from_state].phase) return;
+	}
+	trans = zGetTransitionScore(hmm, from_state, to_state, trellis->tiso_group);
+
+	for (k = 0; k < n; k++) {
+		cdna   = cstart + k;
+		sum[k] = trellis->backward[gfrom][cdna-cincrement][from_state];
+		add[k] = MIN_SCORE;
+		if (trellis->forward[genomic][cdna][to_state] == MIN_SCORE) continue;
+		total_score = zGetScannerScore(trellis, scanner, to_state, genomic, cdna);
+		total_score += trans;
+		if (total_score == MIN_SCORE) continue;
+		add[k] = total_score + trellis->backward[genomic][cdna][to_state];
+	}
+	zLogAddScores(sum, add, n);
+	for (k = 0; k < n; k++) {
+		trellis->backward[gfrom][cstart+k-cincrement][from_state] = sum[k];
+	}
+}
+
+/* Lengths of an explicit state that may end in (genomic, cdna) */
+
+static coor_t zGetExplicitSteps (zPairTrellis *trellis, zDistribution *d, int gincrement, int cincrement, coor_t genomic, coor_t cdna) {
+	coor_t steps = d->end - d->start + 1;
+
+	if ((int)(genomic - steps*gincrement) < (int)trellis->blocks->gb_start - 1) {
+		steps = (genomic - trellis->blocks->gb_start + 1)/gincrement;
+	}
+	if ((int)(cdna - steps*cincrement) < PADDING - 1) {
+		steps = (cdna - PADDING + 1)/cincrement;
+	}
+	return steps;
+}
+
 /* Assumption: genomic sequence moves in this state: increments for genomic > 0 */
 void zExplicitPairTrans (zPairTrellis *trellis, int from_state, int state, coor_t genomic, coor_t cdna) {
 	zStrIdx    name;
-	score_t    tscore, scan_score, total_score, best_score;
+	score_t    tscore, dscore, scan_score, total_score, best_score;
+	score_t    fscore = MIN_SCORE; /* forward sum over the lengths */
 	coor_t     best_length = 0, length;
 	zPairTrellisCell *cell; 
 	zScanner *scanner;
@@ -151,14 +246,8 @@ void zExplicitPairTrans (zPairTrellis *trellis, int from_state, int state, coor_
 	d = &group->duration[0].distribution[0];
 
 	/* Set min and max start coordinates for the range */
-	steps = d->end - d->start + 1;
-	if ((int)(genomic - steps*gincrement) < (int)trellis->blocks->gb_start - 1) {
-		steps = (genomic - trellis->blocks->gb_start + 1)/gincrement;
-	}
-	if ((int)(cdna - steps*cincrement) < PADDING - 1) {
-		steps = (cdna - PADDING + 1)/cincrement;
-	}
-	
+	steps = zGetExplicitSteps(trellis, d, gincrement, cincrement, genomic, cdna);
+
 	name      = trellis->hmm->state[state].model;
 	scanner   = trellis->scanner[name];
                         
@@ -172,8 +261,9 @@ void zExplicitPairTrans (zPairTrellis *trellis, int from_state, int state, coor_
 
 		coor_t i, j;
 
+		dscore = zScoreDistribution(d, length);
 		total_score = tscore
-				+ zScoreDistribution(d, length)
+				+ dscore
 				+ zGetCurrentCell(trellis, gmin, cmin, from_state)->score;
 			
 		for (i = gmin+1, j = cmin+1; i <= gmax; i+=gincrement, j+=cincrement) {
@@ -185,17 +275,104 @@ void zExplicitPairTrans (zPairTrellis *trellis, int from_state, int state, coor_
 			best_score = total_score;
 			best_length = length;
 		}
-	  
+
+		if (trellis->forward != NULL) {
+			fscore = zLogAddScore(tscore + dscore + trellis->forward[gmin][cmin][from_state] + scan_score, fscore);
+		}
+	}
+
+	if (trellis->forward != NULL) {
+		trellis->forward[genomic][cdna][state] = zLogAddScore(fscore, trellis->forward[genomic][cdna][state]);
 	}
                
 	cell = zGetCurrentCell(trellis, genomic, cdna, state);
 	if (best_score > cell->score) {
-		cell->score = best_score;
+		zSetCellScore(trellis, cell, best_score);
 		cell->length = best_length;
 		cell->trace = from_state;
 	}
 }
 
+/* Backward counterpart of zExplicitPairTrans: every length that may end in *
+ * (genomic, cdna) passes the backward score of the cell on to its start    */
+
+static void zExplicitPairTransBack (zPairTrellis *trellis, int from_state, int state, coor_t genomic, coor_t cdna) {
+	score_t         tscore, scan_score, bscore;
+	coor_t          length, steps, gmin, gmax, cmin, cmax, i, j;
+	zScanner       *scanner;
+	zDistribution  *d;
+	int             gincrement, cincrement;
+
+	if (EXTERNAL == trellis->hmm->state[from_state].type) {
+		if (trellis->hmm->state[state].phase != trellis->hmm->state[from_state].phase) return;
+	}
+
+	gincrement = zGetGenomicIncrement(trellis->hmm, state);
+	cincrement = zGetCDnaIncrement(trellis->hmm, state);
+	d          = &trellis->hmm->dmap[trellis->hmm->state[state].duration]->duration[0].distribution[0];
+	steps      = zGetExplicitSteps(trellis, d, gincrement, cincrement, genomic, cdna);
+	scanner    = trellis->scanner[trellis->hmm->state[state].model];
+	tscore     = zGetTransitionScore(trellis->hmm, from_state, state, trellis->tiso_group);
+	bscore     = trellis->backward[genomic][cdna][state];
+	scan_score = 0.;
+	if (bscore == MIN_SCORE) return;
+
+	for (length = 1, gmax = genomic, cmax = cdna, gmin = gmax - gincrement, cmin = cmax - cincrement;
+	     length <= steps;
+	     length++, gmax = gmin, cmax = cmin, gmin = gmax - gincrement, cmin = cmax - cincrement) {
+		for (i = gmin+1, j = cmin+1; i <= gmax; i+=gincrement, j+=cincrement) {
+			scan_score += zGetScannerScore(trellis, scanner, state, i, j);
+		}
+		trellis->backward[gmin][cmin][from_state] =
+			zLogAddScore(tscore + zScoreDistribution(d, length) + scan_score + bscore,
+						 trellis->backward[gmin][cmin][from_state]);
+	}
+}
+
+/* zExplicitPairTransBack for the cells cstart..cend of row genomic at once. Only *
+ * for a state that moves along the genomic alone and scores the genomic, so     *
+ * that a length passes on the same score from every cell of the row. span is    *
+ * scratch, one score per length                                                 */
+
+void zExplicitPairTransBackRow (zPairTrellis *trellis, int from_state, int state, coor_t genomic, coor_t cstart, coor_t cend, score_t *span) {
+	zHMM           *hmm = trellis->hmm;
+	score_t         tscore, scan_score, bscore;
+	coor_t          length, steps, gmin, gmax, cdna, i;
+	zScanner       *scanner;
+	zDistribution  *d;
+	int             gincrement;
+
+	if (EXTERNAL == hmm->state[from_state].type) {
+		if (hmm->state[state].phase != hmm->state[from_state].phase) return;
+	}
+
+	gincrement = zGetGenomicIncrement(hmm, state);
+	d          = &hmm->dmap[hmm->state[state].duration]->duration[0].distribution[0];
+	steps      = zGetExplicitSteps(trellis, d, gincrement, 0, genomic, cstart);
+	scanner    = trellis->scanner[hmm->state[state].model];
+	tscore     = zGetTransitionScore(hmm, from_state, state, trellis->tiso_group);
+	scan_score = 0.;
+
+	for (length = 1, gmax = genomic, gmin = gmax - gincrement;
+	     length <= steps;
+	     length++, gmax = gmin, gmin = gmax - gincrement) {
+		for (i = gmin+1; i <= gmax; i+=gincrement) {
+			scan_score += zGetScannerScore(trellis, scanner, state, i, cstart);
+		}
+		span[length-1] = tscore + zScoreDistribution(d, length) + scan_score;
+	}
+
+	for (cdna = cstart; cdna <= cend; cdna++) {
+		if (trellis->forward[genomic][cdna][state] == MIN_SCORE) continue;
+		bscore = trellis->backward[genomic][cdna][state];
+		if (bscore == MIN_SCORE) continue;
+		for (length = 1, gmin = genomic - gincrement; length <= steps; length++, gmin -= gincrement) {
+			trellis->backward[gmin][cdna][from_state] =
+				zLogAddScore(span[length-1] + bscore, trellis->backward[gmin][cdna][from_state]);
+		}
+	}
+}
+
 #define STATE_TYPES 4
 static zPairTransFunc zPairTransLookup[STATE_TYPES] = {
 	zInternalPairTrans, /* INTERNAL */
@@ -213,11 +390,13 @@ zPairTransFunc zGetPairTransFunc(int type) {
 	return zPairTransLookup[type]; 
 }
 
+/* Looked up by the type of the state a jump goes to, as zPairTransLookup */
+
 static zPairTransFunc zPairBackTransLookup[STATE_TYPES] = {
 	zInternalPairTransBack, /* INTERNAL */
-	zInternalPairTransBack, /* INTERNAL */
-	zInternalPairTransBack, /* INTERNAL */
-	zExplicitPairTrans
+	zInternalPairTransBack, /* GINTERNAL */
+	zInternalPairTransBack, /* EXTERNAL */
+	zExplicitPairTransBack  /* EXPLICIT */
 };
 
 zPairTransFunc zGetPairBackTransFunc(int type) {
@@ -28,8 +28,12 @@ int zCompatibleJumpFromExon (zDNA *dna, zPhase_t phase, zSfeature *exon);
 int zCompatibleJumpToExon (zDNA *dna, zPhase_t phase, zSfeature *exon);
 
 score_t zGetScannerScore(struct zPairTrellis *trellis, struct zScanner *scanner, int state, coor_t genomic, coor_t cdna);
+score_t zGetPairEmission(struct zPairTrellis *trellis, struct zScanner *scanner, coor_t genomic, coor_t cdna);
 
 void zInternalPairTransHelper (struct zPairTrellis *trellis, int from_state, int to_state, coor_t genomic, coor_t cdna, score_t trans);
+void zExplicitPairTrans (struct zPairTrellis *trellis, int from_state, int state, coor_t genomic, coor_t cdna);
+void zInternalPairTransBackRow (struct zPairTrellis *trellis, int from_state, int to_state, coor_t genomic, coor_t cstart, coor_t cend, score_t *sum, score_t *add);
+void zExplicitPairTransBackRow (struct zPairTrellis *trellis, int from_state, int state, coor_t genomic, coor_t cstart, coor_t cend, score_t *span);
 #endif
 
 
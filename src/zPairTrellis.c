@@ -15,6 +15,10 @@
 #include <sys/stat.h>
 
 #include "zPairTrellis.h"
+#include "zPairWavefront.h"
+#include "zPairKernel.h"
+#include "zPairSplice.h"
+#include "zPairTile.h"
 #include "zHardCoding.h"
 
 static const score_t MIN_INIT_SCORE = -10000;
@@ -23,6 +27,13 @@ extern coor_t any_new_cpoint;
 void zShowPairTrellisCell(zPairTrellis *trellis, coor_t i, coor_t j, int k); 
 static void zQuickTracePartialTrellis(zPairTrellis *trellis, coor_t g_begin, coor_t g_end, coor_t c_begin, coor_t c_end); 
 static void zTracePartialPairTrellis(zPairTrellis *trellis, coor_t g_begin, coor_t g_end, coor_t c_begin, coor_t c_end, int state, zAFVec *afv); 
+static void zTakePairPathPosteriors(zPairTrellis *trellis, zAFVec *path, coor_t genomic, score_t *exit);
+static void zInitSparseCells(zPairTrellis *trellis, bool posteriors);
+static void zCollectSparseRow(zPairTrellis *trellis, coor_t genomic, coor_t *lo, coor_t *hi);
+static void zFinishSparseCells(zPairSparseCells *sparse);
+static int  zPushSparseForward(zPairSparseCells *sparse, const score_t *forward, int states);
+static void zFreeSparseCells(zPairTrellis *trellis);
+static coor_t zGetPairLookback(zHMM *hmm);
 
 /*********************************************\
  Regular Viterbi Variables
@@ -39,9 +50,7 @@ static void zAllocPartialViterbiVars(zPairTrellis *trellis, coor_t genomic_start
 		trellis->cell[i] -= cdna_start;
 		for (j = cdna_start; j <= cdna_end; j++) {
 			int k;
-			char strtemp[64];
-			sprintf(strtemp, "zAllocViterbi cells[%u][%u]", i, j);
-			trellis->cell[i][j] = (zPairTrellisCell*) zSliceAlloc(cell_size, strtemp);
+			trellis->cell[i][j] = (zPairTrellisCell*) zSliceAlloc(cell_size, "zAllocViterbi cells[i][j]");
 			for (k = 0; k < trellis->hmm->states; k++) {
 				trellis->cell[i][j][k].length = -1;
 				trellis->cell[i][j][k].trace  = -1;
@@ -80,9 +89,7 @@ static void zAllocPartialVars(zPairTrellis* trellis, score_t ***vars, coor_t gen
 		vars[i] -= cdna_start;
 		for (j = cdna_start; j <= cdna_end; j++) {
 			int k;
-			char strtemp[64];
-			sprintf(strtemp, "zAllocViterbi cells[%u][%u]", i, j);
-			vars[i][j] = (score_t*) zSliceAlloc(cell_size, strtemp);
+			vars[i][j] = (score_t*) zSliceAlloc(cell_size, "zAllocViterbi vars[i][j]");
 			for (k = 0; k < trellis->hmm->states; k++) {
 				vars[i][j][k]     = MIN_SCORE;
 			}
@@ -97,14 +104,157 @@ static void zFreePartialVars(zPairTrellis *trellis, score_t ***vars, coor_t geno
 	size_t row_size = length*sizeof(score_t*);
 
 	for (i = genomic_start; i <= genomic_end; i++) {
+		if (vars[i] == NULL) continue; /* never allocated, or released already */
 		vars[i] += cdna_start;
-		if (vars[i] != NULL) {
-			for (j = 0; j < length; j++) {
-				zSliceFree(cell_size, vars[i][j]);
-			}
-			zSliceFree(row_size, vars[i]);
+		for (j = 0; j < length; j++) {
+			zSliceFree(cell_size, vars[i][j]);
+		}
+		zSliceFree(row_size, vars[i]);
+		vars[i] = NULL;
+	}
+}
+
+/*********************************************\
+ Arena backed Viterbi Variables
+\*********************************************/
+
+static void zAllocPartialViterbiArena(zPairTrellis *trellis, zPairTrellisArena *arena, coor_t genomic_start, coor_t genomic_end, coor_t cdna_start, coor_t cdna_end) {
+	coor_t            i, j;
+	size_t            k;
+	size_t            width  = cdna_end - cdna_start + 1;
+	size_t            count  = (genomic_end - genomic_start + 1)*width;
+	int               states = trellis->hmm->states;
+	zPairTrellisCell **rows;
+	zPairTrellisCell  *data;
+
+	rows = (zPairTrellisCell**) zMalloc(count*sizeof(zPairTrellisCell*), "zAllocPartialViterbiArena rows");
+	data = (zPairTrellisCell*)  zMalloc(count*states*sizeof(zPairTrellisCell), "zAllocPartialViterbiArena data");
+	for (k = 0; k < count*states; k++) {
+		data[k].length = -1;
+		data[k].trace  = -1;
+		data[k].keep   = 0;
+		data[k].score  = MIN_SCORE;
+	}
+	for (i = genomic_start; i <= genomic_end; i++) {
+		zPairTrellisCell **row = rows + (i - genomic_start)*width;
+		for (j = 0; j < width; j++) {
+			row[j] = data + ((i - genomic_start)*width + j)*states;
+		}
+		trellis->cell[i] = row - cdna_start;
+	}
+	arena->rows = rows;
+	arena->data = data;
+}
+
+static void zFreePartialViterbiArena(zPairTrellis *trellis, zPairTrellisArena *arena, coor_t genomic_start, coor_t genomic_end, coor_t cdna_start, coor_t cdna_end) {
+	size_t            k;
+	size_t            count = (size_t)(genomic_end - genomic_start + 1)*(cdna_end - cdna_start + 1);
+	zPairTrellisCell **rows = (zPairTrellisCell**) arena->rows;
+
+	if (rows == NULL) return;
+	if (arena->data == NULL) { /* Garbage collected: only the kept cells are left */
+		for (k = 0; k < count; k++) {
+			zSliceFree(sizeof(zPairTrellisCell)*trellis->hmm->states, rows[k]);
+		}
+	}
+	zFree(arena->data);
+	zFree(arena->rows);
+	arena->data = NULL;
+	arena->rows = NULL;
+}
+
+static void zAllocPartialArena(zPairTrellis *trellis, zPairTrellisArena *arena, score_t ***vars, coor_t genomic_start, coor_t genomic_end, coor_t cdna_start, coor_t cdna_end) {
+	coor_t    i, j;
+	size_t    k;
+	size_t    width  = cdna_end - cdna_start + 1;
+	size_t    count  = (genomic_end - genomic_start + 1)*width;
+	int       states = trellis->hmm->states;
+	score_t **rows;
+	score_t  *data;
+
+	rows = (score_t**) zMalloc(count*sizeof(score_t*), "zAllocPartialArena rows");
+	data = (score_t*)  zMalloc(count*states*sizeof(score_t), "zAllocPartialArena data");
+	for (k = 0; k < count*states; k++) {
+		data[k] = MIN_SCORE;
+	}
+	for (i = genomic_start; i <= genomic_end; i++) {
+		score_t **row = rows + (i - genomic_start)*width;
+		for (j = 0; j < width; j++) {
+			row[j] = data + ((i - genomic_start)*width + j)*states;
+		}
+		vars[i] = row - cdna_start;
+	}
+	arena->rows = rows;
+	arena->data = data;
+}
+
+static void zFreePartialArena(zPairTrellis *trellis, zPairTrellisArena *arena, coor_t genomic_start, coor_t genomic_end, coor_t cdna_start, coor_t cdna_end) {
+	size_t    k;
+	size_t    count = (size_t)(genomic_end - genomic_start + 1)*(cdna_end - cdna_start + 1);
+	score_t **rows  = (score_t**) arena->rows;
+
+	if (rows == NULL) return;
+	if (arena->data == NULL) { /* Garbage collected: only the kept cells are left */
+		for (k = 0; k < count; k++) {
+			zSliceFree(sizeof(score_t)*trellis->hmm->states, rows[k]);
+		}
+	}
+	zFree(arena->data);
+	zFree(arena->rows);
+	arena->data = NULL;
+	arena->rows = NULL;
+}
+
+/*********************************************\
+ Checkpointed Viterbi Variables
+\*********************************************/
+
+/* Rows of the single memory block, one allocation per row */
+
+static void zAllocCheckpointRows(zPairTrellis *trellis, coor_t genomic_start, coor_t genomic_end) {
+	coor_t             i, j;
+	size_t             k;
+	zHSP              *r      = &trellis->mem_blocks->hsp[0];
+	size_t             width  = r->c_end - r->c_start + 1;
+	int                states = trellis->hmm->states;
+	zPairTrellisCell **row;
+	zPairTrellisCell  *data;
+
+	for (i = genomic_start; i <= genomic_end; i++) {
+		if (trellis->cell[i] != NULL) continue; /* a checkpoint row */
+		row  = (zPairTrellisCell**) zMalloc(width*(sizeof(zPairTrellisCell*) + states*sizeof(zPairTrellisCell)), "zAllocCheckpointRows row");
+		data = (zPairTrellisCell*) (row + width);
+		for (k = 0; k < width*states; k++) {
+			data[k].length = -1;
+			data[k].trace  = -1;
+			data[k].keep   = 0;
+			data[k].score  = MIN_SCORE;
 		}
+		for (j = 0; j < width; j++) {
+			row[j] = data + j*states;
+		}
+		trellis->cell[i] = row - r->c_start;
+	}
+}
+
+static void zFreeCheckpointRows(zPairTrellis *trellis, coor_t genomic_start, coor_t genomic_end) {
+	coor_t i;
+
+	for (i = genomic_start; i <= genomic_end; i++) {
+		if (trellis->cell[i] == NULL) continue;
+		zFree(trellis->cell[i] + trellis->mem_blocks->hsp[0].c_start);
+		trellis->cell[i] = NULL;
+	}
+}
+
+static zPairTrellisArena* zAllocArenaVec(zPairTrellis *trellis, const char *msg) {
+	int                k;
+	zPairTrellisArena *arena = zMalloc(trellis->mem_blocks->hsps*sizeof(zPairTrellisArena), msg);
+	for (k = 0; k < trellis->mem_blocks->hsps; k++) {
+		arena[k].rows = NULL;
+		arena[k].data = NULL;
 	}
+	return arena;
 }
 
 static void zAllocViterbiVars(zPairTrellis *trellis) {
@@ -113,7 +263,9 @@ static void zAllocViterbiVars(zPairTrellis *trellis) {
 
 	zTrace2("initializing Viterbi vars");
 
-	trellis->cell = zCalloc(trellis->genomic->length, sizeof(zPairTrellisCell**), "zAllocViterbi cell");
+	trellis->cell = zCalloc(trellis->window_end - trellis->window_start + 1, sizeof(zPairTrellisCell**), "zAllocViterbi cell");
+	trellis->cell -= trellis->window_start;
+	if (trellis->arena) trellis->cell_arena = zAllocArenaVec(trellis, "zAllocViterbi cell_arena");
 
 	/* Allocating backward link arrays for all states                 */
 	/* But only those referring to external states will be used later */
@@ -127,13 +279,17 @@ static void zAllocViterbiVars(zPairTrellis *trellis) {
 static void zAllocForwardVars(zPairTrellis *trellis) {
 	zTrace2("initializing forward vars");
 	if (NULL != trellis->forward) return;
-	trellis->forward = zCalloc(trellis->genomic->length, sizeof(score_t**), "zAllocForwardVars forward");
+	trellis->forward = zCalloc(trellis->window_end - trellis->window_start + 1, sizeof(score_t**), "zAllocForwardVars forward");
+	trellis->forward -= trellis->window_start;
+	if (trellis->arena) trellis->fwd_arena = zAllocArenaVec(trellis, "zAllocForwardVars fwd_arena");
 }
 
 static void zAllocBackwardVars(zPairTrellis *trellis) {
 	zTrace2("initializing backward vars");
 	if (NULL != trellis->backward) return;
-	trellis->backward = zCalloc(trellis->genomic->length, sizeof(score_t**), "zAllocBackwardVars backward");
+	trellis->backward = zCalloc(trellis->window_end - trellis->window_start + 1, sizeof(score_t**), "zAllocBackwardVars backward");
+	trellis->backward -= trellis->window_start;
+	if (trellis->arena) trellis->bak_arena = zAllocArenaVec(trellis, "zAllocBackwardVars bak_arena");
 }
 
 static void zFreeViterbiVars(zPairTrellis *trellis) {
@@ -146,12 +302,23 @@ static void zFreeViterbiVars(zPairTrellis *trellis) {
 	}
 	zFree(trellis->extpos);
 
+	if (trellis->checkpoints != NULL) {
+		zFreeCheckpointRows(trellis, trellis->checkpoints->first, trellis->checkpoints->last);
+		zFree(trellis->checkpoints);
+		trellis->checkpoints = NULL;
+	}
 	for (p = 0; p < trellis->mem_blocks->hsps; p++) {
 		zHSP *r = &trellis->mem_blocks->hsp[p];
-		zFreePartialViterbiVars(trellis, r->g_start, r->g_end, r->c_start, r->c_end);
+		if (trellis->cell_arena != NULL) {
+			zFreePartialViterbiArena(trellis, &trellis->cell_arena[p], r->g_start, r->g_end, r->c_start, r->c_end);
+		} else if (trellis->cell[r->g_start] != NULL) {
+			zFreePartialViterbiVars(trellis, r->g_start, r->g_end, r->c_start, r->c_end);
+		}
 	}
 
-	zFree(trellis->cell);
+	zFree(trellis->cell_arena);
+	trellis->cell_arena = NULL;
+	zFree(trellis->cell + trellis->window_start);
 	trellis->cell = NULL;
 }
 
@@ -162,9 +329,15 @@ static void zFreeForwardVars(zPairTrellis *trellis) {
 
 	for (p = 0; p < trellis->mem_blocks->hsps; p++) {
 		zHSP *r = &trellis->mem_blocks->hsp[p];
-		zFreePartialVars(trellis, trellis->forward, r->g_start, r->g_end, r->c_start, r->c_end);
+		if (trellis->fwd_arena != NULL) {
+			zFreePartialArena(trellis, &trellis->fwd_arena[p], r->g_start, r->g_end, r->c_start, r->c_end);
+		} else {
+			zFreePartialVars(trellis, trellis->forward, r->g_start, r->g_end, r->c_start, r->c_end);
+		}
 	}
-	zFree(trellis->forward);
+	zFree(trellis->fwd_arena);
+	trellis->fwd_arena = NULL;
+	zFree(trellis->forward + trellis->window_start);
 	trellis->forward = NULL;
 }
 
@@ -175,12 +348,56 @@ static void zFreeBackwardVars(zPairTrellis *trellis) {
 
 	for (p = 0; p < trellis->mem_blocks->hsps; p++) {
 		zHSP *r = &trellis->mem_blocks->hsp[p];
-		zFreePartialVars(trellis, trellis->backward, r->g_start, r->g_end, r->c_start, r->c_end);
+		if (trellis->bak_arena != NULL) {
+			zFreePartialArena(trellis, &trellis->bak_arena[p], r->g_start, r->g_end, r->c_start, r->c_end);
+		} else {
+			zFreePartialVars(trellis, trellis->backward, r->g_start, r->g_end, r->c_start, r->c_end);
+		}
 	}
-	zFree(trellis->backward);
+	zFree(trellis->bak_arena);
+	trellis->bak_arena = NULL;
+	zFree(trellis->backward + trellis->window_start);
 	trellis->backward = NULL;
 }
 
+/* Forward and backward values of memory block k, once zRunPairBackward is done with them */
+
+static void zFreePosteriorBlock(zPairTrellis *trellis, int k) {
+	zHSP *r = &trellis->mem_blocks->hsp[k];
+
+	if (trellis->fwd_arena != NULL) {
+		zFreePartialArena(trellis, &trellis->fwd_arena[k], r->g_start, r->g_end, r->c_start, r->c_end);
+		zFreePartialArena(trellis, &trellis->bak_arena[k], r->g_start, r->g_end, r->c_start, r->c_end);
+	} else {
+		zFreePartialVars(trellis, trellis->forward, r->g_start, r->g_end, r->c_start, r->c_end);
+		zFreePartialVars(trellis, trellis->backward, r->g_start, r->g_end, r->c_start, r->c_end);
+	}
+}
+
+/* Move the cells marked keep out of block k's arena and release the rest of it in one go */
+
+static void zGarbageCollectPartialArena(zPairTrellis *trellis, int k) {
+	coor_t             i, j;
+	zHSP              *r     = &trellis->mem_blocks->hsp[k];
+	zPairTrellisArena *cells = &trellis->cell_arena[k];
+	size_t             cell_size  = sizeof(zPairTrellisCell)*trellis->hmm->states;
+
+	if (cells->data == NULL) return; /* Collected already */
+	for (i = r->g_start; i <= r->g_end; i++) {
+		for (j = r->c_start; j <= r->c_end; j++) {
+			if (trellis->cell[i][j][0].keep == 0) {
+				trellis->cell[i][j] = NULL;
+			} else {
+				zPairTrellisCell *cell = (zPairTrellisCell*) zSliceAlloc(cell_size, "zGarbageCollectPartialArena cell");
+				memcpy(cell, trellis->cell[i][j], cell_size);
+				trellis->cell[i][j] = cell;
+			}
+		}
+	}
+	zFree(cells->data);
+	cells->data = NULL;
+}
+
 static void zGarbageCollectPartialTrellis(zPairTrellis *trellis, coor_t genomic, coor_t cdna) {
 	coor_t i, j;
 	int k, limit;
@@ -188,25 +405,25 @@ static void zGarbageCollectPartialTrellis(zPairTrellis *trellis, coor_t genomic,
 	size_t cell_size = sizeof(zPairTrellisCell)*trellis->hmm->states;
 	zTrace2("Garbage Collecting (%u, %u)", genomic, cdna);
 
-	for (k = 0; k < mem_blocks->hsps; k++) {
-		zHSP* r = &mem_blocks->hsp[k];
-		if (genomic <= r->g_end && cdna <= r->c_end) {
-			break;
+	/* Blocks collected by an earlier call only hold cells marked keep */
+	limit = zNextAlignmentBlock(&trellis->mem_index, genomic, cdna);
+	if (limit <= trellis->collected_mem_blocks) return;
+
+	if (trellis->cell_arena != NULL) {
+		for (k = trellis->collected_mem_blocks; k < limit; k++) {
+			zGarbageCollectPartialArena(trellis, k);
 		}
+		trellis->collected_mem_blocks = limit;
+		return;
 	}
-	limit = k;
 
-	for (k = 0; k < limit; k++) {
+	for (k = trellis->collected_mem_blocks; k < limit; k++) {
 		zHSP* r = &mem_blocks->hsp[k];
 		for (i = r->g_start; i <= r->g_end; i++) {
 			for (j = r->c_start; j <= r->c_end; j++) {
 				if(trellis->cell[i][j] != NULL && trellis->cell[i][j][0].keep == 0) {
 					zSliceFree(cell_size, trellis->cell[i][j]);
 					trellis->cell[i][j] = NULL;
-					if (trellis->forward != NULL) {
-						zSliceFree(sizeof(score_t)*trellis->hmm->states, trellis->forward[i][j]);
-						trellis->forward[i][j] = NULL;
-					}
 				}
 			}
 		}
@@ -215,35 +432,48 @@ static void zGarbageCollectPartialTrellis(zPairTrellis *trellis, coor_t genomic,
 
 static void zCheckViterbiVariables(zPairTrellis *trellis, coor_t gpos, coor_t cpos) {
 	int k;
-	int required_block = zGetAlignmentBlock(trellis->mem_blocks, gpos, cpos);
+	int required_block = zNextAlignmentBlock(&trellis->mem_index, gpos, cpos);
 	if (trellis->allocated_mem_blocks >= required_block) return; /* Thumbs up! */
 
 	for (k = trellis->allocated_mem_blocks + 1; k <= required_block; k++) {
 		zHSP* r = &trellis->mem_blocks->hsp[k];
-		zAllocPartialViterbiVars(trellis, r->g_start, r->g_end, r->c_start, r->c_end);
+		if (trellis->cell_arena != NULL) {
+			zAllocPartialViterbiArena(trellis, &trellis->cell_arena[k], r->g_start, r->g_end, r->c_start, r->c_end);
+		} else {
+			zAllocPartialViterbiVars(trellis, r->g_start, r->g_end, r->c_start, r->c_end);
+		}
 	}
 	trellis->allocated_mem_blocks = required_block;
 }
 
 static void zCheckForwardVariables(zPairTrellis *trellis, coor_t gpos, coor_t cpos) {
 	int k;
-	int required_block = zGetAlignmentBlock(trellis->mem_blocks, gpos, cpos);
+	int required_block;
 	if (trellis->forward == NULL) return;
+	required_block = zNextAlignmentBlock(&trellis->mem_index, gpos, cpos);
 	if (trellis->allocated_fwd_blocks >= required_block) return; /* Thumbs up! */
 	for (k = trellis->allocated_fwd_blocks + 1; k <= required_block; k++) {
 		zHSP* r = &trellis->mem_blocks->hsp[k];
-		zAllocPartialVars(trellis, trellis->forward, r->g_start, r->g_end, r->c_start, r->c_end);
+		if (trellis->fwd_arena != NULL) {
+			zAllocPartialArena(trellis, &trellis->fwd_arena[k], trellis->forward, r->g_start, r->g_end, r->c_start, r->c_end);
+		} else {
+			zAllocPartialVars(trellis, trellis->forward, r->g_start, r->g_end, r->c_start, r->c_end);
+		}
 	}
 	trellis->allocated_fwd_blocks = required_block;
 }
 
 static void zCheckBackwardVariables(zPairTrellis *trellis, coor_t gpos, coor_t cpos) {
 	int k;
-	int required_block = zGetAlignmentBlock(trellis->mem_blocks, gpos, cpos);
+	int required_block = zFindAlignmentBlock(&trellis->mem_index, gpos, cpos);
 	if (trellis->allocated_bak_blocks <= required_block) return; /* Thumbs up! */
 	for (k = required_block; k < trellis->allocated_bak_blocks; k++) {
 		zHSP* r = &trellis->mem_blocks->hsp[k];
-		zAllocPartialVars(trellis, trellis->backward, r->g_start, r->g_end, r->c_start, r->c_end);
+		if (trellis->bak_arena != NULL) {
+			zAllocPartialArena(trellis, &trellis->bak_arena[k], trellis->backward, r->g_start, r->g_end, r->c_start, r->c_end);
+		} else {
+			zAllocPartialVars(trellis, trellis->backward, r->g_start, r->g_end, r->c_start, r->c_end);
+		}
 	}
 	trellis->allocated_bak_blocks = required_block;
 }
@@ -355,8 +585,146 @@ static void zFreeFactories(zPairTrellis *trellis) {
  zPairTrellis Utilities
 \*********************************************/
 
+/* s5 codes of the genomic window and of cdna for zGetPairEmission, so the  *
+ * PAIR models score without going through the sequence blocks every cell  */
+
+static void zFillCDnaCodes (zPairTrellis *trellis) {
+	coor_t i;
+
+	for (i = 0; i < trellis->cdna->length; i++) {
+		trellis->ccode[i] = zGetDNAS5(trellis->cdna, i);
+	}
+}
+
+static void zInitPairCodes (zPairTrellis *trellis) {
+	zHMM   *hmm = trellis->hmm;
+	coor_t  context = 0, i;
+
+	for (i = 0; i < (coor_t)hmm->feature_count; i++) {
+		zModel *model = hmm->mmap[i];
+		if (model == NULL || model->seq_type != PAIR) continue;
+		context = MAX(context, (coor_t)(model->focus + model->length/2));
+	}
+	if (context == 0) return;
+
+	trellis->gcode_start = trellis->window_start - MIN(trellis->window_start, context);
+	trellis->gcode_end   = trellis->window_end;
+	trellis->gcode = zMalloc(trellis->gcode_end - trellis->gcode_start + 1, "zInitPairCodes gcode");
+	for (i = trellis->gcode_start; i <= trellis->gcode_end; i++) {
+		trellis->gcode[i - trellis->gcode_start] = zGetDNAS5(trellis->genomic, i);
+	}
+	trellis->ccode = zMalloc(trellis->cdna->length, "zInitPairCodes ccode");
+	zFillCDnaCodes(trellis);
+}
+
+/* Scanner boundaries of state i, see zInitPairTrellis */
+
+static void zBoundPairScanner (zPairTrellis *trellis, int i) {
+	zHMM     *hmm     = trellis->hmm;
+	zModel   *model   = hmm->mmap[hmm->state[i].model];
+	zScanner *scanner = trellis->scanner[hmm->state[i].model];
+
+	if (model->seq_type == GENOMIC) {
+		scanner->min_pos = trellis->blocks->gb_start - 1 + model->length;
+	} else if (model->seq_type == DNA) {
+		scanner->min_pos = trellis->padding          - 1 + model->length;
+	} else if (model->seq_type == PAIR) {
+		scanner->min_gpos = trellis->blocks->gb_start - 1 + model->length/2;
+		scanner->min_pos  = trellis->padding          - 1 + model->length/2;
+	}
+
+	/* Only states with init_prob > 0 can extend NULL alignment. Others can only extend something that those states started */
+	if (zGetInitProb(hmm, i, trellis->tiso_group) == MIN_SCORE) {
+		scanner->min_pos  += 1;
+		scanner->min_gpos += 1;
+	}
+	if (model->seq_type == GENOMIC || model->seq_type == DNA) {
+		/* Pre-compute DNA scanners for EXPLICIT    */
+		/* states as a "running sum". Required by   */
+		/* the implementation of EXPLICIT states    */
+		/* (see zScoreScanners in zTransition.c for */
+		/* details).                                */
+		
+		zPreComputeScanner(scanner);
+	}
+}
+
+static void zFreeGenomicScanners (zScanner **scanner, int features) {
+	int i;
+
+	for (i = 0; i < features; i++) {
+		if (scanner[i] == NULL) continue;
+		zFreeScanner(scanner[i]);
+		zFree(scanner[i]);
+		scanner[i] = NULL;
+	}
+}
+
+void zInitPairScannerCache (zPairScannerCache *cache) {
+	int k;
+
+	for (k = 0; k < PAIR_SCANNER_SETS; k++) {
+		cache->set[k].genomic  = NULL;
+		cache->set[k].scanner  = NULL;
+		cache->set[k].features = 0;
+		cache->set[k].used     = 0;
+	}
+	cache->uses = 0;
+}
+
+void zFreePairScannerCache (zPairScannerCache *cache) {
+	int k;
+
+	for (k = 0; k < PAIR_SCANNER_SETS; k++) {
+		if (cache->set[k].scanner == NULL) continue;
+		zFreeGenomicScanners(cache->set[k].scanner, cache->set[k].features);
+		zFree(cache->set[k].scanner);
+	}
+	zInitPairScannerCache(cache);
+}
+
+/* The set of scanners for the genomic window of trellis, an empty one if *
+ * the cache has none yet                                                 */
+
+static zPairScannerSet* zGetPairScannerSet (zPairScannerCache *cache, zPairTrellis *trellis) {
+	zHMM            *hmm = trellis->hmm;
+	zPairScannerSet *set = NULL;
+	int              k;
+
+	for (k = 0; k < PAIR_SCANNER_SETS; k++) {
+		zPairScannerSet *s = &cache->set[k];
+		if (s->genomic == trellis->genomic && s->strand == hmm->state[0].strand
+			&& s->gb_start == trellis->blocks->gb_start && s->features == hmm->feature_count) {
+			set = s;
+			break;
+		}
+		if (set == NULL || s->used < set->used) set = s;
+	}
+	if (k == PAIR_SCANNER_SETS) {
+		if (set->scanner != NULL) {
+			zFreeGenomicScanners(set->scanner, set->features);
+			zFree(set->scanner);
+		}
+		set->genomic  = trellis->genomic;
+		set->strand   = hmm->state[0].strand;
+		set->gb_start = trellis->blocks->gb_start;
+		set->features = hmm->feature_count;
+		set->scanner  = zCalloc(hmm->feature_count, sizeof(zScanner*), "zGetPairScannerSet scanner[]");
+	}
+	set->used = ++cache->uses;
+	return set;
+}
+
 void zInitPairTrellis (zPairTrellis *trellis, zSeedAlignment *seed, zDNA *genomic, zDNA *cdna, zHMM *hmm) {
-	int         i;
+	zInitCachedPairTrellis(trellis, seed, genomic, cdna, hmm, NULL);
+}
+
+/* A padded copy of the genomic sequence dies with the trellis, so only a  *
+ * borrowed one can have its scanners in cache                              */
+
+void zInitCachedPairTrellis (zPairTrellis *trellis, zSeedAlignment *seed, zDNA *genomic, zDNA *cdna, zHMM *hmm, zPairScannerCache *cache) {
+	zPairScannerSet *set = NULL;
+	int              i;
 
 	/* clear out pointers */
 	trellis->cell      = NULL;
@@ -369,25 +737,58 @@ void zInitPairTrellis (zPairTrellis *trellis, zSeedAlignment *seed, zDNA *genomi
 	trellis->hmm       = NULL;
 	trellis->fexternal = NULL;
 	trellis->scanner   = NULL;
+	trellis->scanner_cache = NULL;
 	trellis->factory   = NULL;
 	trellis->extpos    = NULL;
 	trellis->external  = NULL;
 	trellis->seed      = NULL;
 	trellis->blocks    = NULL;
 	trellis->mem_blocks= NULL;
+	trellis->cell_arena= NULL;
+	trellis->fwd_arena = NULL;
+	trellis->bak_arena = NULL;
+	trellis->arena     = true;
+	trellis->wavefront = true;
+	trellis->specialize= true;
+	trellis->kernel    = NULL;
+	trellis->splice_prune = true;
+	trellis->splice_sites   = NULL;
+	trellis->tile_threads   = 1;
+	trellis->tiles          = NULL;
+	trellis->beam           = 0;
+	trellis->beam_retry     = false;
+	trellis->beam_hits      = 0;
+	trellis->beam_retried   = false;
+	trellis->band      = 0;
+	trellis->checkpoint  = false;
+	trellis->checkpoints = NULL;
+	trellis->compact     = false;
+	trellis->posteriors  = false;
+	trellis->mea_threshold = 0;
+	trellis->sparse      = NULL;
+	trellis->gcode       = NULL;
+	trellis->ccode       = NULL;
 	
 	trellis->padding   = PADDING;
 
 	/* initial setup */
 	trellis->fcdna   = zMalloc(sizeof(zDNA), "zInitPairTrellis dna");
 	trellis->rcdna   = zMalloc(sizeof(zDNA), "zInitPairTrellis rdna");
-	trellis->genomic = zMalloc(sizeof(zDNA), "zInitPairTrellis rdna");
 	zInitDNA(trellis->fcdna);
 	zInitDNA(trellis->rcdna);
-	zInitDNA(trellis->genomic);
 
-	zCopyDNA(genomic, trellis->genomic);
-	zSetDNAPadding(trellis->genomic,trellis->padding);
+	/* A genomic sequence that carries the trellis padding already is borrowed *
+	 * as it is and never changed; anything else gets a padded copy            */
+	if (genomic->seq->padding == trellis->padding) {
+		trellis->genomic     = genomic;
+		trellis->own_genomic = false;
+	} else {
+		trellis->genomic     = zMalloc(sizeof(zDNA), "zInitPairTrellis genomic");
+		trellis->own_genomic = true;
+		zInitDNA(trellis->genomic);
+		zCopyDNA(genomic, trellis->genomic);
+		zSetDNAPadding(trellis->genomic,trellis->padding);
+	}
 
 	zCopyDNA(cdna, trellis->fcdna);
 	zSetDNAPadding(trellis->fcdna,trellis->padding);
@@ -416,12 +817,12 @@ void zInitPairTrellis (zPairTrellis *trellis, zSeedAlignment *seed, zDNA *genomi
 		trellis->blocks->hsps = 1;
 		trellis->blocks->hsp = zMalloc(sizeof(zHSP), "zInitPairTrellis: trellis->blocks->hsp");
 		trellis->blocks->gb_start = 1;
-		trellis->blocks->gb_end   = genomic->length;
+		trellis->blocks->gb_end   = trellis->genomic->seq->real_length;
 
 		hsp = &trellis->blocks->hsp[0];
 		hsp->g_start = 1; 
 		hsp->c_start = 1; 
-		hsp->g_end = genomic->length;
+		hsp->g_end = trellis->genomic->seq->real_length;
 		hsp->c_end = cdna->length;
 		zTranslateSeedAlignment(trellis->blocks, trellis->padding - 1);
 	} else {
@@ -447,11 +848,37 @@ void zInitPairTrellis (zPairTrellis *trellis, zSeedAlignment *seed, zDNA *genomi
 	trellis->mem_blocks->hsp[trellis->mem_blocks->hsps-1].g_end = MIN(trellis->genomic->length - 1, trellis->blocks->gb_end);
 	trellis->mem_blocks->hsp[trellis->mem_blocks->hsps-1].c_end = trellis->cdna->length - 1;
 
+	/* The recurrence looks back one state increment from the start of the alignment, *
+	 * so every memory block touching it carries that much of a MIN_SCORE margin      */
+
+	if (hmm->mode == GPAIRHMM) {
+		zHSP *r;
+		int   gmargin = 0, cmargin = 0;
+		for (i = 0; i < hmm->states; i++) {
+			gmargin = MAX(gmargin, zGetGenomicIncrement(hmm, i));
+			cmargin = MAX(cmargin, zGetCDnaIncrement(hmm, i));
+		}
+		for (i = 0; i < trellis->mem_blocks->hsps; i++) {
+			r = &trellis->mem_blocks->hsp[i];
+			if (r->c_start > trellis->padding - 1) continue;
+			r->c_start -= MIN(r->c_start, (coor_t)cmargin);
+		}
+		r = &trellis->mem_blocks->hsp[0];
+		r->g_start -= MIN(r->g_start, (coor_t)gmargin);
+	}
+
 	trellis->blocks->hsp[0].c_start = trellis->padding - 1;
 	trellis->blocks->hsp[0].g_start = MAX(1, trellis->blocks->gb_start)-1;
 	trellis->blocks->hsp[trellis->blocks->hsps-1].g_end = MIN(trellis->genomic->length - 1, trellis->blocks->gb_end);
 
+	/* cell, forward and backward only span the memory blocks, not the whole genomic sequence */
+
+	trellis->window_start = trellis->mem_blocks->hsp[0].g_start;
+	trellis->window_end   = trellis->mem_blocks->hsp[trellis->mem_blocks->hsps-1].g_end;
+
+	zInitBlockIndex(&trellis->mem_index, trellis->mem_blocks);
 	trellis->allocated_mem_blocks = -1;
+	trellis->collected_mem_blocks = 0;
 	trellis->allocated_fwd_blocks = -1;
 	trellis->allocated_bak_blocks = trellis->mem_blocks->hsps;
 
@@ -480,6 +907,10 @@ void zInitPairTrellis (zPairTrellis *trellis, zSeedAlignment *seed, zDNA *genomi
 	/* create scanners */
 	trellis->scanner  = zCalloc(hmm->feature_count, sizeof(zScanner*), 
 								"zInitPairTrellis: scanner[]");
+	if (cache != NULL && !trellis->own_genomic && hmm->mode == GPAIRHMM) {
+		set = zGetPairScannerSet(cache, trellis);
+		trellis->scanner_cache = cache;
+	}
 	
 	for (i = 0; i < hmm->feature_count; i++) {
 		zModel* model = hmm->mmap[i];
@@ -487,9 +918,12 @@ void zInitPairTrellis (zPairTrellis *trellis, zSeedAlignment *seed, zDNA *genomi
 		if (model->seq_type == DNA) {
 			trellis->scanner[i] = zMalloc(sizeof(zScanner), "zInitPairTrellis scan");
 			zInitScanner(trellis->scanner[i], trellis->cdna->seq, model);
+		} else if (model->seq_type == GENOMIC && set != NULL && set->scanner[i] != NULL) {
+			trellis->scanner[i] = set->scanner[i]; /* precomputed already */
 		} else if (model->seq_type == GENOMIC) {
 			trellis->scanner[i] = zMalloc(sizeof(zScanner), "zInitPairTrellis scan");
 			zInitScanner(trellis->scanner[i], trellis->genomic->seq, model);
+			if (set != NULL) set->scanner[i] = trellis->scanner[i];
 		} else if (model->seq_type == PAIR) {
 			trellis->scanner[i] = zMalloc(sizeof(zScanner), "zInitPairTrellis scan");
 			zInitScanner(trellis->scanner[i], trellis->genomic->seq, model);
@@ -507,42 +941,59 @@ void zInitPairTrellis (zPairTrellis *trellis, zSeedAlignment *seed, zDNA *genomi
 	 ********************************************************************************/
 	if (hmm->mode == GPAIRHMM) {
 		for (i = 0; i < hmm->states; i++) {
-			zModel* model = hmm->mmap[hmm->state[i].model];
-			zScanner *scanner = trellis->scanner[hmm->state[i].model];
-			if (model->seq_type == GENOMIC) {
-				scanner->min_pos = trellis->blocks->gb_start - 1 + model->length;
-			} else if (model->seq_type == DNA) {
-				scanner->min_pos = trellis->padding          - 1 + model->length;
-			} else if (model->seq_type == PAIR) {
-				scanner->min_gpos = trellis->blocks->gb_start - 1 + model->length/2;
-				scanner->min_pos  = trellis->padding          - 1 + model->length/2;
-			}
-
-			/* Only states with init_prob > 0 can extend NULL alignment. Others can only extend something that those states started */
-			if (zGetInitProb(hmm, i, trellis->tiso_group) == MIN_SCORE) {
-				scanner->min_pos  += 1;
-				scanner->min_gpos += 1;
-			}
-			if (model->seq_type == GENOMIC || model->seq_type == DNA) {
-				/* Pre-compute DNA scanners for EXPLICIT    */
-				/* states as a "running sum". Required by   */
-				/* the implementation of EXPLICIT states    */
-				/* (see zScoreScanners in zTransition.c for */
-				/* details).                                */
-				
-				zPreComputeScanner(scanner);
-			}
+			zBoundPairScanner(trellis, i);
 		}
 	}
 
+	if (hmm->mode == GPAIRHMM) zInitPairCodes(trellis);
 	if (hmm->mode != GPAIRHMM) zAllocFactories(trellis);
 }
 
+/* Turn the trellis to the other orientation of its cDNA (fcdna or rcdna), to  *
+ * decode it against the same genomic window. The genomic scanners with their  *
+ * precomputed scores, gcode and the memory blocks stay as they are; the cells *
+ * of the last decoding, the cDNA scanners and ccode start over. A seed holds  *
+ * for one orientation only, so only a trellis without one can turn.           */
+
+void zReversePairTrellis (zPairTrellis *trellis) {
+	zHMM *hmm = trellis->hmm;
+	int   i;
+
+	if (trellis->seed != NULL) zDie("zReversePairTrellis: a seeded trellis aligns one orientation only");
+	if (hmm->mode != GPAIRHMM) zDie("zReversePairTrellis: GPAIRHMM only");
+
+	zFreeViterbiVars(trellis);
+	zFreeForwardVars(trellis);
+	zFreeBackwardVars(trellis);
+	trellis->mem_index.cursor       = 0;
+	trellis->allocated_mem_blocks   = -1;
+	trellis->collected_mem_blocks   = 0;
+	trellis->allocated_fwd_blocks   = -1;
+	trellis->allocated_bak_blocks   = trellis->mem_blocks->hsps;
+
+	trellis->cdna = (trellis->cdna == trellis->fcdna) ? trellis->rcdna : trellis->fcdna;
+	for (i = 0; i < hmm->feature_count; i++) {
+		zScanner *scanner = trellis->scanner[i];
+		zModel   *model;
+		if (scanner == NULL || scanner->model->seq_type != DNA) continue;
+		model = scanner->model;
+		zFreeScanner(scanner);
+		zInitScanner(scanner, trellis->cdna->seq, model);
+	}
+	for (i = 0; i < hmm->states; i++) {
+		if (hmm->mmap[hmm->state[i].model]->seq_type == DNA) zBoundPairScanner(trellis, i);
+	}
+	if (trellis->ccode != NULL) zFillCDnaCodes(trellis);
+}
+
 void zFreePairTrellis (zPairTrellis *trellis) {
 	int i;
 	
 	for (i = 0; i < trellis->hmm->feature_count; i++) {
 		zScanner* scanner = trellis->scanner[i];
+		if (scanner != NULL && scanner->model->seq_type == GENOMIC && trellis->scanner_cache != NULL) {
+			continue; /* the cache frees it */
+		}
 		if (scanner  != NULL) {
 			if (scanner->model->seq_type == GENOMIC || scanner->model->seq_type == DNA) {
 				zDePreComputeScanner(scanner);
@@ -559,6 +1010,8 @@ void zFreePairTrellis (zPairTrellis *trellis) {
 	zFreeViterbiVars(trellis);
 	zFreeForwardVars(trellis);
 	zFreeBackwardVars(trellis);
+	zFreeSparseCells(trellis);
+	zFreePairSpliceSites(trellis->splice_sites);
 
 	/* Stepping Stone stuff */
 	zFreeSeedAlignment(trellis->mem_blocks);
@@ -568,14 +1021,19 @@ void zFreePairTrellis (zPairTrellis *trellis) {
 	zFree(trellis->blocks);
 	zFree(trellis->seed);
 	
+	zFree(trellis->gcode);          trellis->gcode = NULL;
+	zFree(trellis->ccode);          trellis->ccode = NULL;
+
 	zFreeDNA(trellis->fcdna);
 	zFree(trellis->fcdna);
 	trellis->fcdna = NULL;
 	zFreeDNA(trellis->rcdna);
 	zFree(trellis->rcdna);
 	trellis->rcdna = NULL;
-	zFreeDNA(trellis->genomic);
-	zFree(trellis->genomic);
+	if (trellis->own_genomic) {
+		zFreeDNA(trellis->genomic);
+		zFree(trellis->genomic);
+	}
 	trellis->genomic = NULL;
 }
 
@@ -595,8 +1053,9 @@ static void zStartAlignmentForward(zPairTrellis *trellis, coor_t gpos, coor_t cp
 		/* Start state */
 		zPairTrellisCell *cell = zGetCurrentCell(trellis, gpos, cpos, state);
 		score  = zGetFixedInitProb(hmm, state, trellis->iiso_group, trellis->genomic->gc); /* Fixed Initial Probability */
+		if (trellis->forward != NULL) trellis->forward[gpos][cpos][state] = score;
 		if (score > MIN_SCORE) {
-			cell->score  = score;
+			zSetCellScore(trellis, cell, score);
 			cell->length = 0;
 			cell->trace  = state;
 			cell->keep   = 1;
@@ -608,9 +1067,9 @@ static void zStartAlignmentForward(zPairTrellis *trellis, coor_t gpos, coor_t cp
 		real_cpos = cpos + zGetCDnaIncrement(hmm, state);
 		cell = zGetCurrentCell(trellis, real_gpos, real_cpos, state);
 		score += zGetScannerScore(trellis, trellis->scanner[trellis->hmm->state[state].model], state, real_gpos, real_cpos); /* Score that pos */
-		if (trellis->forward != NULL) trellis->forward[real_gpos][real_cpos][state] = cell->score;
 		if (score > MIN_SCORE) {
-			cell->score  = score;
+			if (trellis->forward != NULL) trellis->forward[real_gpos][real_cpos][state] = score;
+			zSetCellScore(trellis, cell, score);
 			cell->length = 1;
 			cell->trace  = state;
 			cell->keep   = 1;
@@ -627,36 +1086,55 @@ static void zFinishAlignmentForward(zPairTrellis *trellis, coor_t gpos, coor_t c
 	for (state = 0; state < trellis->hmm->states; state++) {
 		zPairTrellisCell *cell = zGetCurrentCell(trellis, gpos, cpos, state);
 		score_t score  = zGetInitProb(trellis->hmm, state, trellis->iiso_group);
-		cell->score  += score;
-		if (trellis->forward != NULL) trellis->forward_score = zFloatwiseScoreAdd(trellis->forward[gpos][cpos][state]+score, trellis->forward_score);
+		zSetCellScore(trellis, cell, cell->score + score);
+		if (trellis->forward != NULL) trellis->forward_score = zLogAddScore(trellis->forward[gpos][cpos][state]+score, trellis->forward_score);
 	}
 }
 
-static void zRunPartialPairViterbiAndForward(zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend) {
+/* cdna range [clo, chi] of row genomic within [cstart, cend] and dlo <= genomic - cdna <= dhi */
+
+static bool zGetBandRow(coor_t genomic, coor_t cstart, coor_t cend, long dlo, long dhi, coor_t *clo, coor_t *chi) {
+	long lo = MAX((long)cstart, (long)genomic - dhi);
+	long hi = MIN((long)cend,   (long)genomic - dlo);
+	if (hi < lo) return false;
+	*clo = lo;
+	*chi = hi;
+	return true;
+}
+
+/* One of the fills below, for a block or a tile of it (see zPairTile.h) */
+
+static void zFillPairBlock(zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi) {
 	zHMM         *hmm = trellis->hmm;
 	coor_t        genomic, cdna; /* iterators for sequence */
+	coor_t        clo, chi;      /* cdna range of the band in this row */
 	int           state;         /* iterator for internal states */
 	int           prev;          /* iterator for previous states */
 	zIVec*        jumps;
+	coor_t        ahead;         /* see zGetSpliceAheadEnd */
+	const char   *skip;
 
 	zPairTrellisCell *cell;
 
-	/* induction */
-	zTrace2("beginning induction");
-
-	/* Make sure that all the required blocks are loaded */
-	zCheckViterbiVariables(trellis, gend, cend);
-	zCheckForwardVariables(trellis, gend, cend);
-	zTrace2("Calling (%u, %u) (%u, %u)", gstart, cstart, gend, cend);
+	if (trellis->kernel != NULL) {
+		trellis->kernel->fill(trellis, gstart, gend, cstart, cend, dlo, dhi);
+		return;
+	}
+	if (trellis->wavefront) {
+		zRunPairWavefront(trellis, gstart, gend, cstart, cend, dlo, dhi);
+		return;
+	}
+	ahead = zGetSpliceAheadEnd(trellis, gstart, gend);
 	for (genomic = gstart; genomic <= gend; genomic++) {
-		for (cdna = cstart; cdna <= cend; cdna++) {
+		if (!zGetBandRow(genomic, cstart, cend, dlo, dhi, &clo, &chi)) continue;
+		skip = zGetSpliceSkipRow(trellis, genomic, ahead);
+		for (cdna = clo; cdna <= chi; cdna++) {
 			for (state = 0; state < hmm->states; state++) {
 				if (NULL == (cell = zGetCurrentCell(trellis, genomic, cdna, state))) continue;
 				if (cell->score != MIN_SCORE) continue; /* Has been done already */
 
-#ifdef FORWARD
 				if (trellis->forward != NULL) trellis->forward[genomic][cdna][state] = MIN_SCORE;
-#endif
+				if (skip != NULL && skip[state]) continue;
 				jumps = hmm->jmap[state];
 				for (prev = 0; prev < jumps->size; prev++) {
 					zGetPairTransFunc(hmm->state[state].type)
@@ -667,25 +1145,290 @@ static void zRunPartialPairViterbiAndForward(zPairTrellis *trellis, coor_t gstar
 	}
 }
 
-zAFVec* zRunPairViterbiAndForward (zPairTrellis *trellis, score_t* path_score) {
-	zDNA         *cdna = trellis->cdna;
-	zDNA         *genomic = trellis->genomic;
+/* Fills the cells of the block with dlo <= genomic - cdna <= dhi; the rest stay MIN_SCORE */
+
+static void zRunPartialPairViterbiAndForward(zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi) {
+	/* induction */
+	zTrace2("beginning induction");
+
+	/* Make sure that all the required blocks are loaded */
+	zCheckViterbiVariables(trellis, gend, cend);
+	zCheckForwardVariables(trellis, gend, cend);
+	zTrace2("Calling (%u, %u) (%u, %u)", gstart, cstart, gend, cend);
+	zRunPairTiles(trellis, gstart, gend, cstart, cend, dlo, dhi, zFillPairBlock);
+}
+
+/*********************************************\
+ Banded Viterbi around seed HSPs
+\*********************************************/
+
+/* True if (genomic, cdna) lies in one of the alignment blocks before block k, *
+ * which were filled in full before block k was started                      */
+
+static bool zInEarlierAlignmentBlock(zPairTrellis *trellis, int k, coor_t genomic, coor_t cdna) {
+	int j;
+	for (j = k - 1; j >= 0; j--) {
+		zHSP *r = &trellis->blocks->hsp[j];
+		if (r->g_end < genomic) break; /* and so do all the blocks before it */
+		if (genomic >= r->g_start && cdna >= r->c_start && cdna <= r->c_end) return true;
+	}
+	return false;
+}
+
+/* Undo a band pass over block k, leaving alone what the earlier blocks filled */
+
+static void zClearBand(zPairTrellis *trellis, int k, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi) {
+	coor_t            genomic, cdna, clo, chi;
+	int               state;
+	zPairTrellisCell *cell;
+
+	for (genomic = gstart; genomic <= gend; genomic++) {
+		if (!zGetBandRow(genomic, cstart, cend, dlo, dhi, &clo, &chi)) continue;
+		for (cdna = clo; cdna <= chi; cdna++) {
+			if (NULL == (cell = zGetCellArray(trellis, genomic, cdna))) continue;
+			if (zInEarlierAlignmentBlock(trellis, k, genomic, cdna)) continue;
+			for (state = 0; state < trellis->hmm->states; state++) {
+				cell[state].score  = MIN_SCORE;
+				cell[state].length = -1;
+				cell[state].trace  = -1;
+				if (trellis->forward != NULL) trellis->forward[genomic][cdna][state] = MIN_SCORE;
+			}
+		}
+	}
+}
+
+/* Follow the best path back from (genomic, cdna, state) for as long as it runs *
+ * through cells of the band pass of block k. True if it reaches an edge of the *
+ * band that is not an edge of the block as well.                              */
+
+static bool zBandTraceOnEdge(zPairTrellis *trellis, int k, coor_t genomic, coor_t cdna, int state, coor_t gstart, coor_t cstart, long dlo, long dhi, long rlo, long rhi) {
+	zHMM             *hmm = trellis->hmm;
+	zPairTrellisCell *cell;
+	long              d;
+
+	while (genomic >= gstart && cdna >= cstart && !zInEarlierAlignmentBlock(trellis, k, genomic, cdna)) {
+		d = (long)genomic - (long)cdna;
+		if ((d <= dlo && dlo > rlo) || (d >= dhi && dhi < rhi)) return true;
+		cell = zGetCurrentCell(trellis, genomic, cdna, state);
+		if (cell->length <= 0 || cell->trace < 0) break;
+		genomic -= cell->length*zGetGenomicIncrement(hmm, state);
+		cdna    -= cell->length*zGetCDnaIncrement(hmm, state);
+		state    = cell->trace;
+		if (NULL == zGetCellArray(trellis, genomic, cdna)) break;
+	}
+	return false;
+}
+
+/* The best state of (genomic, cdna) if it beats *score, which it then takes, or -1 */
+
+static int zGetBandBestState(zPairTrellis *trellis, coor_t genomic, coor_t cdna, score_t *score) {
+	zPairTrellisCell *cell;
+	int               state, best = -1;
+
+	if (NULL == (cell = zGetCellArray(trellis, genomic, cdna))) return -1;
+	for (state = 0; state < trellis->hmm->states; state++) {
+		if (cell[state].score == MIN_SCORE || cell[state].score <= *score) continue;
+		*score = cell[state].score;
+		best   = state;
+	}
+	return best;
+}
+
+/* The path leaves block k for the next one anywhere in their overlap, not   *
+ * only at the end corner: the next block reads the last lookback rows of    *
+ * block k and its last cDNA column. Follow the path back from the best cell *
+ * of each of those rows, of that column and of the corner. True if one of   *
+ * them reaches an edge of the band that is not an edge of the block as      *
+ * well, or if nothing got through to the corner.                           */
+
+static bool zBandPathOnEdge(zPairTrellis *trellis, int k, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi, long rlo, long rhi) {
+	coor_t  genomic, cdna, clo, chi, gbest, cbest;
+	coor_t  lookback = zGetPairLookback(trellis->hmm);
+	int     state, best;
+	score_t score;
+
+	score = MIN_SCORE;
+	if ((best = zGetBandBestState(trellis, gend, cend, &score)) < 0) return true;
+	if (zBandTraceOnEdge(trellis, k, gend, cend, best, gstart, cstart, dlo, dhi, rlo, rhi)) return true;
+
+	/* rows */
+	for (genomic = (gend - gstart >= lookback) ? gend - lookback + 1 : gstart; genomic <= gend; genomic++) {
+		if (!zGetBandRow(genomic, cstart, cend, dlo, dhi, &clo, &chi)) continue;
+		score = MIN_SCORE;
+		best  = -1;
+		for (cdna = clo; cdna <= chi; cdna++) {
+			if ((state = zGetBandBestState(trellis, genomic, cdna, &score)) < 0) continue;
+			best  = state;
+			cbest = cdna;
+		}
+		if (best >= 0 && zBandTraceOnEdge(trellis, k, genomic, cbest, best, gstart, cstart, dlo, dhi, rlo, rhi)) return true;
+	}
+
+	/* column */
+	score = MIN_SCORE;
+	best  = -1;
+	for (genomic = gstart; genomic <= gend; genomic++) {
+		if (!zGetBandRow(genomic, cstart, cend, dlo, dhi, &clo, &chi) || chi != cend) continue;
+		if ((state = zGetBandBestState(trellis, genomic, cend, &score)) < 0) continue;
+		best  = state;
+		gbest = genomic;
+	}
+	return best >= 0 && zBandTraceOnEdge(trellis, k, gbest, cend, best, gstart, cstart, dlo, dhi, rlo, rhi);
+}
+
+/* Block k was built around seed HSP hsp, so the path should stay near its *
+ * diagonal(s). Fill a band of trellis->band diagonals on either side and  *
+ * double it, from scratch, for as long as the best path runs into an edge */
+
+static void zRunBandedPairViterbi(zPairTrellis *trellis, int k, zHSP *hsp, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend) {
+	long rlo   = (long)gstart - (long)cend; /* diagonals of the whole block */
+	long rhi   = (long)gend - (long)cstart;
+	long dmin  = MIN((long)hsp->g_start - (long)hsp->c_start, (long)hsp->g_end - (long)hsp->c_end);
+	long dmax  = MAX((long)hsp->g_start - (long)hsp->c_start, (long)hsp->g_end - (long)hsp->c_end);
+	long width = trellis->band;
+	long dlo, dhi;
+
+	for (;;) {
+		dlo = MAX(rlo, dmin - width);
+		dhi = MIN(rhi, dmax + width);
+		zRunPartialPairViterbiAndForward(trellis, gstart, gend, cstart, cend, dlo, dhi);
+		if (dlo == rlo && dhi == rhi) return;
+		if (!zBandPathOnEdge(trellis, k, gstart, gend, cstart, cend, dlo, dhi, rlo, rhi)) return;
+		zClearBand(trellis, k, gstart, gend, cstart, cend, dlo, dhi);
+		width *= 2;
+		zTrace2("block %d: widening the band to %ld", k, width);
+	}
+}
+
+/*********************************************\
+ Checkpointed Viterbi without a seed
+\*********************************************/
+
+/* Genomic rows any transition reads behind the cell it fills */
+
+static coor_t zGetPairLookback(zHMM *hmm) {
+	int            state;
+	coor_t         rows, lookback = 1;
+	zDistribution *d;
+
+	for (state = 0; state < hmm->states; state++) {
+		rows = zGetGenomicIncrement(hmm, state);
+		if (hmm->state[state].type == EXPLICIT) {
+			d     = &hmm->dmap[hmm->state[state].duration]->duration[0].distribution[0];
+			rows *= d->end - d->start + 1; /* see zExplicitPairTrans */
+		}
+		lookback = MAX(lookback, rows);
+	}
+	return lookback;
+}
+
+static coor_t zGetCheckpointSegmentStart(zPairCheckpoints *cp, int k) {
+	return cp->first + k*cp->segment;
+}
+
+static coor_t zGetCheckpointSegmentEnd(zPairCheckpoints *cp, int k) {
+	return MIN(cp->last, cp->first + (k+1)*cp->segment - 1);
+}
+
+static void zInitPairCheckpoints(zPairTrellis *trellis, coor_t gstart, coor_t cstart, coor_t cend) {
+	zPairCheckpoints *cp = zMalloc(sizeof(zPairCheckpoints), "zInitPairCheckpoints");
+	coor_t            rows;
+
+	cp->first    = trellis->mem_blocks->hsp[0].g_start;
+	cp->last     = trellis->mem_blocks->hsp[0].g_end;
+	cp->gstart   = gstart;
+	cp->cstart   = cstart;
+	cp->cend     = cend;
+	cp->lookback = zGetPairLookback(trellis->hmm);
+	cp->live     = -1;
+
+	/* (rows/segment)*lookback checkpoint rows and one segment are held at a time. *
+	 * The first segment also holds what zStartAlignmentForward writes            */
+	rows         = cp->last - cp->first + 1;
+	cp->segment  = MAX(gstart - cp->first + cp->lookback + 1, (coor_t)sqrt((double)rows*cp->lookback));
+	zTrace2("checkpoints: %u rows, segments of %u, lookback %u", rows, cp->segment, cp->lookback);
+
+	trellis->checkpoints          = cp;
+	trellis->allocated_mem_blocks = 0; /* rows come from zAllocCheckpointRows */
+	zAllocCheckpointRows(trellis, cp->first, zGetCheckpointSegmentEnd(cp, 0));
+}
+
+/* First pass: keep the last lookback rows of each segment and all of the last one */
+
+static void zRunCheckpointedPairViterbi(zPairTrellis *trellis) {
+	zPairCheckpoints *cp = trellis->checkpoints;
+	int               k, segments = (cp->last - cp->first)/cp->segment + 1;
+	coor_t            start, end;
+
+	for (k = 0; k < segments; k++) {
+		start = zGetCheckpointSegmentStart(cp, k);
+		end   = zGetCheckpointSegmentEnd(cp, k);
+		zAllocCheckpointRows(trellis, start, end);
+		if (end >= cp->gstart) {
+			start = MAX(start, cp->gstart);
+			zRunPartialPairViterbiAndForward(trellis, start, end, cp->cstart, cp->cend,
+											 (long)start - (long)cp->cend, (long)end - (long)cp->cstart);
+		}
+		if (k < segments - 1) {
+			zFreeCheckpointRows(trellis, zGetCheckpointSegmentStart(cp, k), end - cp->lookback);
+		}
+	}
+}
+
+/* Make row genomic available to the traceback, which only ever moves back:   *
+ * the segment refilled before is dropped and the one holding genomic is      *
+ * recomputed from the checkpoint rows in front of it                         */
+
+static void zRefillCheckpointSegment(zPairTrellis *trellis, coor_t genomic) {
+	zPairCheckpoints *cp = trellis->checkpoints;
+	coor_t            start, end;
+	int               k;
+
+	if (trellis->cell[genomic] != NULL) return;
+	if (cp->live >= 0) {
+		zFreeCheckpointRows(trellis, zGetCheckpointSegmentStart(cp, cp->live), zGetCheckpointSegmentEnd(cp, cp->live) - cp->lookback);
+	}
+	k     = (genomic - cp->first)/cp->segment;
+	start = zGetCheckpointSegmentStart(cp, k);
+	end   = zGetCheckpointSegmentEnd(cp, k) - cp->lookback;
+	zTrace2("refilling rows %u-%u for the traceback", start, end);
+	zAllocCheckpointRows(trellis, start, end);
+	if (k == 0) zStartAlignmentForward(trellis, cp->gstart, cp->cstart);
+	if (end >= cp->gstart) {
+		start = MAX(start, cp->gstart);
+		zRunPartialPairViterbiAndForward(trellis, start, end, cp->cstart, cp->cend,
+										 (long)start - (long)cp->cend, (long)end - (long)cp->cstart);
+	}
+	cp->live = k;
+}
+
+/* The cells zStartAlignmentForward and zFinishAlignmentForward work on */
 
+static void zGetPairAlignmentEnds(zPairTrellis *trellis, coor_t *gmin, coor_t *cmin, coor_t *gmax, coor_t *cmax) {
+	*gmin = MAX(                            trellis->padding - 1, trellis->blocks->gb_start - 1);
+	*cmin =                                 trellis->padding - 1;
+	*gmax = MIN( trellis->genomic->length - trellis->padding - 1, trellis->blocks->gb_end);
+	*cmax =         trellis->cdna->length - trellis->padding - 1;
+}
+
+zAFVec* zRunPairViterbiAndForward (zPairTrellis *trellis, score_t* path_score) {
 	zAFVec       *afv;
 	int           i;
 	coor_t        gmin, cmin, gmax, cmax;
 
-	gmin = MAX(                   trellis->padding - 1, trellis->blocks->gb_start - 1);
-	cmin =                        trellis->padding - 1;
-	gmax = MIN( genomic->length - trellis->padding - 1, trellis->blocks->gb_end);
-	cmax =         cdna->length - trellis->padding - 1;
+	zGetPairAlignmentEnds(trellis, &gmin, &cmin, &gmax, &cmax);
+	trellis->kernel = (trellis->specialize) ? zFindPairKernel(trellis) : NULL;
+	zFreePairSpliceSites(trellis->splice_sites);
+	trellis->splice_sites = (trellis->splice_prune) ? zInitPairSpliceSites(trellis, gmin, gmax) : NULL;
 	 	 
 	/* 	Viterbi and Forward Alg initialization */
 
 	zAllocViterbiVars(trellis);
+	if (trellis->posteriors) zAllocForwardVars(trellis);
+	if (trellis->checkpoint && trellis->blocks->hsps == 1 && trellis->forward == NULL) {
+		zInitPairCheckpoints(trellis, MAX(trellis->blocks->hsp[0].g_start, gmin), MAX(trellis->blocks->hsp[0].c_start, cmin), trellis->blocks->hsp[0].c_end);
+	}
 	zCheckViterbiVariables(trellis, gmin, cmin);
-
-	if (0) zAllocForwardVars(trellis);
 	zCheckForwardVariables(trellis, gmin, cmin);
 
 	/* induction - first pass */
@@ -695,8 +1438,19 @@ zAFVec* zRunPairViterbiAndForward (zPairTrellis *trellis, score_t* path_score) {
 
 	zTrace2("running viterbi");
 	for (i = 0; i < trellis->blocks->hsps; i++) {
-		zHSP *hsp = &trellis->blocks->hsp[i];
-		zRunPartialPairViterbiAndForward(trellis, hsp->g_start, hsp->g_end, hsp->c_start, hsp->c_end);
+		zHSP  *hsp = &trellis->blocks->hsp[i];
+		/* Nothing before (gmin, cmin) is reachable from the start of the alignment */
+		coor_t gstart = MAX(hsp->g_start, gmin);
+		coor_t cstart = MAX(hsp->c_start, cmin);
+		int    seed_hsp = (trellis->band > 0) ? zGetAlignmentBlockHSP(trellis->seed, hsp) : -1;
+		if (trellis->checkpoints != NULL) {
+			zRunCheckpointedPairViterbi(trellis);
+		} else if (seed_hsp >= 0) {
+			zRunBandedPairViterbi(trellis, i, &trellis->seed->hsp[seed_hsp], gstart, hsp->g_end, cstart, hsp->c_end);
+		} else {
+			zRunPartialPairViterbiAndForward(trellis, gstart, hsp->g_end, cstart, hsp->c_end,
+											 (long)gstart - (long)hsp->c_end, (long)hsp->g_end - (long)cstart);
+		}
 		/* Garbage collect in regions that wont be required by the next hsp */
 		if (i < trellis->blocks->hsps - 1) {
 			coor_t k;
@@ -708,6 +1462,7 @@ zAFVec* zRunPairViterbiAndForward (zPairTrellis *trellis, score_t* path_score) {
 					garbage_collect = 1;
 				}
 			}
+			/* Only the Viterbi cells go, zRunPairBackward releases the forward values */
 			if (garbage_collect == 1) {
 				/* This number 32 comes from max explicit duration length = 30 and buffer 2 */
 				zGarbageCollectPartialTrellis(trellis, MAX(next_hsp->g_start, 32+trellis->padding) - 32, MAX(next_hsp->c_start, 32+trellis->padding) - 32);
@@ -731,6 +1486,31 @@ cmax = cmin;
 	return afv;
 }
 
+/* What a feature score adds to the scores of its cells: the exit probability *
+ * that zFixInternalTransitions took out of the internal states               */
+
+static score_t zGetDurationFix(zPairTrellis *trellis, int state) {
+	zHMM *hmm = trellis->hmm;
+
+	if (hmm->state[state].type != INTERNAL && hmm->state[state].type != GINTERNAL) return 0;
+	return zScoreDurationGroup(hmm->dmap[hmm->state[state].duration], 1, trellis->genomic->gc);
+}
+
+static void zSetPercentIdentity(zHMM *hmm, zAlnFeature *af) {
+	if (zIsMatch(hmm->state[af->state].name)) { 
+		coor_t iterator, matches = 0;
+		for (iterator = 0; iterator < af->length; iterator++) {
+			/* add 1 since it is not a fully closed interval */
+			if (zGetDNAS5(af->genomic, af->genomic_start + 1 + iterator) == zGetDNAS5(af->cdna, af->cdna_start + 1 + iterator)) {
+				matches++;
+			}
+		}
+		af->percent_identity = (100*matches/af->length);
+	} else {
+		af->percent_identity = 0.0;
+	}
+}
+
 static void zTracePartialPairTrellis(zPairTrellis *trellis, coor_t g_begin, coor_t g_end, coor_t c_begin, coor_t c_end, int state, zAFVec *afv) {
 	zHMM *hmm = trellis->hmm;
 	int trace, max_state, max_state_bak;
@@ -769,9 +1549,7 @@ static void zTracePartialPairTrellis(zPairTrellis *trellis, coor_t g_begin, coor
 		score = zGetCurrentCell(trellis, g_current, c_current, state)->score;
 
 		/* Add back the exit probabilities since it had been fixed by zFixInternalTransitions() */
-		if (hmm->state[state].type == INTERNAL || hmm->state[state].type == GINTERNAL) {
-			score += zScoreDurationGroup(hmm->dmap[hmm->state[state].duration], 1, trellis->genomic->gc);
-		}
+		score += zGetDurationFix(trellis, state);
 
 		/* MANI now removing initial probabilities from output for the LAST state and transition probabilities for the others */
 		if (g_current == g_end && c_current == c_end) {
@@ -788,6 +1566,7 @@ static void zTracePartialPairTrellis(zPairTrellis *trellis, coor_t g_begin, coor
 		}
 
 		/* Remove previous state's score */
+		if (trellis->checkpoints != NULL) zRefillCheckpointSegment(trellis, genomic_start);
 		score -= zGetCurrentCell(trellis, genomic_start, cdna_start, trace)->score;
 
 		zClearAlnFeature(&af);
@@ -833,19 +1612,7 @@ static void zTracePartialPairTrellis(zPairTrellis *trellis, coor_t g_begin, coor
 		 * begin and end coordinates are printed out for this state.
 		 *********************************************************************/
 
-		if (zIsMatch(hmm->state[state].name)) { 
-			coor_t iterator, matches = 0;
-			for (iterator = 0; iterator < af.length; iterator++) {
-				/* add 1 since it is not a fully closed interval */
-				if (zGetDNAS5(af.genomic, af.genomic_start + 1 + iterator) == zGetDNAS5(af.cdna, af.cdna_start + 1 + iterator)) {
-					matches++;
-				}
-			}
-			af.percent_identity = (100*matches/af.length);
-		} else {
-			af.percent_identity = 0.0;
-		}
-
+		zSetPercentIdentity(hmm, &af);
 		zPushAFVec(afv, &af);
 
 		g_current = genomic_start;
@@ -915,103 +1682,731 @@ static void zQuickTracePartialTrellis(zPairTrellis *trellis, coor_t g_begin, coo
   Backward Probabilities
 \*********************************************/
 
-void zStartAlignmentBackward(zPairTrellis *trellis, coor_t gpos, coor_t cpos) {
+/* The backward pass runs over the cells the forward pass filled, the other *
+ * way round: each cell passes its backward score on to the cells its      *
+ * jumps came from (see zInternalPairTransBack), so a cell has all of it    *
+ * once every cell after it in genomic and cdna order is done. Cells the    *
+ * forward pass did not reach, outside of a band for one, pass nothing on.  */
+
+static void zStartAlignmentBackward(zPairTrellis *trellis, coor_t gpos, coor_t cpos) {
 	int     state;
 	for (state = 0; state < trellis->hmm->states; state++) {
-		if (trellis->backward != NULL) trellis->backward[gpos][cpos][state] = zGetInitProb(trellis->hmm, state, trellis->iiso_group);
+		trellis->backward[gpos][cpos][state] = zGetInitProb(trellis->hmm, state, trellis->iiso_group);
 	}
 }
 
-void zFinishAlignmentBackward(zPairTrellis *trellis, coor_t gpos, coor_t cpos) {
-	int state;
+/* The first cell of a state that zStartAlignmentForward filled takes no jumps, *
+ * its score comes from the initial probability at (gpos, cpos) alone           */
+
+static bool zGetFirstCell(zPairTrellis *trellis, coor_t gpos, coor_t cpos, int state, coor_t *genomic, coor_t *cdna, score_t *emission) {
+	zHMM *hmm = trellis->hmm;
+
+	*genomic  = gpos + zGetGenomicIncrement(hmm, state);
+	*cdna     = cpos + zGetCDnaIncrement(hmm, state);
+	*emission = zGetScannerScore(trellis, trellis->scanner[hmm->state[state].model], state, *genomic, *cdna);
+	return zGetFixedInitProb(hmm, state, trellis->iiso_group, trellis->genomic->gc) + *emission > MIN_SCORE;
+}
+
+static void zFinishAlignmentBackward(zPairTrellis *trellis, coor_t gpos, coor_t cpos) {
+	int     state;
+	coor_t  genomic, cdna;
+	score_t emission;
+
 	trellis->backward_score = MIN_SCORE;
 	for (state = 0; state < trellis->hmm->states; state++) {
 		score_t score  = zGetFixedInitProb(trellis->hmm, state, trellis->iiso_group, trellis->genomic->gc);
-		trellis->backward_score = zFloatwiseScoreAdd(trellis->backward[gpos][cpos][state]+score, trellis->forward_score);
+		if (zGetFirstCell(trellis, gpos, cpos, state, &genomic, &cdna, &emission)) {
+			trellis->backward[gpos][cpos][state] = zLogAddScore(emission + trellis->backward[genomic][cdna][state], trellis->backward[gpos][cpos][state]);
+		}
+		trellis->backward_score = zLogAddScore(trellis->backward[gpos][cpos][state]+score, trellis->backward_score);
+	}
+}
+
+/* cdna ranges of row genomic within [cmin, cmax] that some alignment block *
+ * covers, merged and highest first. Returns the number of ranges           */
+
+static int zGetPairBlockRanges(zPairTrellis *trellis, coor_t genomic, coor_t gmin, coor_t cmin, coor_t cmax, coor_t *lo, coor_t *hi) {
+	int    i, j, ranges = 0;
+	coor_t l, h;
+
+	for (i = 0; i < trellis->blocks->hsps; i++) {
+		zHSP *hsp = &trellis->blocks->hsp[i];
+		if (genomic < MAX(hsp->g_start, gmin) || genomic > hsp->g_end) continue;
+		l = MAX(hsp->c_start, cmin);
+		h = MIN(hsp->c_end, cmax);
+		if (h < l) continue;
+		for (j = ranges; j > 0 && lo[j-1] < l; j--) {
+			lo[j] = lo[j-1];
+			hi[j] = hi[j-1];
+		}
+		lo[j] = l;
+		hi[j] = h;
+		ranges++;
+	}
+	for (i = 0, j = 1; j < ranges; j++) {
+		if (hi[j] + 1 >= lo[i]) {
+			lo[i] = lo[j];
+			hi[i] = MAX(hi[i], hi[j]);
+		} else {
+			i++;
+			lo[i] = lo[j];
+			hi[i] = hi[j];
+		}
 	}
+	return (ranges == 0) ? 0 : i + 1;
 }
 
-static void zRunPartialPairBackward(zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend) {
+/* Cells cstart..cend of row genomic. Jumps into states that stay on the row    *
+ * go first, cdna descending; the rest only reach earlier rows and are summed a *
+ * row at a time, see zLogAddScores and zExplicitPairTransBackRow               */
+
+static void zRunPartialPairBackward(zPairTrellis *trellis, coor_t genomic, coor_t cstart, coor_t cend, score_t *sum, score_t *add) {
 	zHMM         *hmm = trellis->hmm;
-	coor_t        genomic, cdna; /* iterators for sequence */
+	coor_t        cdna;          /* iterator for sequence */
 	int           state;         /* iterator for internal states */
-	int           next;          /* iterator for next states */
-	zIVec*        fjumps;
-
-	/* induction */
-	zTrace2("beginning induction");
+	int           prev;          /* iterator for previous states */
+	zIVec*        jumps;
 
-	/* Make sure that all the required blocks are loaded */
-	zCheckBackwardVariables(trellis, gstart, cstart);
-	zTrace2("Calling (%u, %u) (%u, %u)", gstart, cstart, gend, cend);
-	for (genomic = gend; genomic >= gstart; genomic--) {
-		for (cdna = cend; cdna >= cstart; cdna--) {
-			for (state = 0; state < hmm->states; state++) {
-				fjumps = hmm->fmap[state];
-				for (next = 0; next < fjumps->size; next++) {
-					zGetPairBackTransFunc(hmm->state[state].type)
-						(trellis, state, fjumps->elem[next], genomic, cdna);
-				}
+	for (cdna = cend + 1; cdna-- > cstart; ) {
+		for (state = 0; state < hmm->states; state++) {
+			if (zGetGenomicIncrement(hmm, state) > 0) continue;
+			if (trellis->forward[genomic][cdna][state] == MIN_SCORE) continue;
+			jumps = hmm->jmap[state];
+			for (prev = 0; prev < jumps->size; prev++) {
+				zGetPairBackTransFunc(hmm->state[state].type)
+					(trellis, jumps->elem[prev], state, genomic, cdna);
+			}
+		}
+	}
+	for (state = 0; state < hmm->states; state++) {
+		if (zGetGenomicIncrement(hmm, state) == 0) continue;
+		jumps = hmm->jmap[state];
+		if (EXPLICIT != hmm->state[state].type) {
+			for (prev = 0; prev < jumps->size; prev++) {
+				zInternalPairTransBackRow(trellis, jumps->elem[prev], state, genomic, cstart, cend, sum, add);
+			}
+			continue;
+		}
+		if (zGetCDnaIncrement(hmm, state) == 0 && trellis->scanner[hmm->state[state].model]->model->seq_type == GENOMIC) {
+			for (prev = 0; prev < jumps->size; prev++) {
+				zExplicitPairTransBackRow(trellis, jumps->elem[prev], state, genomic, cstart, cend, add);
+			}
+			continue;
+		}
+		for (cdna = cstart; cdna <= cend; cdna++) {
+			if (trellis->forward[genomic][cdna][state] == MIN_SCORE) continue;
+			for (prev = 0; prev < jumps->size; prev++) {
+				zGetPairBackTransFunc(hmm->state[state].type)
+					(trellis, jumps->elem[prev], state, genomic, cdna);
 			}
 		}
 	}
 }
 
-void zRunPairBackward (zPairTrellis *trellis) {
-	zDNA         *cdna = trellis->cdna;
-	zDNA         *genomic = trellis->genomic;
+/* Needs the forward values of zRunPairViterbiAndForward with trellis->posteriors. *
+ * The rows are summed from the end of the alignment back, and the forward and    *
+ * backward values of a memory block go once the sweep is lookback rows past it,  *
+ * so what is read of them later is taken on the way: the posteriors of the       *
+ * features of path (NULL for none), see zTakePairPathPosteriors, and with        *
+ * trellis->mea_threshold the cells for zRunPairPosteriorDecoding, see            *
+ * zPairSparseCells, and given a path what zComputePosteriorProbability reads of  *
+ * them for the one it finds. The Viterbi cells go first, the path is traced      */
 
-	int           i;
-	coor_t        gmin, cmin, gmax, cmax;
+void zRunPairBackward (zPairTrellis *trellis, zAFVec *path) {
+	zHMM         *hmm = trellis->hmm;
+	coor_t        gmin, cmin, gmax, cmax, lookback, top;
+	coor_t        genomic, cdna, *lo, *hi;
+	score_t      *sum, *add, *first, *exit = NULL, emission;
+	int           state, r, ranges, live;
 
-	gmin = trellis->padding - 1;
-	cmin = trellis->padding - 1;
-	gmax = genomic->length - 1 - trellis->padding;
-	cmax = cdna->length - 1 - trellis->padding;
-	 	 
-	/* 	Viterbi and Forward Alg initialization */
+	if (trellis->forward == NULL) zDie("zRunPairBackward needs the forward values, set trellis->posteriors");
+	zGetPairAlignmentEnds(trellis, &gmin, &cmin, &gmax, &cmax);
+	zFreeViterbiVars(trellis);
+	zFreeSparseCells(trellis);
+	if (trellis->mea_threshold > 0) zInitSparseCells(trellis, path != NULL);
 
+	/* Rows are allocated as the jumps that end on the sweep reach them */
+	lookback = zGetPairLookback(hmm);
 	zAllocBackwardVars(trellis);
-	zCheckBackwardVariables(trellis, gmax, cmax);
-
-	/* induction - first pass */
+	zCheckBackwardVariables(trellis, MAX(gmax, trellis->window_start + lookback) - lookback, 0);
+	zStartAlignmentBackward(trellis, gmax, cmax);
+
+	/* First cells pass nothing on to the start here, zFinishAlignmentBackward *
+	 * does that, so their forward values are out of the way until then. So   *
+	 * are the posteriors of their rows, up to top                            */
+	first = zMalloc(hmm->states*sizeof(score_t), "zRunPairBackward first");
+	top   = gmin;
+	for (state = 0; state < hmm->states; state++) {
+		first[state] = MIN_SCORE;
+		if (!zGetFirstCell(trellis, gmin, cmin, state, &genomic, &cdna, &emission)) continue;
+		first[state] = trellis->forward[genomic][cdna][state];
+		trellis->forward[genomic][cdna][state] = MIN_SCORE;
+		top = MAX(top, genomic);
+	}
 
-	zTrace2("beginning first induction");
-	zStartAlignmentBackward(trellis, gmax + 1, cmax + 1);
+	lo  = zMalloc(trellis->blocks->hsps*sizeof(coor_t), "zRunPairBackward lo");
+	hi  = zMalloc(trellis->blocks->hsps*sizeof(coor_t), "zRunPairBackward hi");
+	sum = zMalloc(MAX(cmax - cmin + 1, lookback)*sizeof(score_t), "zRunPairBackward sum");
+	add = zMalloc(MAX(cmax - cmin + 1, lookback)*sizeof(score_t), "zRunPairBackward add");
+	if (path != NULL) exit = zMalloc(path->size*sizeof(score_t), "zRunPairBackward exit");
+	live = trellis->mem_blocks->hsps - 1;
+	for (genomic = gmax + 1; genomic-- > gmin; ) {
+		zCheckBackwardVariables(trellis, MAX(genomic, trellis->window_start + lookback) - lookback, 0);
+		ranges = zGetPairBlockRanges(trellis, genomic, gmin, cmin, cmax, lo, hi);
+		for (r = 0; r < ranges; r++) {
+			zRunPartialPairBackward(trellis, genomic, lo[r], hi[r], sum, add);
+		}
+		if (genomic <= top) continue;
+		if (path != NULL) zTakePairPathPosteriors(trellis, path, genomic, exit);
+		if (trellis->sparse != NULL) zCollectSparseRow(trellis, genomic, lo, hi);
+		while (live > 0 && trellis->mem_blocks->hsp[live].g_start > genomic + lookback) {
+			zFreePosteriorBlock(trellis, live--);
+		}
+	}
 
-	zTrace2("running viterbi");
-	for (i = trellis->blocks->hsps - 1; i >= 0; i--) {
-		zHSP *hsp = &trellis->blocks->hsp[i];
-		zRunPartialPairBackward(trellis, hsp->g_start, hsp->g_end, hsp->c_start, hsp->c_end);
+	for (state = 0; state < hmm->states; state++) {
+		if (!zGetFirstCell(trellis, gmin, cmin, state, &genomic, &cdna, &emission)) continue;
+		trellis->forward[genomic][cdna][state] = first[state];
 	}
 	zFinishAlignmentBackward(trellis, gmin, cmin);
-fprintf(stdout, "backward: %f\n", (trellis->backward_score));
+	zTrace2("forward %f, backward %f", trellis->forward_score, trellis->backward_score);
+	for (genomic = top + 1; genomic-- > gmin; ) {
+		if (path != NULL) zTakePairPathPosteriors(trellis, path, genomic, exit);
+		if (trellis->sparse != NULL) zCollectSparseRow(trellis, genomic, lo, hi);
+	}
+	if (trellis->sparse != NULL) {
+		if (trellis->sparse->posteriors) trellis->sparse->start = zPushSparseForward(trellis->sparse, trellis->forward[gmin][cmin], hmm->states);
+		zFinishSparseCells(trellis->sparse);
+	}
+	zFreeForwardVars(trellis);
+	zFreeBackwardVars(trellis);
+
+	zFree(first);
+	zFree(lo);
+	zFree(hi);
+	zFree(sum);
+	zFree(add);
+	if (exit != NULL) zFree(exit);
 }
 
 /*********************************************\
   Posterior Probability
 \*********************************************/
 
+/* Whether (genomic, cdna) lies in an alignment block, and so has a forward value */
+
+static bool zInPairAlignmentBlock(zPairTrellis *trellis, coor_t genomic, coor_t cdna) {
+	int i;
+	for (i = 0; i < trellis->blocks->hsps; i++) {
+		zHSP *hsp = &trellis->blocks->hsp[i];
+		if (genomic >= hsp->g_start && genomic <= hsp->g_end && cdna >= hsp->c_start && cdna <= hsp->c_end) return true;
+	}
+	return false;
+}
+
+/* Backward score of (genomic, cdna) in state for the paths that go on in some other state */
+
+static score_t zGetPairExitScore(zPairTrellis *trellis, int state, coor_t genomic, coor_t cdna, coor_t gmax, coor_t cmax) {
+	zHMM          *hmm   = trellis->hmm;
+	zIVec         *jumps = hmm->fmap[state];
+	score_t        exit  = MIN_SCORE, tscore, scan_score;
+	coor_t         g, c, length, steps;
+	zDistribution *d = NULL;
+	zScanner      *scanner;
+	int            next, n, gincrement, cincrement;
+
+	for (n = 0; n < jumps->size; n++) {
+		next = jumps->elem[n];
+		if (next == state) continue;
+		gincrement = zGetGenomicIncrement(hmm, next);
+		cincrement = zGetCDnaIncrement(hmm, next);
+		scanner    = trellis->scanner[hmm->state[next].model];
+		tscore     = zGetTransitionScore(hmm, state, next, trellis->tiso_group);
+		steps      = 1;
+		if (EXPLICIT == hmm->state[next].type) {
+			d     = &hmm->dmap[hmm->state[next].duration]->duration[0].distribution[0];
+			steps = d->end - d->start + 1;
+		}
+		scan_score = 0.;
+		for (length = 1, g = genomic + gincrement, c = cdna + cincrement;
+		     length <= steps && g <= gmax && c <= cmax && zInPairAlignmentBlock(trellis, g, c);
+		     length++, g += gincrement, c += cincrement) {
+			scan_score += zGetScannerScore(trellis, scanner, next, g, c);
+			if (trellis->forward[g][c][next] == MIN_SCORE) continue;
+			if (EXPLICIT == hmm->state[next].type) {
+				exit = zLogAddScore(tscore + zScoreDistribution(d, length) + scan_score + trellis->backward[g][c][next], exit);
+			} else {
+				exit = zLogAddScore(tscore + scan_score + trellis->backward[g][c][next], exit);
+			}
+		}
+	}
+	return exit;
+}
+
+/* Forward score of the paths into the first cell of feature f from another  *
+ * state, or from the start if it is the first one, from the forward values *
+ * of all states where it starts                                             */
+
+static score_t zGetPairEntryScore(zPairTrellis *trellis, zAlnFeature *f, const score_t *forward, bool first) {
+	zHMM        *hmm = trellis->hmm;
+	zIVec       *jumps = hmm->jmap[f->state];
+	score_t      entry = MIN_SCORE;
+	int          j;
+
+	if (first) return forward[f->state];
+	for (j = 0; j < jumps->size; j++) {
+		if (jumps->elem[j] == f->state) continue;
+		entry = zLogAddScore(forward[jumps->elem[j]]
+		                     + zGetTransitionScore(hmm, jumps->elem[j], f->state, trellis->tiso_group), entry);
+	}
+	return entry;
+}
+
+/* Backward score of the paths out of the last cell of feature i of path, into *
+ * another state or to the end                                                 */
+
+static score_t zGetPairFeatureExit(zPairTrellis *trellis, zAFVec *path, int i) {
+	zAlnFeature *f = &path->elem[i];
+	coor_t       gmin, cmin, gmax, cmax;
+
+	if (i == path->size - 1) return zGetInitProb(trellis->hmm, f->state, trellis->iiso_group);
+	zGetPairAlignmentEnds(trellis, &gmin, &cmin, &gmax, &cmax);
+	return zGetPairExitScore(trellis, f->state, f->genomic_end, f->cdna_end, gmax, cmax);
+}
+
+/* Posterior probability of a feature, the chance that the alignment has its *
+ * state over exactly its cells: every way into the first cell from another  *
+ * state, the scores of the feature, and every way out of the last cell into *
+ * another state. The scores are taken from the feature, so it may come from *
+ * zRunPairPosteriorDecoding too                                             */
+
+static void zSetPairPosterior(zPairTrellis *trellis, zAlnFeature *f, score_t entry, score_t exit) {
+	score_t segment = f->score - zGetDurationFix(trellis, f->state);
+	score_t p       = zScore2Float(entry + segment + exit - trellis->forward_score);
+
+	f->posterior = MIN(p, 1.0);
+}
+
+/* The posteriors of the features of path that start on row genomic, once the *
+ * backward sweep is done with it. A feature's exit is taken on the row it     *
+ * ends on, which the sweep reaches first, and kept in exit until then         */
+
+static void zTakePairPathPosteriors(zPairTrellis *trellis, zAFVec *path, coor_t genomic, score_t *exit) {
+	zAlnFeature *f;
+	int          i;
+
+	for (i = path->size; i-- > 0; ) {
+		f = &path->elem[i];
+		if (f->genomic_end == genomic) exit[i] = zGetPairFeatureExit(trellis, path, i);
+		if (f->genomic_start != genomic) continue;
+		zSetPairPosterior(trellis, f, zGetPairEntryScore(trellis, f, trellis->forward[f->genomic_start][f->cdna_start], i == 0), exit[i]);
+	}
+}
+
+
+/*********************************************\
+  Maximum Expected Accuracy Decoding
+\*********************************************/
+
+static int zFindSparseCell(zPairSparseCells *sparse, coor_t genomic, coor_t cdna, int state) {
+	zPairSparseCell *cell;
+	int              lo, hi, mid;
+
+	if (genomic < sparse->gmin || genomic > sparse->gmax) return -1;
+	lo = sparse->row[genomic - sparse->gmin];
+	hi = sparse->row[genomic - sparse->gmin + 1];
+	while (lo < hi) {
+		mid  = (lo + hi)/2;
+		cell = &sparse->cell[mid];
+		if (cell->cdna < cdna || (cell->cdna == cdna && cell->state < state)) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (lo == sparse->row[genomic - sparse->gmin + 1]) return -1;
+	cell = &sparse->cell[lo];
+	return (cell->cdna == cdna && cell->state == state) ? lo : -1;
+}
+
+static void zRelaxSparseCell(zPairSparseCells *sparse, int k, int from, coor_t length, double gain) {
+	zPairSparseCell *cell = &sparse->cell[k];
+
+	if (from >= 0) {
+		if (sparse->cell[from].gain < 0) return;
+		gain += sparse->cell[from].gain;
+	}
+	if (gain > cell->gain) {
+		cell->gain   = gain;
+		cell->prev   = from;
+		cell->length = length;
+	}
+}
+
+/* Posterior of an explicit state over exactly the length cells up to     *
+ * (genomic, cdna), from every state before it, as zExplicitPairTrans adds *
+ * the lengths up. scan_score holds the emissions of the shorter lengths   */
+
+static score_t zGetExplicitPosterior(zPairTrellis *trellis, int state, coor_t genomic, coor_t cdna, coor_t length, score_t *scan_score) {
+	zHMM          *hmm   = trellis->hmm;
+	zIVec         *jumps = hmm->jmap[state];
+	zScanner      *scanner = trellis->scanner[hmm->state[state].model];
+	zDistribution *d     = &hmm->dmap[hmm->state[state].duration]->duration[0].distribution[0];
+	int            gincrement = zGetGenomicIncrement(hmm, state);
+	int            cincrement = zGetCDnaIncrement(hmm, state);
+	coor_t         gmin  = genomic - length*gincrement, cmin = cdna - length*cincrement, i, j;
+	score_t        entry = MIN_SCORE, dscore;
+	int            n;
+
+	for (i = gmin+1, j = cmin+1; i <= gmin + gincrement; i+=gincrement, j+=cincrement) {
+		*scan_score += zGetScannerScore(trellis, scanner, state, i, j);
+	}
+	dscore = zScoreDistribution(d, length);
+	if (!(dscore > MIN_SCORE) || !zInPairAlignmentBlock(trellis, gmin, cmin)) return 0;
+	for (n = 0; n < jumps->size; n++) {
+		if (trellis->forward[gmin][cmin][jumps->elem[n]] == MIN_SCORE) continue;
+		entry = zLogAddScore(trellis->forward[gmin][cmin][jumps->elem[n]]
+		                     + zGetTransitionScore(hmm, jumps->elem[n], state, trellis->tiso_group), entry);
+	}
+	if (entry == MIN_SCORE) return 0;
+	return zScore2Float(entry + dscore + *scan_score + trellis->backward[genomic][cdna][state] - trellis->forward_score);
+}
+
+static int zPushSparseForward(zPairSparseCells *sparse, const score_t *forward, int states) {
+	if (sparse->positions == sparse->position_limit) {
+		sparse->position_limit = (sparse->position_limit == 0) ? 1024 : 2*sparse->position_limit;
+		sparse->forward = zRealloc(sparse->forward, sparse->position_limit*states*sizeof(score_t), "zPushSparseForward forward");
+	}
+	memcpy(&sparse->forward[sparse->positions*states], forward, states*sizeof(score_t));
+	return sparse->positions++;
+}
+
+static zPairSparseCell* zPushSparseCell(zPairSparseCells *sparse, coor_t genomic, coor_t cdna, int state, float posterior) {
+	zPairSparseCell *cell;
+
+	if (sparse->size == sparse->limit) {
+		sparse->limit = (sparse->limit == 0) ? 1024 : 2*sparse->limit;
+		sparse->cell  = zRealloc(sparse->cell, sparse->limit*sizeof(zPairSparseCell), "zPushSparseCell cell");
+	}
+	cell = &sparse->cell[sparse->size++];
+	cell->genomic   = genomic;
+	cell->cdna      = cdna;
+	cell->state     = state;
+	cell->prev      = -1;
+	cell->length    = 0;
+	cell->posterior = posterior;
+	cell->gain      = -1;
+	cell->span      = -1;
+	cell->forward   = -1;
+	cell->exit      = MIN_SCORE;
+	return cell;
+}
+
+/* The posteriors of the lengths 1..steps of an explicit state up to the cell, *
+ * 0 for those that would start before the alignment does                     */
+
+static void zPushSparseSpan(zPairTrellis *trellis, zPairSparseCell *cell, coor_t gmin, coor_t cmin) {
+	zHMM             *hmm    = trellis->hmm;
+	zPairSparseCells *sparse = trellis->sparse;
+	zDistribution    *d      = &hmm->dmap[hmm->state[cell->state].duration]->duration[0].distribution[0];
+	int               steps  = d->end - d->start + 1;
+	int               gincrement = zGetGenomicIncrement(hmm, cell->state);
+	int               cincrement = zGetCDnaIncrement(hmm, cell->state);
+	score_t           scan_score = 0.;
+	coor_t            length;
+
+	while (sparse->spans + steps > sparse->span_limit) {
+		sparse->span_limit = (sparse->span_limit == 0) ? 1024 : 2*sparse->span_limit;
+		sparse->span       = zRealloc(sparse->span, sparse->span_limit*sizeof(float), "zPushSparseSpan span");
+	}
+	cell->span = sparse->spans;
+	sparse->spans += steps;
+	for (length = 1; length <= (coor_t)steps; length++) {
+		sparse->span[cell->span + length - 1] = 0;
+		if (cell->genomic < gmin + length*gincrement || cell->cdna < cmin + length*cincrement) continue;
+		sparse->span[cell->span + length - 1] = zGetExplicitPosterior(trellis, cell->state, cell->genomic, cell->cdna, length, &scan_score);
+	}
+}
+
+/* The cells of row genomic with a posterior of trellis->mea_threshold or  *
+ * more, last first, once zRunPairBackward is done with the row; lo and hi *
+ * are scratch, see zGetPairBlockRanges                                    */
+
+static void zCollectSparseRow(zPairTrellis *trellis, coor_t genomic, coor_t *lo, coor_t *hi) {
+	zHMM             *hmm    = trellis->hmm;
+	zPairSparseCells *sparse = trellis->sparse;
+	zPairSparseCell  *cell;
+	coor_t            gmin, cmin, gmax, cmax, cdna;
+	score_t           f, b, p;
+	int               state, r, ranges, position;
+
+	zGetPairAlignmentEnds(trellis, &gmin, &cmin, &gmax, &cmax);
+	ranges = zGetPairBlockRanges(trellis, genomic, gmin, cmin, cmax, lo, hi);
+	for (r = 0; r < ranges; r++) {
+		for (cdna = hi[r] + 1; cdna-- > lo[r]; ) {
+			if (genomic == gmin && cdna == cmin) continue; /* the start is in no state */
+			position = -1;
+			for (state = hmm->states; state-- > 0; ) {
+				f = trellis->forward[genomic][cdna][state];
+				b = trellis->backward[genomic][cdna][state];
+				if (f == MIN_SCORE || b == MIN_SCORE) continue;
+				p = zScore2Float(f + b - trellis->forward_score);
+				if (p < trellis->mea_threshold) continue;
+				cell = zPushSparseCell(sparse, genomic, cdna, state, MIN(p, 1.0));
+				if (sparse->posteriors) {
+					if (position < 0) position = zPushSparseForward(sparse, trellis->forward[genomic][cdna], hmm->states);
+					cell->forward = position;
+					cell->exit    = zGetPairExitScore(trellis, state, genomic, cdna, gmax, cmax);
+				}
+				if (EXPLICIT == hmm->state[state].type) zPushSparseSpan(trellis, cell, gmin, cmin);
+			}
+		}
+	}
+	sparse->row[genomic - gmin] = sparse->size; /* see zFinishSparseCells */
+}
+
+/* Turn the cells zCollectSparseRow pushed, the last row first, round */
+
+static void zFinishSparseCells(zPairSparseCells *sparse) {
+	zPairSparseCell  swap;
+	int              i, rows = sparse->gmax - sparse->gmin + 1;
+
+	for (i = 0; i < sparse->size/2; i++) {
+		swap                                = sparse->cell[i];
+		sparse->cell[i]                     = sparse->cell[sparse->size - 1 - i];
+		sparse->cell[sparse->size - 1 - i] = swap;
+	}
+	for (i = 0; i < rows; i++) sparse->row[i] = sparse->size - sparse->row[i];
+	sparse->row[rows] = sparse->size;
+}
+
+static void zInitSparseCells(zPairTrellis *trellis, bool posteriors) {
+	zPairSparseCells *sparse = zMalloc(sizeof(zPairSparseCells), "zInitSparseCells");
+	coor_t            gmin, cmin, gmax, cmax;
+
+	zGetPairAlignmentEnds(trellis, &gmin, &cmin, &gmax, &cmax);
+	sparse->gmin           = gmin;
+	sparse->gmax           = gmax;
+	sparse->row            = zMalloc((gmax - gmin + 2)*sizeof(int), "zInitSparseCells row");
+	sparse->cell           = NULL;
+	sparse->size           = 0;
+	sparse->limit          = 0;
+	sparse->span           = NULL;
+	sparse->spans          = 0;
+	sparse->span_limit     = 0;
+	sparse->posteriors     = posteriors;
+	sparse->forward        = NULL;
+	sparse->positions      = 0;
+	sparse->position_limit = 0;
+	sparse->start          = -1;
+	trellis->sparse        = sparse;
+}
+
+static void zFreeSparseCells(zPairTrellis *trellis) {
+	zPairSparseCells *sparse = trellis->sparse;
+
+	if (sparse == NULL) return;
+	zFree(sparse->row);
+	zFree(sparse->cell);
+	zFree(sparse->span);
+	zFree(sparse->forward);
+	zFree(sparse);
+	trellis->sparse = NULL;
+}
+
+/* Best path through the sparse cells, every cell it covers gaining the    *
+ * posterior of its state there. The jumps are those of the Viterbi sweep, *
+ * between cells that are both sparse; the cells of an explicit state gain *
+ * the posterior of the length it takes                                    */
+
+static void zRunSparseMEA(zPairTrellis *trellis, zPairSparseCells *sparse) {
+	zHMM            *hmm = trellis->hmm;
+	zPairSparseCell *cell;
+	zDistribution   *d;
+	zIVec           *jumps;
+	coor_t           gmin, cmin, gmax, cmax, genomic, cdna, length, steps;
+	score_t          emission, p;
+	int              k, n, from, gincrement, cincrement;
+
+	zGetPairAlignmentEnds(trellis, &gmin, &cmin, &gmax, &cmax);
+	for (k = 0; k < sparse->size; k++) {
+		sparse->cell[k].prev   = -1;
+		sparse->cell[k].length = 0;
+		sparse->cell[k].gain   = -1;
+	}
+	for (k = 0; k < sparse->size; k++) {
+		cell = &sparse->cell[k];
+
+		/* the first cell of a state only follows the start, see zStartAlignmentForward */
+		if (zGetFirstCell(trellis, gmin, cmin, cell->state, &genomic, &cdna, &emission)
+			&& genomic == cell->genomic && cdna == cell->cdna) {
+			zRelaxSparseCell(sparse, k, -1, 1, cell->posterior);
+			continue;
+		}
+
+		gincrement = zGetGenomicIncrement(hmm, cell->state);
+		cincrement = zGetCDnaIncrement(hmm, cell->state);
+		jumps      = hmm->jmap[cell->state];
+		steps      = 1;
+		if (EXPLICIT == hmm->state[cell->state].type) {
+			d     = &hmm->dmap[hmm->state[cell->state].duration]->duration[0].distribution[0];
+			steps = d->end - d->start + 1;
+		}
+		for (length = 1; length <= steps; length++) {
+			if (cell->genomic < gmin + length*gincrement || cell->cdna < cmin + length*cincrement) break;
+			p = cell->posterior;
+			if (EXPLICIT == hmm->state[cell->state].type) {
+				p = sparse->span[cell->span + length - 1];
+				if (p <= 0) continue;
+			}
+			for (n = 0; n < jumps->size; n++) {
+				if (!(zGetTransitionScore(hmm, jumps->elem[n], cell->state, trellis->tiso_group) > MIN_SCORE)) continue;
+				from = zFindSparseCell(sparse, cell->genomic - length*gincrement, cell->cdna - length*cincrement, jumps->elem[n]);
+				if (from >= 0) zRelaxSparseCell(sparse, k, from, length, length*MIN(p, 1.0));
+			}
+		}
+	}
+}
+
+/* Features of the path that ends in sparse->cell[end], scored the way *
+ * zTracePartialPairTrellis scores those of the Viterbi path            */
+
+static zAFVec* zTraceSparseCells(zPairTrellis *trellis, zPairSparseCells *sparse, int end, score_t *path_score) {
+	zHMM            *hmm = trellis->hmm;
+	zPairSparseCell *cell;
+	zScanner        *scanner;
+	zDistribution   *d;
+	zAFVec          *afv;
+	zAlnFeature      af;
+	coor_t           gmin, cmin, gmax, cmax, genomic, cdna, g, c, length;
+	score_t          score;
+	int             *path, steps = 0, state, prev_state = -1, gincrement, cincrement, i, j, k;
+
+	for (k = end; k >= 0; k = sparse->cell[k].prev) steps++;
+	path = zMalloc(steps*sizeof(int), "zTraceSparseCells path");
+	for (k = end, i = steps - 1; k >= 0; k = sparse->cell[k].prev, i--) path[i] = k;
+
+	zGetPairAlignmentEnds(trellis, &gmin, &cmin, &gmax, &cmax);
+	afv = zMalloc(sizeof(zAFVec), "zTraceSparseCells afv");
+	zInitAFVec(afv, 1);
+	genomic     = gmin;
+	cdna        = cmin;
+	*path_score = zGetFixedInitProb(hmm, sparse->cell[path[0]].state, trellis->iiso_group, trellis->genomic->gc);
+
+	/* a feature is a run of cells in one state */
+	for (i = 0; i < steps; i = j) {
+		state = sparse->cell[path[i]].state;
+		for (j = i + 1; j < steps && sparse->cell[path[j]].state == state; j++);
+
+		gincrement = zGetGenomicIncrement(hmm, state);
+		cincrement = zGetCDnaIncrement(hmm, state);
+		scanner    = trellis->scanner[hmm->state[state].model];
+
+		zClearAlnFeature(&af);
+		af.genomic_start = genomic;
+		af.cdna_start    = cdna;
+		score  = 0;
+		length = 0;
+		for (k = i; k < j; k++) {
+			cell = &sparse->cell[path[k]];
+			if (EXPLICIT == hmm->state[state].type) {
+				d = &hmm->dmap[hmm->state[state].duration]->duration[0].distribution[0];
+				for (g = genomic + 1, c = cdna + 1; g <= cell->genomic; g += gincrement, c += cincrement) {
+					score += zGetScannerScore(trellis, scanner, state, g, c);
+				}
+				score += zScoreDistribution(d, cell->length);
+			} else {
+				score += zGetScannerScore(trellis, scanner, state, cell->genomic, cell->cdna);
+				if (k > i) score += zGetTransitionScore(hmm, state, state, trellis->tiso_group);
+			}
+			length += cell->length;
+			genomic = cell->genomic;
+			cdna    = cell->cdna;
+		}
+		if (prev_state >= 0) *path_score += zGetTransitionScore(hmm, prev_state, state, trellis->tiso_group);
+		*path_score += score;
+
+		af.name        = hmm->state[state].name;
+		af.state       = state;
+		af.strand      = hmm->state[state].strand;
+		af.genomic     = trellis->genomic;
+		af.genomic_end = genomic;
+		af.cdna        = trellis->cdna;
+		af.cdna_end    = cdna;
+		af.score       = score + zGetDurationFix(trellis, state);
+		af.padding     = trellis->padding;
+		af.length      = length*((gincrement > 0) ? gincrement : cincrement);
+		zSetPercentIdentity(hmm, &af);
+		zPushAFVec(afv, &af);
+		prev_state = state;
+	}
+	*path_score += zGetInitProb(hmm, prev_state, trellis->iiso_group);
+
+	zFree(path);
+	return afv;
+}
+
+/* Maximum expected accuracy alignment over the cells zRunPairBackward     *
+ * collected, those of posterior trellis->mea_threshold or more. Only those *
+ * cells are held, so a high threshold keeps it small. path_score is the    *
+ * log probability of the path, as Viterbi reports its own. NULL if no path *
+ * goes through such cells only                                             */
+
+zAFVec* zRunPairPosteriorDecoding (zPairTrellis *trellis, score_t *path_score) {
+	zHMM             *hmm = trellis->hmm;
+	zPairSparseCells *sparse = trellis->sparse;
+	zPairSparseCell  *cell;
+	zAFVec           *afv = NULL;
+	coor_t            gmin, cmin, gmax, cmax;
+	int               k, end = -1;
+
+	if (sparse == NULL) zDie("zRunPairPosteriorDecoding needs the cells zRunPairBackward collects with trellis->mea_threshold");
+	zGetPairAlignmentEnds(trellis, &gmin, &cmin, &gmax, &cmax);
+	zTrace2("%d cells of posterior %g or more", sparse->size, trellis->mea_threshold);
+	zRunSparseMEA(trellis, sparse);
+
+	for (k = sparse->row[gmax - gmin]; k < sparse->row[gmax - gmin + 1]; k++) {
+		cell = &sparse->cell[k];
+		if (cell->cdna != cmax || cell->gain < 0) continue;
+		if (!(zGetInitProb(hmm, cell->state, trellis->iiso_group) > MIN_SCORE)) continue;
+		if (end < 0 || cell->gain > sparse->cell[end].gain) end = k;
+	}
+	if (end >= 0) afv = zTraceSparseCells(trellis, sparse, end, path_score);
+	return afv;
+}
+
+/* Posteriors of the features of path, which goes through the cells          *
+ * zRunPairBackward collected given a path (that of zRunPairPosteriorDecoding *
+ * does). A feature starts where the one before ends, so the forward values   *
+ * of its entry and the exit of its last cell are those of sparse cells       */
+
 void zComputePosteriorProbability(zPairTrellis* trellis, zAFVec* path) {
-	int i, from;
-	zAlnFeature* f = &path->elem[0];
-	f->score += (trellis->backward[f->genomic_end][f->cdna_end][f->state]);
-	f->score -= trellis->forward_score;
-	f->score = 100*zScore2Float(f->score);
-zWriteAlnFeature(stdout, f, 0, 0);
-	for (i = 1; i < path->size - 1; i++) {
+	zHMM             *hmm    = trellis->hmm;
+	zPairSparseCells *sparse = trellis->sparse;
+	zAlnFeature      *f;
+	const score_t    *forward;
+	score_t           exit;
+	int               i, k;
+
+	if (sparse == NULL || !sparse->posteriors) zDie("zComputePosteriorProbability needs the cells zRunPairBackward collects with trellis->mea_threshold and a path");
+	for (i = 0; i < path->size; i++) {
 		f = &path->elem[i];
-		from = path->elem[i-1].state;
-		f->score += (trellis->forward[f->genomic_start][f->cdna_start][from] + zGetTransitionScore(trellis->hmm, from, f->state, trellis->tiso_group) + trellis->backward[f->genomic_end][f->cdna_end][f->state]);
-		f->score -= trellis->forward_score;
-		f->score = 100*zScore2Float(f->score);
-zWriteAlnFeature(stdout, f, 0, 0);
-	}
-	f = &path->elem[i];
-	from = path->elem[i-1].state;
-	f->score += (trellis->forward[f->genomic_end][f->cdna_start][from] + zGetTransitionScore(trellis->hmm, from, f->state, trellis->tiso_group));
-	f->score -= trellis->forward_score;
-	f->score = 100*zScore2Float(f->score);
+		if (i == 0) {
+			forward = &sparse->forward[sparse->start*hmm->states];
+		} else {
+			k = zFindSparseCell(sparse, f->genomic_start, f->cdna_start, path->elem[i-1].state);
+			if (k < 0) zDie("zComputePosteriorProbability: the path leaves the collected cells");
+			forward = &sparse->forward[sparse->cell[k].forward*hmm->states];
+		}
+		if (i == path->size - 1) {
+			exit = zGetInitProb(hmm, f->state, trellis->iiso_group);
+		} else {
+			k = zFindSparseCell(sparse, f->genomic_end, f->cdna_end, f->state);
+			if (k < 0) zDie("zComputePosteriorProbability: the path leaves the collected cells");
+			exit = sparse->cell[k].exit;
+		}
+		zSetPairPosterior(trellis, f, zGetPairEntryScore(trellis, f, forward, i == 0), exit);
+	}
 }
 
 /*********************************************\
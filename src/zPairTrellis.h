@@ -26,15 +26,156 @@ zPairTrellis.h - part of the ZOE library for genomic analysis
 #include "zStopSeq.h"
 #include "zTools.h"
 
+/* Built with -DCOMPACT_CELL the score is a float and a cell takes 8 bytes   *
+ * instead of 16. zSetCellScore rounds every score the same way at run time  *
+ * when trellis->compact is set, so a regular build can tell what the path   *
+ * of a compact one would be (see pairagon --verify_compact)                 */
+
+#ifdef COMPACT_CELL
+typedef float   cell_score_t;
+#define zSetCellScore(trellis, cell, s) ((cell)->score = (cell_score_t)(s))
+#else
+typedef score_t cell_score_t;
+#define zSetCellScore(trellis, cell, s) ((cell)->score = (trellis)->compact ? (score_t)(float)(s) : (s))
+#endif
+
 struct zPairTrellisCell {
 	/* Regular Viterbi */
-	score_t       score; 
+	cell_score_t  score; 
 	int           length:24;
 	int           trace:7;  /* 0 state index */
 	unsigned int  keep:1;
 };
 typedef struct zPairTrellisCell zPairTrellisCell;
 
+/******************************************************************************\
+ zPairTrellisArena
+
+One contiguous allocation per memory block. data holds the cells (or scores)
+for every (genomic, cdna) position of the block, states at a time, and rows
+holds the per-position pointers that trellis->cell[genomic][cdna] resolves to,
+so the zGetCurrentCell family of macros works unchanged. Garbage collection
+moves the few cells marked keep out of data and releases data as a whole.
+
+\******************************************************************************/
+
+struct zPairTrellisArena {
+	void   *rows;  /* pointers into data, one per (genomic, cdna) position */
+	void   *data;  /* NULL once the block has been garbage collected */
+};
+typedef struct zPairTrellisArena zPairTrellisArena;
+
+
+/******************************************************************************\
+ zPairCheckpoints
+
+Linear memory Viterbi for a trellis without a seed, which is one big block.
+The genomic rows are filled segment by segment and every segment but the last
+is dropped once the next one is done, except for its last lookback rows: the
+checkpoint the next segment was computed from. The traceback refills a segment
+from the checkpoint before it when the path enters it, so the alignment is the
+one the full trellis gives, while only O(sqrt(genomic)) rows are ever held.
+
+\******************************************************************************/
+
+struct zPairCheckpoints {
+	coor_t  first;     /* rows of the block */
+	coor_t  last;
+	coor_t  gstart;    /* cells the recurrence fills */
+	coor_t  cstart;
+	coor_t  cend;
+	coor_t  lookback;  /* rows the recurrence reads behind the current one */
+	coor_t  segment;   /* rows per segment, more than lookback */
+	int     live;      /* segment refilled for the traceback, -1 if none */
+};
+typedef struct zPairCheckpoints zPairCheckpoints;
+
+
+/******************************************************************************\
+ zPairSparseCells
+
+The (genomic, cdna, state) cells of a trellis whose posterior probability,
+forward + backward - forward_score, reaches a threshold, for the maximum
+expected accuracy decoding of zRunPairPosteriorDecoding. They are kept in
+genomic, cdna and state order, with row[g - gmin] the first cell of row g, so
+a cell is found by a binary search of its row, and every cell a path can come
+from is before it.
+
+zRunPairBackward collects them a row at a time, as its sweep is done with the
+row and before the forward and backward values of the row's memory block are
+freed, with what the decoding and the posteriors of the decoded path read of
+those values: the posterior of each length of an explicit state and, if the
+posteriors of the decoded path are wanted too, the forward values of every
+state at the cell and the exit score of the cell's state. The sweep runs from
+the end back, so the cells are pushed last first and turned round when it is
+done.
+
+\******************************************************************************/
+
+struct zPairSparseCell {
+	coor_t  genomic;
+	coor_t  cdna;
+	int     state;
+	int     prev;       /* cell the best path comes from, -1 for the start */
+	coor_t  length;     /* steps taken in state to get here from prev */
+	float   posterior;
+	double  gain;       /* expected accuracy of the best path, negative if none */
+	int     span;       /* posteriors of its lengths in span, -1 if not explicit */
+	int     forward;    /* forward values of all states at its cell in forward, or -1 */
+	score_t exit;       /* into another state, see zGetPairExitScore */
+};
+typedef struct zPairSparseCell zPairSparseCell;
+
+struct zPairSparseCells {
+	coor_t           gmin;
+	coor_t           gmax;
+	int             *row;   /* gmax - gmin + 2 offsets into cell */
+	zPairSparseCell *cell;
+	int              size;
+	int              limit;
+	float           *span;     /* one per length of an explicit state, see zGetExplicitPosterior */
+	int              spans;
+	int              span_limit;
+	bool             posteriors; /* forward and exit kept, see zComputePosteriorProbability */
+	score_t         *forward;  /* hmm states per cell position */
+	int              positions;
+	int              position_limit;
+	int              start;    /* the forward values of the start of the alignment */
+};
+typedef struct zPairSparseCells zPairSparseCells;
+
+
+/******************************************************************************\
+ zPairScannerCache
+
+The GENOMIC scanners of a trellis and the scores zPreComputeScanner fills them
+with only depend on the genomic sequence, the strand the HMM is set to and the
+start of the genomic window, where scanner->min_pos comes from. A trellis made
+with zInitCachedPairTrellis borrows them from the cache when an earlier one had
+the same three, so cDNAs of one locus pay for the genomic side once, and leaves
+the ones it makes in the cache for the trellises after it. The least recently
+used set goes when a new one needs room.
+
+\******************************************************************************/
+
+#define PAIR_SCANNER_SETS 4 /* both strands of two genomic windows */
+
+struct zPairScannerSet {
+	zDNA      *genomic;  /* NULL for an empty set */
+	strand_t   strand;
+	coor_t     gb_start;
+	int        features;
+	zScanner **scanner;  /* by model feature, GENOMIC models only */
+	long       used;     /* when it was last picked */
+};
+typedef struct zPairScannerSet zPairScannerSet;
+
+struct zPairScannerCache {
+	zPairScannerSet  set[PAIR_SCANNER_SETS];
+	long             uses;
+};
+typedef struct zPairScannerCache zPairScannerCache;
+
 
 /******************************************************************************\
  zPairTrellis
@@ -46,6 +187,7 @@ gene prediciton algorithms. A trellis contains a specific zDNA and zHMM.
 
 struct zPairTrellis {
 	zDNA             *genomic;
+	bool              own_genomic; /* false if genomic is borrowed, see zInitPairTrellis */
 	zDNA             *cdna; /* Placeholder for cdna sequence: no memory allocation involved */
 	zDNA             *fcdna; /* cdna */
 	zDNA             *rcdna; /* reverse complemented cdna */
@@ -63,9 +205,42 @@ struct zPairTrellis {
 	zSeedAlignment   *seed;
 	zSeedAlignment   *blocks;
 	zSeedAlignment   *mem_blocks;
+	zBlockIndex       mem_index;     /* lookups of mem_blocks */
 	int               allocated_mem_blocks;
+	int               collected_mem_blocks; /* mem_blocks below this are garbage collected */
 	int               allocated_fwd_blocks;
 	int               allocated_bak_blocks;
+	coor_t            window_start; /* genomic span covered by cell, forward and backward */
+	coor_t            window_end;
+
+	bool               arena;      /* allocate memory blocks as zPairTrellisArena */
+	zPairTrellisArena *cell_arena; /* indexed like mem_blocks->hsp */
+	zPairTrellisArena *fwd_arena;
+	zPairTrellisArena *bak_arena;
+	bool               wavefront;  /* relax anti-diagonals with zRunPairWavefront */
+	bool               specialize; /* fill with a generated kernel if one matches the HMM, see zPairKernel.h */
+	const struct zPairKernel *kernel; /* the one zRunPairViterbiAndForward picked, NULL for the generic code */
+	bool               splice_prune; /* skip the splice and branch point cells splice sites rule out, see zPairSplice.h */
+	struct zPairSpliceSites *splice_sites; /* of the HMM of the last zRunPairViterbiAndForward, or NULL */
+	int                tile_threads; /* threads that fill a block, see zPairTile.h */
+	struct zPairTiles *tiles;      /* while they do, or NULL */
+	score_t            beam;       /* zRunPairViterbi drops cells this far below the best of their genomic position, 0 keeps all */
+	bool               beam_retry; /* and decodes again without it if the path runs close to dropped cells */
+	long               beam_hits;  /* cells the last zRunPairViterbi dropped */
+	bool               beam_retried; /* and whether it decoded again */
+	coor_t             band;       /* initial half width of the band around seed HSPs, 0 fills whole blocks */
+	bool               checkpoint; /* without a seed or forward values, keep checkpoint rows only, see zPairCheckpoints */
+	bool               compact;    /* round cell scores to float, see zSetCellScore */
+	bool               posteriors; /* keep forward values for zRunPairBackward, see zComputePosteriorProbability */
+	score_t            mea_threshold; /* zRunPairBackward collects the cells of this posterior or more, 0 none */
+	zPairSparseCells  *sparse;     /* and keeps them here for zRunPairPosteriorDecoding */
+	zPairCheckpoints  *checkpoints;
+
+	/* s5 codes for the PAIR emissions, see zGetPairEmission */
+	coor_t             gcode_start; /* genomic position of gcode[0] */
+	coor_t             gcode_end;
+	char              *gcode;       /* genomic window, NULL without PAIR models */
+	char              *ccode;       /* all of cdna, padding included */
 
 	/* indexed by pos, pos and hmm state */
 	zPairTrellisCell  ***cell;      /* cell[state_idx][seq_pos] */
@@ -77,6 +252,7 @@ struct zPairTrellis {
 
 	/* indexed by zStrIdx */
 	zScanner        **scanner;   /* map hmm models to scanners here */
+	zPairScannerCache *scanner_cache; /* owns the GENOMIC scanners, NULL if the trellis does */
 
 	/* These are not used, but I left them there so someone might use them later */
 
@@ -98,7 +274,11 @@ typedef struct zPairTrellis zPairTrellis;
 \*********************************************/
 
 void    zInitPairTrellis (zPairTrellis*, zSeedAlignment*, zDNA*, zDNA*, zHMM*);
+void    zInitCachedPairTrellis (zPairTrellis*, zSeedAlignment*, zDNA*, zDNA*, zHMM*, zPairScannerCache*);
+void    zInitPairScannerCache (zPairScannerCache*);
+void    zFreePairScannerCache (zPairScannerCache*);
 void    zFreePairTrellis (zPairTrellis*);
+void    zReversePairTrellis (zPairTrellis*);
 
 /*********************************************\
  Regular Viterbi Decoding
@@ -106,8 +286,9 @@ void    zFreePairTrellis (zPairTrellis*);
 
 zAFVec* zRunPairViterbiAndForward (zPairTrellis*,score_t*);
 void    zTracePairTrellis (zPairTrellis*, int, zAFVec*);
-void    zRunPairBackward (zPairTrellis *trellis);
+void    zRunPairBackward (zPairTrellis *trellis, zAFVec *path);
 void    zComputePosteriorProbability(zPairTrellis* trellis, zAFVec* path);
+zAFVec* zRunPairPosteriorDecoding(zPairTrellis*, score_t*);
 
 /*********************************************\
  Functions for Evan's Memory Optimized Version
@@ -259,6 +259,15 @@ static void zInitPairViterbi(zViterbi* v,zPairTrellis* trellis){
 	v->next = NULL;
 	v->dead_count = -1;
 	v->active_count = -1;
+
+	v->beam_hits = 0;
+	v->beam_best = NULL;
+	if (trellis->beam > 0) {
+		v->beam_best = zMalloc(sizeof(score_t)*trellis->genomic->length, "zInitPairViterbi beam_best");
+		for (i = 0; i < (int)trellis->genomic->length; i++) {
+			v->beam_best[i] = MIN_SCORE;
+		}
+	}
 }
 
 static void zFreePairViterbi(zViterbi* v){
@@ -308,6 +317,10 @@ static void zFreePairViterbi(zViterbi* v){
 		zFreePtrList(v->traceback);
 		zFree(v->traceback);
 	}
+
+	if(v->beam_best != NULL){
+		zFree(v->beam_best);
+	}
 }
 
 /* sets all snps in the DNA seq for this allele */
@@ -463,8 +476,12 @@ static void zExtendState(zViterbi *viterbi, int allele, zPairTrellis *trellis, c
 	zTBTree        *tree          = &viterbi->tb[allele]->tbtree;
 	int             cache_index   = gpos%viterbi->cache_length;
 	zTBTreeNode    *previous_cell = cache[(gpos-zGetGenomicIncrement(hmm,to_state))%viterbi->cache_length][cpos-zGetCDnaIncrement(hmm,to_state)][from_state];
-	zTBTreeNode    *tbtn          = zGetTBTreeNode(tree);
-	if (previous_cell == NULL) zDie("Cannot extend to state=%d for (%u, %u)", to_state, gpos, cpos);
+	zTBTreeNode    *tbtn;
+	if (previous_cell == NULL || previous_cell->pruned) {
+		if (trellis->beam > 0) return; /* the beam dropped it */
+		zDie("Cannot extend to state=%d for (%u, %u)", to_state, gpos, cpos);
+	}
+	tbtn = zGetTBTreeNode(tree);
 
 	/* Get the score */
 	score =  zGetScannerScore(trellis,trellis->scanner[trellis->hmm->state[to_state].model],to_state,gpos,cpos);
@@ -582,6 +599,57 @@ static void zFinishAlignmentForward(zTBTreeNode ***cache, zPairTrellis *trellis,
 
 /* End Functions for initializing and finishing alignments */
 
+/* The beam: cells of genomic position viterbi->pos scoring more than     *
+ * trellis->beam below the best of them are marked pruned. Nothing extends *
+ * them from then on and the cleanup below releases them like dead cells. *
+ * The cells before the first and after the last cDNA base are left out,   *
+ * the unaligned genomic ends run through them and the one past the cDNA   *
+ * may hold all of it unaligned                                            */
+
+static bool zIsPairBeamCell(zPairTrellis *trellis, coor_t cdna_pos) {
+	return cdna_pos >= trellis->padding && cdna_pos + trellis->padding + 1 < trellis->cdna->length;
+}
+
+static void zPrunePairViterbiColumn(zViterbi *viterbi, zPairTrellis *trellis, zTBTreeNode ***column) {
+	int          state;
+	coor_t       cdna_pos;
+	score_t      best = MIN_SCORE, floor;
+	zTBTreeNode *tbtn;
+
+	for (cdna_pos = trellis->padding; zIsPairBeamCell(trellis, cdna_pos); cdna_pos++) {
+		for (state = 0; state < trellis->hmm->states; state++) {
+			tbtn = column[cdna_pos][state];
+			if (tbtn != NULL && tbtn->score > best) best = tbtn->score;
+		}
+	}
+	if (best == MIN_SCORE) return;
+	viterbi->beam_best[viterbi->pos] = best;
+	floor = best - trellis->beam;
+
+	for (cdna_pos = trellis->padding; zIsPairBeamCell(trellis, cdna_pos); cdna_pos++) {
+		for (state = 0; state < trellis->hmm->states; state++) {
+			tbtn = column[cdna_pos][state];
+			if (tbtn != NULL && tbtn->score < floor) {
+				tbtn->pruned = 1;
+				viterbi->beam_hits++;
+			}
+		}
+	}
+}
+
+/* True if the path to node changes state at a cell in the lower half of *
+ * the beam: a path through the cells dropped there may have done better */
+
+static bool zPairPathNearBeam(zViterbi *viterbi, zPairTrellis *trellis, zTBTree *tree, zTBTreeNode *node) {
+	zTBTreeNode *n;
+
+	for (n = node; n != tree->root; n = n->parent) {
+		if (!zIsPairBeamCell(trellis, n->cdna_pos) || viterbi->beam_best[n->pos] == MIN_SCORE) continue;
+		if (n->score < viterbi->beam_best[n->pos] - trellis->beam/2) return true;
+	}
+	return false;
+}
+
 void zRunSNPPairViterbiOnBlock(zViterbi* viterbi, zPairTrellis* trellis, zHSP* block){
 	zHMM*         hmm = trellis->hmm;
 	zDNA*         genomic = trellis->genomic;
@@ -661,7 +729,7 @@ void zRunSNPPairViterbiOnBlock(zViterbi* viterbi, zPairTrellis* trellis, zHSP* b
 							zTBTreeNode* previous_cell;
 							prestate = jumps->elem[i];
 							previous_cell = previous_array[prestate];
-							if(previous_cell == NULL) continue;
+							if(previous_cell == NULL || previous_cell->pruned) continue;
 							
 							score = this_score + zGetTransitionScore(hmm,prestate,state,trellis->tiso_group);
 
@@ -742,7 +810,7 @@ void zRunSNPPairViterbiOnBlock(zViterbi* viterbi, zPairTrellis* trellis, zHSP* b
 
 								coor_t i, j;
 								zTBTreeNode* tbtn = cache[gmin%viterbi->cache_length][cmin][from_state];
-								if (tbtn == NULL) continue;
+								if (tbtn == NULL || tbtn->pruned) continue;
 
 								total_score = tscore + zScoreDistribution(d, length) + tbtn->score;
 									
@@ -781,6 +849,8 @@ void zRunSNPPairViterbiOnBlock(zViterbi* viterbi, zPairTrellis* trellis, zHSP* b
 				}
 			}
 
+			if (trellis->beam > 0) zPrunePairViterbiColumn(viterbi, trellis, cache[cache_index]);
+
 			/* cleanup unused/unneeded old_cells, and reinit next cache_index */
 			for (cdna_pos = 0; cdna_pos < cdna->length; cdna_pos++) {
 				for (state = 0;state < hmm->states;state++){
@@ -802,6 +872,33 @@ void zRunSNPPairViterbiOnBlock(zViterbi* viterbi, zPairTrellis* trellis, zHSP* b
 	}
 }
 
+/* zRunSNPPairViterbi again with the beam off, in place of the decodes of *
+ * list if there are any. beam_hits stays the count of the beam run      */
+
+static zPtrList* zRunSNPPairViterbiWithoutBeam(zPairTrellis* trellis, score_t *path_score, zPtrList* list){
+	zAlleleDecode *ad;
+	zPtrList      *ret_list;
+	score_t        beam      = trellis->beam;
+	long           beam_hits = trellis->beam_hits;
+
+	if (list != NULL) {
+		ad = zPtrListMoveFirst(list);
+		while (ad != NULL) {
+			zFreeAlleleDecodePair(ad);
+			zFree(ad);
+			ad = zPtrListMoveNext(list);
+		}
+		zFreePtrList(list);
+		zFree(list);
+	}
+	trellis->beam = 0;
+	ret_list      = zRunSNPPairViterbi(trellis, path_score);
+	trellis->beam = beam;
+	trellis->beam_hits    = beam_hits;
+	trellis->beam_retried = true;
+	return ret_list;
+}
+
 zPtrList* zRunSNPPairViterbi(zPairTrellis* trellis, score_t *path_score){
 	zViterbi*     viterbi;
 	zHMM*         hmm = trellis->hmm;
@@ -819,6 +916,7 @@ zPtrList* zRunSNPPairViterbi(zPairTrellis* trellis, score_t *path_score){
 	zPtrList*     ret_list;
 	zAlnFeature*    f;
 	zTBTreeNode **cells;
+	bool          near_beam;
 
 	/* Prepare Viterbi Vars */
 	viterbi = zMalloc(sizeof(zViterbi),"zRunViterbi viterbi");
@@ -893,6 +991,14 @@ zPtrList* zRunSNPPairViterbi(zPairTrellis* trellis, score_t *path_score){
 			best_score = cells[state]->score;
 		}
 	}
+	if(best_state == -1 && trellis->beam > 0){
+		/* the beam dropped every way to the end */
+		trellis->beam_hits = viterbi->beam_hits;
+		zFreePairViterbi(viterbi);
+		zFree(viterbi);
+		zTrace2("the beam left no path to the end, decoding again without it");
+		return zRunSNPPairViterbiWithoutBeam(trellis, path_score, NULL);
+	}
 	if(best_state == -1){
 		zDie("No live states at end of trellis.  This should never happen");
 	}
@@ -907,12 +1013,21 @@ zPtrList* zRunSNPPairViterbi(zPairTrellis* trellis, score_t *path_score){
 	sprintf(ad->header,"## Main SNP Sequence\n"); 
 	
 	zTBTree2AFL(ad->afl,&viterbi->tb[0]->tbtree,cells[best_state],hmm,trellis);
+	near_beam = (viterbi->beam_best != NULL && zPairPathNearBeam(viterbi, trellis, &viterbi->tb[0]->tbtree, cells[best_state]));
 	f = zAFListMoveLast(ad->afl);
 	zPtrListAddFirst(viterbi->traceback,ad);
 	zSNPCleanUpDecodes(viterbi);
+	zTrace2("traceback tree: %d nodes at most, %lu bytes in %d slabs", tree->peak, (unsigned long)zGetTBTreeBytes(tree), tree->slab_count);
+	trellis->beam_hits    = viterbi->beam_hits;
+	trellis->beam_retried = false;
 	ret_list = viterbi->traceback;
 	viterbi->traceback = NULL;
 	zFreePairViterbi(viterbi);
 	zFree(viterbi);
+
+	if (near_beam && trellis->beam_retry) {
+		zTrace2("the path runs close to the cells the beam dropped, decoding again without it");
+		ret_list = zRunSNPPairViterbiWithoutBeam(trellis, path_score, ret_list);
+	}
 	return ret_list;
 }
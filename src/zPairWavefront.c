@@ -0,0 +1,286 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/******************************************************************************\
+  zPairWavefront.c - part of the ZOE library for genomic analysis
+
+  The kernel stages one anti-diagonal at a time. For every state it scores the
+  emission once per cell (instead of once per jump), gathers the scores of the
+  previous cells into contiguous lanes and does the add/compare of each jump
+  with SSE2 or AVX when the compiler targets them, in plain C otherwise. The
+  arithmetic is the same double precision add and compare as the scalar path,
+  so the result does not depend on which one is compiled in.
+
+  Explicit states have a duration loop of their own and are left to
+  zExplicitPairTrans, cell by cell.
+
+\******************************************************************************/
+
+#ifndef ZOE_PAIR_WAVEFRONT_C
+#define ZOE_PAIR_WAVEFRONT_C
+
+#include "zPairWavefront.h"
+#include "zPairSplice.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define WAVEFRONT_KERNEL "avx"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define WAVEFRONT_KERNEL "sse2"
+#else
+#define WAVEFRONT_KERNEL "scalar"
+#endif
+
+/* Lanes of one anti-diagonal, reused for every state and jump */
+
+struct zWavefront {
+	int                 size;    /* lanes allocated */
+	int                 lanes;   /* lanes in use on the current diagonal */
+	zPairTrellisCell  **cur;     /* cells at (genomic, cdna) */
+	zPairTrellisCell  **prev;    /* cells one increment of the current state back */
+	score_t            *emit;    /* emission of the current state */
+	score_t            *trans;   /* emission + transition of the current jump */
+	score_t            *from;    /* score of the previous cell of the current jump */
+	score_t            *best;    /* current score of the cell */
+	score_t            *cand;    /* trans + from */
+	char               *active;  /* cell still needs this state */
+	char               *hit;     /* cand beats best */
+	score_t            *fsum;    /* forward sum of the cell, with trellis->forward */
+	score_t            *fadd;    /* forward term of the current jump */
+};
+typedef struct zWavefront zWavefront;
+
+static void zInitWavefront (zWavefront *wf, int size) {
+	wf->size   = size;
+	wf->lanes  = 0;
+	wf->cur    = zMalloc(size*sizeof(zPairTrellisCell*), "zInitWavefront cur");
+	wf->prev   = zMalloc(size*sizeof(zPairTrellisCell*), "zInitWavefront prev");
+	wf->emit   = zMalloc(size*sizeof(score_t), "zInitWavefront emit");
+	wf->trans  = zMalloc(size*sizeof(score_t), "zInitWavefront trans");
+	wf->from   = zMalloc(size*sizeof(score_t), "zInitWavefront from");
+	wf->best   = zMalloc(size*sizeof(score_t), "zInitWavefront best");
+	wf->cand   = zMalloc(size*sizeof(score_t), "zInitWavefront cand");
+	wf->active = zMalloc(size*sizeof(char), "zInitWavefront active");
+	wf->hit    = zMalloc(size*sizeof(char), "zInitWavefront hit");
+	wf->fsum   = zMalloc(size*sizeof(score_t), "zInitWavefront fsum");
+	wf->fadd   = zMalloc(size*sizeof(score_t), "zInitWavefront fadd");
+}
+
+static void zFreeWavefront (zWavefront *wf) {
+	zFree(wf->cur);
+	zFree(wf->prev);
+	zFree(wf->emit);
+	zFree(wf->trans);
+	zFree(wf->from);
+	zFree(wf->best);
+	zFree(wf->cand);
+	zFree(wf->active);
+	zFree(wf->hit);
+	zFree(wf->fsum);
+	zFree(wf->fadd);
+}
+
+/* cand = trans + from; hit where trans is a real score and cand improves best */
+
+static void zRelaxWavefront (zWavefront *wf) {
+	int       k = 0;
+	int       n = wf->lanes;
+	score_t  *trans = wf->trans, *from = wf->from, *best = wf->best, *cand = wf->cand;
+	char     *hit = wf->hit;
+
+#if defined(__AVX__)
+	__m256d   vmin = _mm256_set1_pd(MIN_SCORE);
+	for (; k + 4 <= n; k += 4) {
+		__m256d t = _mm256_loadu_pd(trans + k);
+		__m256d c = _mm256_add_pd(t, _mm256_loadu_pd(from + k));
+		int     m = _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(t, vmin, _CMP_NEQ_UQ),
+		                                             _mm256_cmp_pd(c, _mm256_loadu_pd(best + k), _CMP_GT_OQ)));
+		_mm256_storeu_pd(cand + k, c);
+		hit[k]   = m & 1;
+		hit[k+1] = (m >> 1) & 1;
+		hit[k+2] = (m >> 2) & 1;
+		hit[k+3] = (m >> 3) & 1;
+	}
+#elif defined(__SSE2__)
+	__m128d   vmin = _mm_set1_pd(MIN_SCORE);
+	for (; k + 2 <= n; k += 2) {
+		__m128d t = _mm_loadu_pd(trans + k);
+		__m128d c = _mm_add_pd(t, _mm_loadu_pd(from + k));
+		int     m = _mm_movemask_pd(_mm_and_pd(_mm_cmpneq_pd(t, vmin),
+		                                       _mm_cmpgt_pd(c, _mm_loadu_pd(best + k))));
+		_mm_storeu_pd(cand + k, c);
+		hit[k]   = m & 1;
+		hit[k+1] = (m >> 1) & 1;
+	}
+#endif
+	for (; k < n; k++) {
+		cand[k] = trans[k] + from[k];
+		hit[k]  = (trans[k] != MIN_SCORE && cand[k] > best[k]);
+	}
+}
+
+/* Same as zInternalPairTransHelper, for all the lanes of a diagonal at once */
+
+static void zInternalPairTransWavefront (zPairTrellis *trellis, zWavefront *wf, int from_state, int to_state, coor_t glo, coor_t diag) {
+	zHMM     *hmm = trellis->hmm;
+	score_t   trans;
+	int       k;
+
+	if (EXTERNAL == hmm->state[from_state].type) {
+		if (hmm->state[to_state].phase != hmm->state[from_state].phase) return;
+	}
+	trans = zGetTransitionScore(hmm, from_state, to_state, trellis->tiso_group);
+
+	for (k = 0; k < wf->lanes; k++) {
+		if (wf->active[k]) {
+			wf->trans[k] = wf->emit[k] + trans;
+			wf->from[k]  = wf->prev[k][from_state].score;
+		} else {
+			wf->trans[k] = MIN_SCORE;
+			wf->from[k]  = MIN_SCORE;
+		}
+	}
+
+	if (trellis->forward != NULL) {
+		/* gathered into lanes, added with zLogAddScores and put back; a lane *
+		 * that adds nothing gets MIN_SCORE, which leaves its sum as it is   */
+		int gincrement = zGetGenomicIncrement(hmm, to_state);
+		int cincrement = zGetCDnaIncrement(hmm, to_state);
+		for (k = 0; k < wf->lanes; k++) {
+			coor_t genomic = glo + k, cdna = diag - glo - k;
+			if (!wf->active[k] || wf->trans[k] == MIN_SCORE) {
+				wf->fsum[k] = MIN_SCORE;
+				wf->fadd[k] = MIN_SCORE;
+				continue;
+			}
+			wf->fsum[k] = trellis->forward[genomic][cdna][to_state];
+			wf->fadd[k] = wf->trans[k] + trellis->forward[genomic-gincrement][cdna-cincrement][from_state];
+		}
+		zLogAddScores(wf->fsum, wf->fadd, wf->lanes);
+		for (k = 0; k < wf->lanes; k++) {
+			if (wf->fadd[k] == MIN_SCORE) continue;
+			trellis->forward[glo + k][diag - glo - k][to_state] = wf->fsum[k];
+		}
+	}
+
+	zRelaxWavefront(wf);
+
+	for (k = 0; k < wf->lanes; k++) {
+		zPairTrellisCell *cell, *prev_cell;
+		if (!wf->hit[k]) continue;
+		cell      = &wf->cur[k][to_state];
+		prev_cell = &wf->prev[k][from_state];
+		zSetCellScore(trellis, cell, wf->cand[k]);
+		wf->best[k] = cell->score; /* what the scalar path compares against */
+		if (from_state == to_state) {
+			cell->length = prev_cell->length + 1;
+			cell->trace  = prev_cell->trace;
+		} else {
+			cell->trace  = from_state;
+			cell->length = 1;
+		}
+	}
+}
+
+/* Only cells with dlo <= genomic - cdna <= dhi are relaxed, see zRunPartialPairViterbiAndForward */
+
+void zRunPairWavefront (zPairTrellis *trellis, coor_t gstart, coor_t gend, coor_t cstart, coor_t cend, long dlo, long dhi) {
+	zHMM       *hmm = trellis->hmm;
+	zWavefront  wf;
+	coor_t      diag, genomic, cdna, glo, ghi;
+	coor_t      ahead;  /* see zGetSpliceAheadEnd */
+	long        blo, bhi;
+	int         state, prev, k;
+	zIVec      *jumps;
+	zScanner   *scanner;
+
+	if (gend < gstart || cend < cstart) return;
+	zInitWavefront(&wf, MIN(gend - gstart, cend - cstart) + 1);
+	ahead = zGetSpliceAheadEnd(trellis, gstart, gend);
+
+	for (diag = gstart + cstart; diag <= gend + cend; diag++) {
+		/* lane k holds (glo + k, diag - glo - k) */
+		glo = (diag > gstart + cend) ? diag - cend : gstart;
+		ghi = MIN(gend, diag - cstart);
+		/* 2*genomic - diag within [dlo, dhi], rounded inwards */
+		blo = (long)diag + dlo;
+		bhi = (long)diag + dhi;
+		if (bhi < 0) continue;
+		blo = (blo <= 0) ? 0 : (blo + 1)/2;
+		bhi = bhi/2;
+		if (blo > (long)glo) glo = blo;
+		if (bhi < (long)ghi) ghi = bhi;
+		if (ghi < glo) continue;
+		wf.lanes = ghi - glo + 1;
+		for (k = 0; k < wf.lanes; k++) {
+			genomic   = glo + k;
+			cdna      = diag - genomic;
+			wf.cur[k] = (trellis->cell[genomic] == NULL) ? NULL : zGetCellArray(trellis, genomic, cdna);
+		}
+
+		for (state = 0; state < hmm->states; state++) {
+			int gincrement = zGetGenomicIncrement(hmm, state);
+			int cincrement = zGetCDnaIncrement(hmm, state);
+			int any        = 0;
+			jumps = hmm->jmap[state];
+
+			for (k = 0; k < wf.lanes; k++) {
+				zPairTrellisCell *cell = wf.cur[k];
+				wf.active[k] = 0;
+				if (cell == NULL) continue;
+				if (cell[state].score != MIN_SCORE) continue; /* Has been done already */
+				genomic = glo + k;
+				cdna    = diag - genomic;
+				if (trellis->forward != NULL) trellis->forward[genomic][cdna][state] = MIN_SCORE;
+				if (zSkipSpliceCell(trellis, state, genomic, ahead)) continue;
+				wf.active[k] = 1;
+				wf.best[k]   = MIN_SCORE;
+				any = 1;
+			}
+			if (!any) continue;
+
+			if (EXPLICIT == hmm->state[state].type) {
+				for (k = 0; k < wf.lanes; k++) {
+					if (!wf.active[k]) continue;
+					genomic = glo + k;
+					cdna    = diag - genomic;
+					for (prev = 0; prev < jumps->size; prev++) {
+						zGetPairTransFunc(hmm->state[state].type)
+							(trellis, jumps->elem[prev], state, genomic, cdna);
+					}
+				}
+				continue;
+			}
+
+			/* the emission kind is the same for every lane */
+			scanner = trellis->scanner[hmm->state[state].model];
+			if (scanner->model->seq_type == PAIR && scanner->pairscore != NULL) {
+				for (k = 0; k < wf.lanes; k++) {
+					if (!wf.active[k]) continue;
+					wf.emit[k] = zGetPairEmission(trellis, scanner, glo + k, diag - glo - k);
+				}
+			} else {
+				for (k = 0; k < wf.lanes; k++) {
+					if (!wf.active[k]) continue;
+					wf.emit[k] = zGetScannerScore(trellis, scanner, state, glo + k, diag - glo - k);
+				}
+			}
+			for (k = 0; k < wf.lanes; k++) {
+				if (!wf.active[k]) continue;
+				genomic    = glo + k;
+				cdna       = diag - genomic;
+				wf.prev[k] = zGetCellArray(trellis, genomic - gincrement, cdna - cincrement);
+			}
+			for (prev = 0; prev < jumps->size; prev++) {
+				zInternalPairTransWavefront(trellis, &wf, jumps->elem[prev], state, glo, diag);
+			}
+		}
+	}
+
+	zFreeWavefront(&wf);
+}
+
+const char* zPairWavefrontKernel (void) {
+	return WAVEFRONT_KERNEL;
+}
+
+#endif
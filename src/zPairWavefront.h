@@ -0,0 +1,21 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/******************************************************************************\
+zPairWavefront.h - part of the ZOE library for genomic analysis
+
+ Anti-diagonal kernel for the pair HMM Viterbi recurrence. Every state moves
+ along genomic, cdna or both, so the cells of one anti-diagonal (genomic+cdna
+ constant) only read cells of earlier anti-diagonals and can be relaxed
+ together. Each cell still sees its jumps in hmm->jmap order, which keeps the
+ scores and the traceback identical to the scalar genomic x cdna sweep.
+
+\******************************************************************************/
+
+#ifndef ZOE_PAIR_WAVEFRONT_H
+#define ZOE_PAIR_WAVEFRONT_H
+
+#include "zPairTrellis.h"
+
+void        zRunPairWavefront (zPairTrellis*, coor_t, coor_t, coor_t, coor_t, long, long);
+const char* zPairWavefrontKernel (void);
+
+#endif
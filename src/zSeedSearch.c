@@ -0,0 +1,259 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/******************************************************************************\
+  zSeedSearch.c - part of the ZOE library for genomic analysis
+
+\******************************************************************************/
+
+#ifndef ZOE_SEED_SEARCH_C
+#define ZOE_SEED_SEARCH_C
+
+#include "zSeedSearch.h"
+
+#define KMER_MASK ((1UL << (2*SEED_KMER)) - 1)
+
+/* A k-mer shared by the genomic and the cDNA, diag is genomic - cdna */
+struct zKmerHit {
+	long    diag;
+	coor_t  c;
+};
+typedef struct zKmerHit zKmerHit;
+
+/* Shift the next s5 symbol into code, true once code holds SEED_KMER bases */
+static bool zNextKmer (int s5, unsigned long *code, int *valid) {
+	if (s5 > 3) {
+		*code  = 0;
+		*valid = 0;
+		return false;
+	}
+	*code = ((*code << 2) | s5) & KMER_MASK;
+	if (*valid < SEED_KMER) (*valid)++;
+	return *valid == SEED_KMER;
+}
+
+/* An odd multiplier permutes the k-mer codes, so the bucket (high bits) and *
+ * the check (low bits) together still tell k-mers apart                    */
+static unsigned long zKmerHash (unsigned long code) {
+	return (code * 2654435761UL) & KMER_MASK;
+}
+
+static unsigned long zKmerBucket (zKmerIndex *index, unsigned long code) {
+	return zKmerHash(code) >> (2*SEED_KMER - index->bits);
+}
+
+static unsigned short zKmerCheck (zKmerIndex *index, unsigned long code) {
+	return (unsigned short)(zKmerHash(code) & ((1UL << (2*SEED_KMER - index->bits)) - 1));
+}
+
+void zInitKmerIndex (zKmerIndex *index, zDNA *genomic) {
+	unsigned long  code = 0, b, buckets;
+	coor_t         i;
+	int            valid = 0;
+
+	index->genomic = genomic;
+	index->offset  = genomic->seq->padding;
+	index->length  = genomic->seq->real_length;
+
+	/* about one k-mer per bucket */
+	for (index->bits = 10; index->bits < 2*SEED_KMER && (1UL << index->bits) < index->length; index->bits++);
+	buckets = 1UL << index->bits;
+	index->first = zCalloc(buckets + 1, sizeof(coor_t), "zInitKmerIndex first");
+
+	for (i = 0; i < index->length; i++) {
+		if (zNextKmer(zGetDNAS5(genomic, index->offset + i), &code, &valid)) {
+			index->first[zKmerBucket(index, code)]++;
+		}
+	}
+	for (b = 1; b <= buckets; b++) index->first[b] += index->first[b-1];
+	index->pos   = zMalloc((index->first[buckets] + 1)*sizeof(coor_t), "zInitKmerIndex pos");
+	index->check = zMalloc((index->first[buckets] + 1)*sizeof(unsigned short), "zInitKmerIndex check");
+
+	/* first[b] counts down from the end of bucket b to its start */
+	code = 0;
+	valid = 0;
+	for (i = 0; i < index->length; i++) {
+		if (zNextKmer(zGetDNAS5(genomic, index->offset + i), &code, &valid)) {
+			b = --index->first[zKmerBucket(index, code)];
+			index->pos[b]   = i + 1 - SEED_KMER;
+			index->check[b] = zKmerCheck(index, code);
+		}
+	}
+}
+
+void zFreeKmerIndex (zKmerIndex *index) {
+	zFree(index->first);
+	zFree(index->pos);
+	zFree(index->check);
+	index->first = NULL;
+	index->pos   = NULL;
+	index->check = NULL;
+}
+
+static int zGetOrientedS5 (zDNA *cdna, coor_t length, coor_t pos, bool anti) {
+	int s5;
+
+	if (!anti) return zGetDNAS5(cdna, cdna->seq->padding + pos);
+	s5 = zGetDNAS5(cdna, cdna->seq->padding + length - 1 - pos);
+	return (s5 > 3) ? s5 : 3 - s5;
+}
+
+static int zKmerHitCmp (const void *a, const void *b) {
+	const zKmerHit *x = (const zKmerHit*)a;
+	const zKmerHit *y = (const zKmerHit*)b;
+
+	if (x->diag != y->diag) return (x->diag < y->diag) ? -1 : 1;
+	if (x->c    != y->c)    return (x->c    < y->c)    ? -1 : 1;
+	return 0;
+}
+
+static int zHSPStartCmp (const void *a, const void *b) {
+	const zHSP *x = (const zHSP*)a;
+	const zHSP *y = (const zHSP*)b;
+
+	if (x->g_start != y->g_start) return (x->g_start < y->g_start) ? -1 : 1;
+	if (x->c_start != y->c_start) return (x->c_start < y->c_start) ? -1 : 1;
+	return 0;
+}
+
+/* Ungapped HSPs (0 based) between the genomic and one orientation of cdna */
+static int zCollectHSPs (zKmerIndex *index, zDNA *cdna, bool anti, zHSP **hsp) {
+	coor_t         length = cdna->seq->real_length;
+	zKmerHit      *hit = NULL;
+	int            hits = 0, size = 0, count = 0, valid = 0, i, j;
+	unsigned long  code = 0, b;
+	unsigned short check;
+	coor_t         c, k;
+
+	for (c = 0; c < length; c++) {
+		if (!zNextKmer(zGetOrientedS5(cdna, length, c, anti), &code, &valid)) continue;
+		b = zKmerBucket(index, code);
+		if (index->first[b+1] - index->first[b] > SEED_MAX_OCC) continue;
+		check = zKmerCheck(index, code);
+		for (k = index->first[b]; k < index->first[b+1]; k++) {
+			if (index->check[k] != check) continue;
+			if (hits == size) {
+				size = (size == 0) ? 256 : 2*size;
+				hit  = zRealloc(hit, size*sizeof(zKmerHit), "zCollectHSPs hit");
+			}
+			hit[hits].c    = c + 1 - SEED_KMER;
+			hit[hits].diag = (long)index->pos[k] - (long)hit[hits].c;
+			hits++;
+		}
+	}
+	qsort(hit, hits, sizeof(zKmerHit), zKmerHitCmp);
+
+	/* a run of hits on one diagonal, gaps are mismatches */
+	*hsp = zMalloc((hits + 1)*sizeof(zHSP), "zCollectHSPs hsp");
+	for (i = 0; i < hits; i = j) {
+		for (j = i + 1; j < hits && hit[j].diag == hit[i].diag
+			     && hit[j].c <= hit[j-1].c + SEED_MAX_SKIP; j++);
+		if (hit[j-1].c + SEED_KMER - hit[i].c < SEED_MIN_HSP) continue;
+		(*hsp)[count].c_start = hit[i].c;
+		(*hsp)[count].c_end   = hit[j-1].c + SEED_KMER - 1;
+		(*hsp)[count].g_start = hit[i].diag + hit[i].c;
+		(*hsp)[count].g_end   = hit[i].diag + (*hsp)[count].c_end;
+		count++;
+	}
+	zFree(hit);
+	return count;
+}
+
+/* Best colinear chain, scored by the cDNA bases it covers. The chain is *
+ * left in genomic order in chain[0 .. *length-1]                        */
+static long zChainHSPs (zHSP *hsp, int count, int *chain, int *length) {
+	long  *score;
+	int   *prev;
+	int    i, j, best = -1;
+	long   result;
+
+	*length = 0;
+	if (count == 0) return 0;
+
+	qsort(hsp, count, sizeof(zHSP), zHSPStartCmp);
+	score = zMalloc(count*sizeof(long), "zChainHSPs score");
+	prev  = zMalloc(count*sizeof(int),  "zChainHSPs prev");
+	for (i = 0; i < count; i++) {
+		score[i] = hsp[i].c_end - hsp[i].c_start + 1;
+		prev[i]  = -1;
+		for (j = i - 1; j >= 0; j--) {
+			if (hsp[j].g_end >= hsp[i].g_start || hsp[j].c_end >= hsp[i].c_start) continue;
+			if (hsp[i].g_start - hsp[j].g_end > SEED_MAX_INTRON) continue;
+			if (score[j] + hsp[i].c_end - hsp[i].c_start + 1 > score[i]) {
+				score[i] = score[j] + hsp[i].c_end - hsp[i].c_start + 1;
+				prev[i]  = j;
+			}
+		}
+		if (best < 0 || score[i] > score[best]) best = i;
+	}
+
+	for (i = best; i >= 0; i = prev[i]) (*length)++;
+	for (i = best, j = *length - 1; i >= 0; i = prev[i], j--) chain[j] = i;
+	result = score[best];
+	zFree(score);
+	zFree(prev);
+	return result;
+}
+
+/* HSPs of one strand of cdna (1 for the reverse complement) and their best chain */
+static long zSearchStrand (zKmerIndex *index, zDNA *cdna, int strand, zHSP **hsp, int **chain, int *length) {
+	int count = zCollectHSPs(index, cdna, (strand == 1), hsp);
+
+	*chain = zMalloc((count + 1)*sizeof(int), "zSearchStrand chain");
+	return zChainHSPs(*hsp, count, *chain, length);
+}
+
+void zSeedStrandCoverage (zKmerIndex *index, zDNA *cdna, long *coverage) {
+	zHSP  *hsp;
+	int   *chain;
+	int    s, length;
+
+	for (s = 0; s < 2; s++) {
+		coverage[s] = zSearchStrand(index, cdna, s, &hsp, &chain, &length);
+		zFree(hsp);
+		zFree(chain);
+	}
+}
+
+int zSearchSeedAlignment (zKmerIndex *index, zDNA *cdna, zSeedAlignment *seed) {
+	zHSP  *hsp[2];
+	int   *chain[2];
+	int    length[2];
+	long   score[2];
+	int    s, i, best;
+
+	for (s = 0; s < 2; s++) {
+		score[s] = zSearchStrand(index, cdna, s, &hsp[s], &chain[s], &length[s]);
+	}
+	best = (score[1] > score[0]) ? 1 : 0;
+
+	seed->def = zMalloc(strlen(cdna->def) + 1, "zSearchSeedAlignment def");
+	strcpy(seed->def, cdna->def);
+	seed->contig = NULL; /* the index covers the first genomic sequence only */
+	seed->hsps = length[best];
+	seed->hsp  = NULL;
+	if (seed->hsps == 0) {
+		/* same as an empty entry of a seed alignment file */
+		seed->strand   = '+';
+		seed->gb_start = 0;
+		seed->gb_end   = 0;
+	} else {
+		seed->strand = (best == 1) ? '-' : '+';
+		seed->hsp    = zMalloc(seed->hsps*sizeof(zHSP), "zSearchSeedAlignment hsp");
+		for (i = 0; i < seed->hsps; i++) {
+			seed->hsp[i] = hsp[best][chain[best][i]];
+			seed->hsp[i].g_start++;
+			seed->hsp[i].g_end++;
+			seed->hsp[i].c_start++;
+			seed->hsp[i].c_end++;
+		}
+		seed->gb_start = MAX(seed->hsp[0].g_start, SEED_FLANK) - SEED_FLANK;
+		seed->gb_end   = MIN(seed->hsp[seed->hsps-1].g_end + SEED_FLANK, index->length);
+	}
+
+	for (s = 0; s < 2; s++) {
+		zFree(hsp[s]);
+		zFree(chain[s]);
+	}
+	return seed->hsps;
+}
+
+#endif
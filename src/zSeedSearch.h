@@ -0,0 +1,56 @@
+/* -*- Mode: C; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: t -*- */
+/******************************************************************************\
+zSeedSearch.h - part of the ZOE library for genomic analysis
+
+ Builds seed alignments without an external aligner. Every k-mer of the
+ genomic sequence goes into a hashed index once; the k-mers of each cDNA
+ (and of its reverse complement) are looked up, runs of hits on the same
+ diagonal become ungapped HSPs, and the best colinear chain of HSPs is the
+ seed alignment, in the format zReadSeedAlignment would have read.
+
+	zKmerIndex index;
+	zInitKmerIndex(&index, genomic);
+	zSearchSeedAlignment(&index, cdna, &seed);   for each cDNA
+	...
+	zFreeKmerIndex(&index);
+
+ Coordinates of the seed are 1 based and, on the '-' strand, refer to the
+ reverse complemented cDNA. A cDNA without a chain gets an empty seed.
+
+ zSeedStrandCoverage only scores the chains: the cDNA bases the best chain
+ covers on the '+' and on the '-' strand, the same scores that decide the
+ strand of the seed.
+
+\******************************************************************************/
+
+#ifndef ZOE_SEED_SEARCH_H
+#define ZOE_SEED_SEARCH_H
+
+#include "zTools.h"
+#include "zDNA.h"
+#include "zSeedUtils.h"
+
+#define SEED_KMER       12      /* k-mer length */
+#define SEED_MAX_OCC    64      /* k-mers more frequent than this are repeats */
+#define SEED_MAX_SKIP   24      /* hits this far apart on a diagonal are one HSP */
+#define SEED_MIN_HSP    30      /* shorter HSPs do not survive zPruneSeedAlignment */
+#define SEED_MAX_INTRON 1000000 /* longest genomic gap between chained HSPs */
+#define SEED_FLANK      10000   /* genomic boundary around the chain */
+
+struct zKmerIndex {
+	zDNA            *genomic;
+	coor_t           offset;   /* padding of the genomic sequence */
+	coor_t           length;   /* unpadded length */
+	int              bits;     /* log2 of the number of buckets */
+	coor_t          *first;    /* bucket b holds pos[first[b] .. first[b+1]-1] */
+	coor_t          *pos;      /* 0 based start of each k-mer */
+	unsigned short  *check;    /* the rest of its hash, see zKmerCheck */
+};
+typedef struct zKmerIndex zKmerIndex;
+
+void zInitKmerIndex (zKmerIndex*, zDNA*);
+void zFreeKmerIndex (zKmerIndex*);
+int  zSearchSeedAlignment (zKmerIndex*, zDNA*, zSeedAlignment*);
+void zSeedStrandCoverage (zKmerIndex*, zDNA*, long*);
+
+#endif
@@ -88,9 +88,10 @@ int zReadSeedAlignment (FILE *stream, zSeedAlignment *seed) {
 
 	coor_t boundary_start, boundary_end;        /* genomic boundaries */
 	char   defline[4096];                       /* Fasta def line */
-	int    i;
+	int    i, fields;
  	char   c;
 	char   strand[4];
+	char   contig[4096];                        /* optional genomic sequence name */
 
 	/* Validate */
 	c = fgetc(stream);
@@ -110,7 +111,13 @@ int zReadSeedAlignment (FILE *stream, zSeedAlignment *seed) {
 	
 	/* Get a line. This could be optional boundary and mandatory count */
 	(void)fgets(defline, sizeof(defline), stream);
-	if (sscanf(defline, "genomic_boundary_start=%u genomic_boundary_end=%u strand=%s", &boundary_start, &boundary_end, strand) == 3) {
+	seed->contig = NULL;
+	fields = sscanf(defline, "genomic_boundary_start=%u genomic_boundary_end=%u strand=%3s contig=%4095s", &boundary_start, &boundary_end, strand, contig);
+	if (fields >= 3) {
+		if (fields == 4) {
+			seed->contig = zMalloc(strlen(contig) + 1, "zReadSeedAlignment contig");
+			(void)strcpy(seed->contig, contig);
+		}
 		seed->strand                 = zText2Strand(strand);
 		seed->gb_start = boundary_start;
 		seed->gb_end   = boundary_end;
@@ -155,7 +162,9 @@ void zWriteSeedAlignment(FILE *stream, zSeedAlignment *seed) {
 		fprintf(stream, ">empty seed alignment\n");
 		return;
 	}
-	fprintf(stream, "%s\ngenomic_boundary_start=%u genomic_boundary_end=%u strand=%c\n", seed->def, seed->gb_start, seed->gb_end, (seed->strand == UNDEFINED_STRAND)?'.':seed->strand);
+	fprintf(stream, "%s\ngenomic_boundary_start=%u genomic_boundary_end=%u strand=%c", seed->def, seed->gb_start, seed->gb_end, (seed->strand == UNDEFINED_STRAND)?'.':seed->strand);
+	if (seed->contig != NULL) fprintf(stream, " contig=%s", seed->contig);
+	fprintf(stream, "\n");
 	fprintf(stream, "count=%d\n", seed->hsps);
 	for (i = 0; i < seed->hsps; i++) {
 		zWriteHSP(stream, &seed->hsp[i]);
@@ -170,6 +179,11 @@ void zCopySeedAlignment(zSeedAlignment *seed, zSeedAlignment *copy) {
 	copy->gb_end = seed->gb_end;
 	copy->def  = zMalloc(sizeof(char)*(strlen(seed->def)+1), "zCopySeedAlignment: trellis->copy->def");
 	strcpy(copy->def, seed->def);
+	copy->contig = NULL;
+	if (seed->contig != NULL) {
+		copy->contig = zMalloc(strlen(seed->contig)+1, "zCopySeedAlignment: copy->contig");
+		strcpy(copy->contig, seed->contig);
+	}
 	copy->hsps = seed->hsps;
 	copy->hsp  = (zHSP*) zMalloc(copy->hsps*sizeof(zHSP), "zCopySeedAlignment: copy->hsp");
 	for (i = 0; i < copy->hsps; i++) {
@@ -178,14 +192,16 @@ void zCopySeedAlignment(zSeedAlignment *seed, zSeedAlignment *copy) {
 }
 
 void zInitSeedAlignment(zSeedAlignment *seed) {
-	seed->hsp = NULL;
-	seed->def = NULL;
+	seed->hsp    = NULL;
+	seed->def    = NULL;
+	seed->contig = NULL;
 }
 
 void zFreeSeedAlignment(zSeedAlignment *seed) {
 	if (seed == NULL) return;
 	zFree(seed->hsp);
 	zFree(seed->def);
+	zFree(seed->contig);
 }
 
 int zTranslateSeedAlignmentGenomic(zSeedAlignment *seed, coor_t offset) {
@@ -225,6 +241,58 @@ int zGetAlignmentBlock(zSeedAlignment *mem_blocks, coor_t gpos, coor_t cpos) {
 	return k;
 }
 
+void zInitBlockIndex(zBlockIndex *index, zSeedAlignment *blocks) {
+	int k;
+	index->blocks = blocks;
+	index->cursor = 0;
+	index->sorted = true;
+	for (k = 1; k < blocks->hsps; k++) {
+		if (blocks->hsp[k].g_end < blocks->hsp[k-1].g_end ||
+		    blocks->hsp[k].c_end < blocks->hsp[k-1].c_end) {
+			index->sorted = false;
+		}
+	}
+}
+
+/* true for the blocks at or after the one zGetAlignmentBlock returns, when sorted */
+static bool zPointBeforeBlockEnd(zHSP *r, coor_t gpos, coor_t cpos) {
+	return gpos <= r->g_end && cpos <= r->c_end;
+}
+
+int zFindAlignmentBlock(zBlockIndex *index, coor_t gpos, coor_t cpos) {
+	zSeedAlignment *blocks = index->blocks;
+	int lo = 0, hi = blocks->hsps, mid;
+
+	if (!index->sorted) return index->cursor = zGetAlignmentBlock(blocks, gpos, cpos);
+	while (lo < hi) {
+		mid = lo + (hi - lo)/2;
+		if (zPointBeforeBlockEnd(&blocks->hsp[mid], gpos, cpos)) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+	if (lo == blocks->hsps) {
+		zDie("Point (%u, %u) lies outside alignment blocks", gpos, cpos);
+	}
+	return index->cursor = lo;
+}
+
+int zNextAlignmentBlock(zBlockIndex *index, coor_t gpos, coor_t cpos) {
+	zSeedAlignment *blocks = index->blocks;
+	int k = index->cursor;
+
+	/* the point went backwards, start over */
+	if (!index->sorted || (k > 0 && zPointBeforeBlockEnd(&blocks->hsp[k-1], gpos, cpos))) {
+		return zFindAlignmentBlock(index, gpos, cpos);
+	}
+	while (k < blocks->hsps && !zPointBeforeBlockEnd(&blocks->hsp[k], gpos, cpos)) k++;
+	if (k == blocks->hsps) {
+		zDie("Point (%u, %u) lies outside alignment blocks", gpos, cpos);
+	}
+	return index->cursor = k;
+}
+
 int zReadMultipleSeedAlignments(FILE* stream, zVec *seeds) {
 	zSeedAlignment *entry = (zSeedAlignment*) zMalloc(sizeof(zSeedAlignment), "zReadMultipleSeedAlignments: entry");
 	if (seeds == NULL) {
@@ -393,6 +461,24 @@ int zSeedAlignment2AlignmentBlocks(zDNA *genomic, zDNA *cdna, zSeedAlignment *se
 	return blocks->hsps;
 }
 
+/*
+Index of the seed HSP that zSeedAlignment2AlignmentBlocks built block
+around, or -1 for the blocks that bridge the gaps between HSPs.
+*/
+int zGetAlignmentBlockHSP(zSeedAlignment *seed, zHSP *block) {
+	int i;
+	if (seed == NULL) return -1;
+	for (i = 0; i < seed->hsps; i++) {
+		zHSP* hsp = &seed->hsp[i];
+		if (hsp->g_start == 0 || hsp->g_start == hsp->g_end) continue;
+		if (block->g_start == hsp->g_start - BLOCK_OVERLAP + 1 &&
+		    block->c_start == hsp->c_start - BLOCK_OVERLAP) {
+			return i;
+		}
+	}
+	return -1;
+}
+
 void zAlignmentBlocks2MemoryBlocks(zSeedAlignment *blocks, zSeedAlignment *mem_blocks) {
 	int i;
 	zHSP *current, *previous;
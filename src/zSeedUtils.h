@@ -1,3 +1,6 @@
+#ifndef ZOE_SEED_UTILS_H
+#define ZOE_SEED_UTILS_H
+
 #include "zTools.h"
 #include "zDNA.h"
 
@@ -19,6 +22,7 @@ struct zSeedAlignment {
 	coor_t    gb_end; 
 	zHSP     *hsp; 
 	char     *def;
+	char     *contig;   /* genomic sequence name, NULL for the first one */
 	strand_t  strand; 
 }; 
 typedef struct zSeedAlignment zSeedAlignment; 
@@ -32,5 +36,23 @@ int zReadMultipleSeedAlignments(FILE* stream, zVec *seeds);
 int zTranslateSeedAlignment(zSeedAlignment *seed, coor_t offset); 
 int zGetAlignmentBlock(zSeedAlignment *mem_blocks, coor_t gpos, coor_t cpos); 
 int zSeedAlignment2AlignmentBlocks(zDNA *genomic, zDNA *cdna, zSeedAlignment *seed, zSeedAlignment *blocks); 
+int zGetAlignmentBlockHSP(zSeedAlignment *seed, zHSP *block); 
 void zAlignmentBlocks2MemoryBlocks(zSeedAlignment *blocks, zSeedAlignment *mem_blocks); 
 int zPruneSeedAlignment(zDNA *genomic, zDNA *cdna, zSeedAlignment *seed, coor_t prune); 
+
+/* Answers zGetAlignmentBlock in O(log n) with zFindAlignmentBlock, or in  *
+ * amortized O(1) with zNextAlignmentBlock for points that move forward.  *
+ * Blocks whose ends ever go backwards are scanned as before.             */
+
+struct zBlockIndex {
+	zSeedAlignment *blocks;
+	bool            sorted;  /* g_end and c_end never decrease */
+	int             cursor;  /* block of the last lookup */
+};
+typedef struct zBlockIndex zBlockIndex;
+
+void zInitBlockIndex(zBlockIndex *index, zSeedAlignment *blocks);
+int zFindAlignmentBlock(zBlockIndex *index, coor_t gpos, coor_t cpos);
+int zNextAlignmentBlock(zBlockIndex *index, coor_t gpos, coor_t cpos);
+
+#endif
@@ -128,6 +128,8 @@ long zInitSequenceSpecialized (char* filename, void* parent,
 	seq->init_func   = init_func;
 	seq->read_func   = read_func;
 	seq->init_block_func = init_block_func;
+	seq->packed      = NULL;
+	seq->alphabet    = NULL;
 
 	seq->reverse     = false;
 	seq->padding     = 0;
@@ -193,6 +195,47 @@ long zInitSequenceSpecialized (char* filename, void* parent,
 	return more_records;
 }
 
+/* A sequence whose letters are already in memory, packed two per byte. The
+   caller owns the packed data and must keep it alive as long as the sequence
+   and its copies. block_size only sets the windows of zGetSeqBlockID. */
+
+void zInitPackedSequence (zSequence* seq, const char* filename, void* parent,
+						  const unsigned char* packed, const char* alphabet,
+						  coor_t length, coor_t block_size){
+	seq->var_count   = 0;
+	seq->variants    = NULL;
+	seq->hap_count   = 0;
+	seq->haps        = NULL;
+	seq->block_size  = block_size;
+	seq->block_count = (length + block_size - 1)/block_size;
+	if(seq->block_count == 0){
+		seq->block_count = 1;
+	}
+	seq->parent      = parent;
+	seq->init_func   = NULL;
+	seq->read_func   = NULL;
+	seq->init_block_func = zCreateSeqBlock;
+	seq->packed      = packed;
+	seq->alphabet    = alphabet;
+
+	seq->reverse      = false;
+	seq->padding      = 0;
+	seq->real_length  = length;
+	seq->length       = length;
+	seq->default_char = 'N';
+
+	seq->filename = zMalloc(strlen(filename) +1,"zInitPackedSequence filename");
+	strcpy(seq->filename, filename);
+	seq->fp       = NULL;
+	seq->file_map = NULL;
+	seq->map_size = 0;
+	zInitList(&seq->seq,seq->init_block_func,zFreeSeqBlock,zResetSeqBlock);
+}
+
+static char zGetPackedChar(zSequence* seq, coor_t pos){
+	return seq->alphabet[(seq->packed[pos >> 1] >> ((pos & 1) << 2)) & 0xf];
+}
+
 /*********************************************************************** 
 
 Remember to free the vector multi_parent and its contents too
@@ -264,6 +307,9 @@ zSequenceIterator* zGetSequenceIterator (char* filename,
 
 void* zGetNextParent(zSequenceIterator* iterator) {
 
+	if (iterator->fpos == -1) { /* EOF */
+		return NULL;
+	}
 	iterator->parent = zMalloc(iterator->parent_size, "zGetNextSequence: parent");
 	iterator->init_parent_func(iterator->parent);
 	iterator->fpos =  zInitSequenceSpecialized(iterator->filename,
@@ -275,8 +321,8 @@ void* zGetNextParent(zSequenceIterator* iterator) {
 								iterator->block_count,
 								iterator->fpos, 
 								-1);
-	if (iterator->fpos == 0) { /* EOF */
-		return NULL;
+	if (iterator->fpos == 0) { /* that was the last record */
+		iterator->fpos = -1;
 	}
 	return iterator->parent;
 }
@@ -358,10 +404,12 @@ void zCopySequence (zSequence* orig, zSequence* copy){
 	copy->block_size  = orig->block_size;
 	copy->block_count  = orig->block_count;
 	copy->default_char = orig->default_char;
+	copy->packed       = orig->packed;
+	copy->alphabet     = orig->alphabet;
 
 	zInitList(&copy->seq,copy->init_block_func,zFreeSeqBlock,zResetSeqBlock);
-	copy->file_map = zMalloc(sizeof(zSeqFileMap)*copy->map_size,
-							 "zCopySeq seq_map");
+	copy->file_map = (copy->map_size == 0) ? NULL :
+		zMalloc(sizeof(zSeqFileMap)*copy->map_size, "zCopySeq seq_map");
 
 	copy->var_count = orig->var_count;
 	if(orig->variants != NULL){
@@ -400,7 +448,7 @@ void zCopySequence (zSequence* orig, zSequence* copy){
 	}
 	copy->filename = zMalloc(strlen(orig->filename)+1,"zCopy filename");
 	strcpy(copy->filename, orig->filename);
-	copy->fp = fopen(copy->filename,"r");
+	copy->fp = (orig->packed != NULL) ? NULL : fopen(copy->filename,"r");
 
 	block = zListMoveFirst(&orig->seq);
 	while(block != NULL){
@@ -439,6 +487,9 @@ int zGetSeqBlockID(zSequence* seq, coor_t pos){
 	if(pos >= seq->real_length){
 		pos = seq->real_length-1;
 	}
+	if(seq->packed != NULL){
+		return pos/seq->block_size;
+	}
 
 	block = zListMoveFirst(&seq->seq);
 	while(block != NULL){
@@ -465,6 +516,9 @@ char zGetSequencePos(zSequence* seq,coor_t pos){
 	if(pos >= seq->real_length){
 		return seq->default_char;
 	}
+	if(seq->packed != NULL){
+		return zGetPackedChar(seq,pos);
+	}
 	
 	block = zGetSeqBlock(seq,pos);
 	block_pos = pos - block->pos;
@@ -507,6 +561,9 @@ void zLoadSeqVariants(zSequence *seq,char *filename){
 	char c;
 	int good;
 	int* var_map;
+	if(seq->packed != NULL){
+		zDie("zLoadSeqVariants: %s is a genome index, variants need the fasta file\n",seq->filename);
+	}
     /* open file */
 	if((fp = fopen(filename,"r")) == 0){
 		zDie("zLoadSeqVariants: Couldn't open sequence variant file, %s\n",filename);
@@ -720,6 +777,9 @@ bool zSeqCheckChar(zSequence* seq,coor_t pos,char check){
 	if(pos >= seq->real_length){
 		return (check == seq->default_char);
 	}
+	if(seq->packed != NULL){
+		return (check == zGetPackedChar(seq,pos));
+	}
 	
 	block = zGetSeqBlock(seq,pos);
 	block_pos = pos - block->pos;
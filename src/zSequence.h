@@ -91,6 +91,11 @@ struct zSequence {
 	zSequenceInitFunc    init_func;
 	zSequenceReadFunc    read_func;
 	zListInitFunc        init_block_func;
+
+	const unsigned char *packed;   /* 4 bit codes, two per byte, low nibble
+									  first; NULL unless the sequence is mapped
+									  from a genome index (no blocks or fp) */
+	const char          *alphabet; /* letter of each packed code */
 };
 
 struct zSequenceIterator {
@@ -112,6 +117,8 @@ long  zInitSequenceSpecialized (char*, void*, zSequenceInitFunc,
 							   zSequenceReadFunc, zListInitFunc, coor_t, coor_t, long, long);
 int zInitMultiSequenceSpecialized (char*, zVec*, zGenericInitFunc ,
 			size_t, zSequenceInitFunc, zSequenceReadFunc, zListInitFunc, coor_t, coor_t);
+void zInitPackedSequence (zSequence*, const char*, void*, const unsigned char*,
+						  const char*, coor_t, coor_t);
 void zFreeSequence (zSequence*);
 void zCopySequence (zSequence*, zSequence*);
 char zGetSequencePos(zSequence*,coor_t);
@@ -11,63 +11,46 @@
 #include "zTBTree.h"
 
 coor_t any_new_cpoint = 0;
-static int nodeid = 0;
-zTBTreeNode* watchme; 
-zTBTreeNode* watchme2;
 
-static void* zCreateTBTreeNode(){
-	zTBTreeNode* t = zMalloc(sizeof(zTBTreeNode),"zCreateTBTreeNode t");
-	t->pos = 0;
-	t->state = -1;
-	t->score = MIN_SCORE;
-	t->frame_data = UNDEFINED_FRAME;
-	t->phase = Phase0;
-	t->strand = UNDEFINED_STRAND;
-	t->parent = NULL;
-	t->child = NULL;
-	t->lsib = NULL;
-	t->rsib = NULL;
-	t->children = 0;
-	t->id = nodeid++;
-	t->lock = 0;
-	return (void*)t;
-}
-
-static void zFreeTBTreeNode(void* v){
-	zTBTreeNode* n = (zTBTreeNode*)v;
-	zFree(n);
-}
-
-static void zResetTBTreeNode(void* v){
-	zTBTreeNode* n = (zTBTreeNode*)v;
+static void zResetTBTreeNode(zTBTreeNode* n){
 	n->pos = 0;
+	n->cdna_pos = 0;
 	n->state = -1;
 	n->score = MIN_SCORE;
 	n->frame_data = UNDEFINED_FRAME;
 	n->phase = Phase0;
-	n->strand = UNDEFINED_STRAND;
 	n->parent = NULL;
 	n->child = NULL;
-	n->lsib = NULL;
 	n->rsib = NULL;
 	n->children = 0;
 	n->lock = 0;
+	n->pruned = 0;
 }
 
 zTBTreeNode* zGetTBTreeNode(zTBTree *t){
 	zTBTreeNode* n;
-	t->size++;
-	if(t->dead_nodes == NULL){
-		/* if there are no dead node allocate a new node */
-		n = zCreateTBTreeNode();
-	}
-	else{
-		/* otherwise return the dead node at the start of the list */
+	zTBTreeSlab* slab;
+	if(t->dead_nodes != NULL){
+		/* return the dead node at the start of the list */
 		n = t->dead_nodes;
 		t->dead_nodes = t->dead_nodes->child;
-		zResetTBTreeNode(n);
 	}
-	n->tree = t;
+	else{
+		/* otherwise take the next node of the newest slab */
+		if(t->slabs == NULL || t->slab_used == TBTREE_SLAB_NODES){
+			slab = zMalloc(sizeof(zTBTreeSlab),"zGetTBTreeNode slab");
+			slab->next = t->slabs;
+			t->slabs = slab;
+			t->slab_used = 0;
+			t->slab_count++;
+		}
+		n = &t->slabs->node[t->slab_used++];
+	}
+	zResetTBTreeNode(n);
+	t->size++;
+	if(t->size > t->peak){
+		t->peak = t->size;
+	}
 	return n;
 }
 
@@ -75,7 +58,11 @@ static int TBTREE_ID = 0;
 
 void zInitTBTree(zTBTree *t){
 	t->dead_nodes = NULL;
+	t->slabs = NULL;
+	t->slab_used = 0;
+	t->slab_count = 0;
 	t->size = 0;
+	t->peak = 0;
 	t->root = zGetTBTreeNode(t);
 	t->cpoint = t->root;
 	t->new_cpoint = 0;
@@ -83,25 +70,34 @@ void zInitTBTree(zTBTree *t){
 	t->check_count = 1;
 }
 
-static void zFreeTBTreeHelp(zTBTreeNode* n){
-	zTBTreeNode* c = n->child;
-	zTBTreeNode* c2;
-	while(c != NULL){
-		c2 = c;
-		c = c->rsib;
-		zFreeTBTreeHelp(c2);
-	}
-	zFreeTBTreeNode(n);
+void zFreeTBTree(zTBTree *t){
+	zTBTreeSlab* slab;
+	while(t->slabs != NULL){
+		slab = t->slabs;
+		t->slabs = slab->next;
+		zFree(slab);
+	}
+	t->root = NULL;
+	t->cpoint = NULL;
+	t->dead_nodes = NULL;
+	t->slab_count = 0;
+	t->size = 0;
 }
 
-void zFreeTBTree(zTBTree *t){
-	zTBTreeNode* n;
-	zFreeTBTreeHelp(t->root);
-	while(t->dead_nodes != NULL){
-		n = t->dead_nodes;
-		t->dead_nodes = t->dead_nodes->child;
-		zFreeTBTreeNode(n);
+size_t zGetTBTreeBytes(zTBTree* t){
+	return t->slab_count*sizeof(zTBTreeSlab);
+}
+
+/* the link that points at n, p->child or the rsib of its left sibling */
+static zTBTreeNode** zTBTreeSiblingLink(zTBTreeNode* p, zTBTreeNode* n){
+	zTBTreeNode** link = &p->child;
+	while(*link != n){
+		if(*link == NULL){
+			zDie("zTBTreeNode is not a child of its parent\n");
+		}
+		link = &(*link)->rsib;
 	}
+	return link;
 }
 
 void zReleaseTBTreeNode(zTBTree *t,zTBTreeNode* n){
@@ -160,9 +156,6 @@ bool zTBTreeClearNewCpoint(zTBTree* tree){
 static void zTBTreeVerifyStructureHelp(zTBTree* t, zTBTreeNode* n){
 	zTBTreeNode* c = n->child;
 	int count = 0;
-	if(n->tree != t){
-		zDie("");
-	}
 	if(n->alive == 0){
 		zDie("");
 	}
@@ -178,19 +171,11 @@ static void zTBTreeVerifyStructureHelp(zTBTree* t, zTBTreeNode* n){
 		if(c == NULL){
 			zDie("");
 		}
-		if(c->lsib != NULL){
-			zDie("");
-		}
 		while(c != NULL){
 			count++;
 			if(c->parent != n){
 				zDie("");
 			}
-			if(c->rsib != NULL){
-				if(c->rsib->lsib != c){
-					zDie("");
-				}
-			}
 			zTBTreeVerifyStructureHelp(t,c);
 			c = c->rsib;
 		}
@@ -204,9 +189,6 @@ static void zTBTreeVerifyStructure(zTBTree* t){
 	zTBTreeNode* n = t->dead_nodes;
 	t->check_count++;
 	while(n != NULL){
-		if(n->tree != t){
-			zDie("");
-		}
 		if(n->alive != 0){
 			zDie("");
 		}
@@ -258,17 +240,8 @@ void zReleaseRedundantTBTreeNode(zTBTree* t,zTBTreeNode* n){
 	zTBTreeNode* c = n->child;
 	if(n->lock == 0){
 		c->parent = p;
-		if(p->child == n){
-			p->child = c;
-		}
-		c->lsib = n->lsib;
 		c->rsib = n->rsib;
-		if(c->rsib != NULL){
-			c->rsib->lsib = c;
-		}
-		if(c->lsib != NULL){
-			c->lsib->rsib = c;
-		}
+		*zTBTreeSiblingLink(p,n) = c;
 	}
 	if(n == t->cpoint){
 		t->cpoint = n->child;
@@ -306,17 +279,7 @@ void zReleaseDeadTBTreeNode(zTBTree* t, zTBTreeNode* n){
  	else if(n->children <= 1){
  		zDie("This should never happen\n");
 	}
-	if(n->child == dead){
-		/*this means this is the stored child and we know more exists since children > 1 */ 
-		n->child = dead->rsib;
-		dead->rsib->lsib = NULL;
-	}
-	else{
-		dead->lsib->rsib = dead->rsib;
-		if(dead->rsib != NULL){
-			dead->rsib->lsib = dead->lsib;
-		}
-	}
+	*zTBTreeSiblingLink(n,dead) = dead->rsib;
 	n->children--;
 	zReleaseTBTreeNode(t,dead);	
 	/* see if n is now redundant */
@@ -364,30 +327,14 @@ void zTBTreeClearSubTree(zTBTree* t, zTBTreeNode* n){
 void zTBTreeSetChild(zTBTreeNode* p,zTBTreeNode* c){
 	/*remove from the old parent children */
 	if(c->parent != NULL){
-		if(c->parent->child == c){
-			c->parent->child = c->rsib;
-			/*if c is the stored child then it is the left most child (no lsib) */
-		}
-		else{
-			/* otherwise it must have an lsib */
-			c->lsib->rsib = c->rsib;
-		}
-		/* if right sibling exists, clear it */
-		if(c->rsib != NULL){
-			c->rsib->lsib = c->lsib;
-		}
+		*zTBTreeSiblingLink(c->parent,c) = c->rsib;
 		c->parent->children--;
 		if(c->parent->children < 0){
 			zDie("zTBTreeLiveNode children count is off\n");
 		}
 	}
-	c->lsib = NULL;
-	c->rsib = NULL;
 	/* make c p's leftmost child */
-	if(p->child != NULL){
-		c->rsib = p->child;
-		p->child->lsib = c; 
-	}
+	c->rsib = p->child;
 	p->child = c;
 	c->parent = p;
 	p->children++;
@@ -402,7 +349,7 @@ void zCopyTBTreeNode(zTBTree* t1, zTBTreeNode* n1, zTBTree* t2, zTBTreeNode* n2,
 	n2->pos = n1->pos;
 	n2->state = n1->state;
 	n2->score = n1->score;
-	n2->strand = n1->strand;
+	n2->cdna_pos = n1->cdna_pos;
 	n2->frame_data = n1->frame_data;
 	n2->phase = n1->phase;
 	n2->children = n1->children;
@@ -414,12 +361,8 @@ void zCopyTBTreeNode(zTBTree* t1, zTBTreeNode* n1, zTBTree* t2, zTBTreeNode* n2,
 		c2->parent = n2;
 		if(c3 == NULL){
 			n2->child = c2;
-			c2->lsib = NULL;
-			c2->rsib = NULL;
 		}
 		else{
-			c2->rsib = NULL;
-			c2->lsib = c3;
 			c3->rsib = c2;
 		}
 		c3 = c2;
@@ -4,6 +4,10 @@
 
   This is a tree structure which can store all live traceback paths 
   from a trellis more efficiently than retaining the full trellis.
+
+  Nodes come out of slabs of TBTREE_SLAB_NODES, released ones are reused
+  and the slabs only go back in zFreeTBTree. zGetTBTreeBytes is what the
+  slabs take, the most the tree ever needed.
   
   Copyright (C) 2006 Evan Keibler and Manimozhiyan Arumugam
 \******************************************************************************/
@@ -13,39 +17,49 @@
 
 #include "zTools.h"
 
+#define TBTREE_SLAB_NODES 1024 /* nodes zGetTBTreeNode carves out of one zMalloc */
+
+/* Field order keeps the node at 56 bytes on LP64. frame_data and phase
+   are only used by the GHMM zViterbi, the pair HMM leaves them alone */
+
+typedef struct zTBTreeNode {
+	struct zTBTreeNode*     parent;
+	struct zTBTreeNode*     child;
+	struct zTBTreeNode*     rsib;
+	score_t          score;
+	coor_t           pos;
+	coor_t           cdna_pos;
+	int              children;
+	short            state;
+	frame_t          frame_data;
+	char             phase;      /* a zPhase_t */
+	char             lock;
+	char             pruned;     /* dropped by the beam of zRunSNPPairViterbiOnBlock */
+} zTBTreeNode;
+
+typedef struct zTBTreeSlab {
+	struct zTBTreeSlab*  next;
+	zTBTreeNode          node[TBTREE_SLAB_NODES];
+} zTBTreeSlab;
+
 typedef struct zTBTree {
 	struct zTBTreeNode*  root;   /* this is the tree root */
 	struct zTBTreeNode*  cpoint; /* the cpoint of this tree */
 	struct zTBTreeNode*  dead_nodes;  /* this faux tree holds the dead nodes stored for reuse
 								  the nodes are stored in a single linked list using the 
 								  child pointer */
+	zTBTreeSlab*  slabs;  /* every node of the tree, newest slab first */
+	int           slab_used; /* nodes handed out of the newest slab */
+	int           slab_count;
 	int           size;   /* total number of nodes in tree */
+	int           peak;   /* most nodes in the tree at once */
 	short         new_cpoint; /*flag set to 1 when cpoint changes */
 	short         id;
 	short         check_count;
 } zTBTree;
 
-typedef struct zTBTreeNode {
-	coor_t           pos;
-	coor_t           cdna_pos;
-	int              state;
-	score_t          score;
-	strand_t         strand;
-	frame_t          frame_data;
-	zPhase_t         phase;
-	struct zTBTreeNode*     parent;
-	struct zTBTreeNode*     child;
-	struct zTBTreeNode*     lsib;
-	struct zTBTreeNode*     rsib;
-	int              children;
-	int              id;
-	int              lock;
-	struct zTBTree*         tree;
-	
-} zTBTreeNode;
-
-/* each node sees its leftmost child only.  other accessed through the sibling
-   pointers.  each child knows its parent. */
+/* each node sees its leftmost child only.  other accessed through the right
+   sibling pointers.  each child knows its parent. */
 
 void zInitTBTree(zTBTree *t);
 void zFreeTBTree(zTBTree *t);
@@ -63,5 +77,6 @@ void zTBTreeSetChild(zTBTreeNode* p,zTBTreeNode* c);
 void zClearTBTreeNodeChildren(zTBTree* t, zTBTreeNode* n);
 void zReleaseRedundantTBTreeNode(zTBTree* t,zTBTreeNode* n);
 void zReleaseTBTreeNode(zTBTree* t,zTBTreeNode* n);
+size_t zGetTBTreeBytes(zTBTree* t);
 
 #endif
@@ -11,6 +11,7 @@
 
 #include "zTools.h"
 #include <libgen.h>
+#include <pthread.h>
 
 const coor_t   UNDEFINED_COOR   = UINT_MAX;
 const frame_t  UNDEFINED_FRAME  = -1;
@@ -407,10 +408,32 @@ void zTrace3 (const char *fmt, ...) { const char*a=fmt;a=0;/*compiler hush*/}
  Memory Tools
 \******************************************************************************/
 
+static zMemoryCounts   MEMORY_COUNTS  = {0, 0, 0, 0, 0, 0};
+static pthread_mutex_t MEMORY_LOCK    = PTHREAD_MUTEX_INITIALIZER;
+static bool            MEMORY_THREADS = false;
+
+void zGetMemoryCounts (zMemoryCounts *counts) {
+	*counts = MEMORY_COUNTS;
+}
+
+/* Set by the one thread there is, before it starts others and after they are done */
+
+void zShareMemoryCounts (bool threads) {
+	MEMORY_THREADS = threads;
+}
+
+static void zCountMemory (unsigned long *count, size_t size) {
+	if (MEMORY_THREADS) pthread_mutex_lock(&MEMORY_LOCK);
+	(*count)++;
+	MEMORY_COUNTS.bytes += size;
+	if (MEMORY_THREADS) pthread_mutex_unlock(&MEMORY_LOCK);
+}
+
 void* zMalloc (size_t size, const char *str) {
 	void *buffer;
 	
 	zTrace3("zMalloc (%d) from %s", size, str);
+	zCountMemory(&MEMORY_COUNTS.mallocs, size);
 	if ((buffer = malloc(size)) == NULL) zDie("malloc(%d) %s", size, str);
 	return buffer;
 }
@@ -419,6 +442,7 @@ void* zCalloc (size_t nobj, size_t size, const char *str) {
 	void *buffer;
 
 	zTrace3("zCalloc (%d, %d) from %s", nobj, size, str);
+	zCountMemory(&MEMORY_COUNTS.callocs, nobj*size);
 	if ((buffer = calloc(nobj, size)) == NULL) zDie("calloc %s", str);
 	return buffer;  
 }
@@ -430,6 +454,7 @@ void* zRealloc (void *p, size_t size, const char *str) {
 	if (p == NULL) {
 		buffer = zMalloc(size, "zRealloc redirection to zMalloc");
 	} else {
+		zCountMemory(&MEMORY_COUNTS.reallocs, size);
 		buffer = realloc(p, size);
 		if (buffer == NULL) zDie("realloc %s", str);
 	}
@@ -438,6 +463,7 @@ void* zRealloc (void *p, size_t size, const char *str) {
 
 void zFree (void *p) {
 	if (p != NULL) {
+		zCountMemory(&MEMORY_COUNTS.frees, 0);
 		free(p);
 		p = NULL;
 	}
@@ -450,12 +476,14 @@ gpointer zSliceAlloc (gsize size, const char *str) {
 	gpointer buffer;
 
 	zTrace3("zSliceAlloc (%d) from %s", size, str);
+	zCountMemory(&MEMORY_COUNTS.slices, size);
 	if ((buffer = g_slice_alloc(size)) == NULL) zDie("g_slice_alloc(%d) %s", size, str);
 	return buffer;
 }
 
 void zSliceFree (gsize size, gpointer p) {
 	if (p != NULL) {
+		zCountMemory(&MEMORY_COUNTS.frees, 0);
 		g_slice_free1(size, p);
 		p = NULL;
 	}
@@ -467,12 +495,14 @@ void* zSliceAlloc (size_t size, const char *str) {
 	void *buffer;
 	
 	zTrace3("zSliceAlloc (%d) from %s", size, str);
+	zCountMemory(&MEMORY_COUNTS.slices, size);
 	if ((buffer = malloc(size)) == NULL) zDie("malloc(%d) %s", size, str);
 	return buffer;
 }
 
 void zSliceFree (size_t size, void* p) {
 	if (p != NULL) {
+		zCountMemory(&MEMORY_COUNTS.frees, 0);
 		if (size > 0) free(p);
 		p = NULL;
 	}
@@ -157,7 +157,23 @@ bit more information. If malloc, for example fails, it uses the string as an
 error message and then terminates the program. This is one of the few places
 where there are fatal error messages.
 
+Every call through the wrappers is counted, and zGetMemoryCounts reads the
+counts (bench/pairagon_bench reports them per decoder). The counters are plain
+process globals: worker processes count for themselves.
+
 \******************************************************************************/
+struct zMemoryCounts {
+	unsigned long mallocs;  /* zMalloc, and zRealloc of NULL */
+	unsigned long callocs;
+	unsigned long reallocs;
+	unsigned long frees;    /* of non-NULL pointers */
+	unsigned long slices;   /* zSliceAlloc */
+	unsigned long bytes;    /* requested by all of the above */
+};
+typedef struct zMemoryCounts zMemoryCounts;
+
+void  zGetMemoryCounts (zMemoryCounts*);
+void  zShareMemoryCounts (bool);
 void* zMalloc (size_t, const char*);
 void* zCalloc (size_t, size_t, const char*);
 void* zRealloc (void*, size_t, const char*);
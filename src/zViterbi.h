@@ -104,6 +104,11 @@ struct zViterbi{
  	coor_t heuristic_spacing;
  	int trimmed_now;
  	int trimmed_later;
+
+	/* For the beam of zRunSNPPairViterbiOnBlock */
+
+	long           beam_hits; /* cells dropped */
+	score_t*       beam_best; /* by genomic position, the best cell, MIN_SCORE if none */
 };
 typedef struct zViterbi zViterbi;
 